@@ -6,6 +6,12 @@
 #ifndef WF_MOUNTPOINT_H
 #define WF_MOUNTPOINT_H
 
+#ifndef __cplusplus
+#include <stddef.h>
+#else
+#include <cstddef>
+#endif
+
 #include <webfuse/api.h>
 
 #ifdef __cplusplus
@@ -76,6 +82,115 @@ wf_mountpoint_set_userdata(
     void * user_data,
     wf_mountpoint_userdata_dispose_fn * dispose);
 
+//------------------------------------------------------------------------------
+/// \brief Sets the read-ahead window of the mountpoint.
+///
+/// When a file is read sequentially, webfuse requests the following
+/// chunks of the file from the provider before they are read, so that
+/// the kernel's reads are served without waiting a full round trip.
+/// The read-ahead window limits the number of bytes requested ahead.
+///
+/// \note By default, read-ahead is disabled.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param size size of the read-ahead window in bytes; 0 disables read-ahead
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_readahead(
+    struct wf_mountpoint * mountpoint,
+    size_t size);
+
+//------------------------------------------------------------------------------
+/// \brief Sets the size of the block cache of the mountpoint.
+///
+/// File contents read from the provider are kept in a block cache, so
+/// that repeated reads of the same ranges are answered locally. Cached
+/// blocks of a file are dropped, when the provider reports a changed
+/// size or modification time of the file. The cache never exceeds the
+/// specified size, which includes the bookkeeping of cached files;
+/// least recently used blocks are evicted first.
+///
+/// \note By default, the block cache is disabled. Mountpoints created by
+///       a server use the cache size of the server's configuration,
+///       unless a cache size is set explicitly.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param size size of the block cache in bytes; 0 disables the cache
+///
+/// \see wf_server_config_set_cache_size
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_cache_size(
+    struct wf_mountpoint * mountpoint,
+    size_t size);
+
+//------------------------------------------------------------------------------
+/// \brief Sets the file size, from which files are opened in direct I/O mode.
+///
+/// Files opened in direct I/O mode bypass the kernel's page cache, so that
+/// streaming large files does not evict other cached data. This is useful
+/// on devices with few memory, e.g. when reading update images.
+/// Providers may also request direct I/O for a file when it is opened.
+///
+/// \note By default, direct I/O is only used when requested by the provider.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param size minimum file size in bytes; 0 disables the threshold
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_direct_io_threshold(
+    struct wf_mountpoint * mountpoint,
+    size_t size);
+
+//------------------------------------------------------------------------------
+/// \brief Sets the time, the kernel caches attributes of files and directories.
+///
+/// Providers may override the timeout per entry by specifying
+/// `attr_ttl` in results of lookup and getattr.
+///
+/// \note The default timeout is 1 second.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param timeout timeout in seconds
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_attr_timeout(
+    struct wf_mountpoint * mountpoint,
+    double timeout);
+
+//------------------------------------------------------------------------------
+/// \brief Sets the time, the kernel caches name lookups.
+///
+/// Providers may override the timeout per entry by specifying
+/// `entry_ttl` in results of lookup.
+///
+/// \note The default timeout is 1 second.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param timeout timeout in seconds
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_entry_timeout(
+    struct wf_mountpoint * mountpoint,
+    double timeout);
+
+//------------------------------------------------------------------------------
+/// \brief Sets the time, missing entries are cached.
+///
+/// When the provider reports that an entry does not exist, the kernel
+/// and webfuse remember this for the specified time, so that repeated
+/// lookups of missing files are answered without contacting the provider.
+///
+/// \note By default, missing entries are not cached.
+///
+/// \param mountpoint pointer to the mountpoint
+/// \param timeout timeout in seconds; 0 disables caching of missing entries
+//------------------------------------------------------------------------------
+extern WF_API void
+wf_mountpoint_set_negative_timeout(
+    struct wf_mountpoint * mountpoint,
+    double timeout);
+
 #ifdef __cplusplus
 }
 #endif
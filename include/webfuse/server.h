@@ -8,6 +8,13 @@
 
 #include "webfuse/api.h"
 
+#ifndef __cplusplus
+#include <stddef.h>
+#else
+#include <cstddef>
+using std::size_t;
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -79,6 +86,20 @@ extern WF_API void wf_server_interrupt(
 extern WF_API int wf_server_get_port(
     struct wf_server const * server);
 
+//------------------------------------------------------------------------------
+/// \brief Returns the number of requests awaiting a provider response
+///
+/// The value is summed over all connected providers and can be used
+/// to monitor the queue depth of the server.
+///
+/// \param server pointer to server
+/// \return Number of pending requests.
+///
+/// \see wf_server_config_set_request_window
+//------------------------------------------------------------------------------
+extern WF_API size_t wf_server_get_pending_requests(
+    struct wf_server * server);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,6 +6,12 @@
 #ifndef WF_SERVER_CONFIG_H
 #define WF_SERVER_CONFIG_H
 
+#ifndef __cplusplus
+#include <stddef.h>
+#else
+#include <cstddef>
+#endif
+
 #include "webfuse/api.h"
 #include "webfuse/authenticate.h"
 #include "webfuse/mountpoint_factory.h"
@@ -125,6 +131,61 @@ extern WF_API void wf_server_config_set_port(
     struct wf_server_config * config,
 	int port);
 
+//------------------------------------------------------------------------------
+/// \brief Sets the default size of the block cache of each filesystem.
+///
+/// File contents read from providers are kept in a block cache, so that
+/// repeated reads of the same ranges are answered without contacting the
+/// provider. The size applies to each mountpoint, which does not specify
+/// its own cache size.
+///
+/// \note By default, the block cache is disabled.
+///
+/// \param config pointer to configuration object
+/// \param size size of the block cache in bytes; 0 disables the cache
+///
+/// \see wf_mountpoint_set_cache_size
+//------------------------------------------------------------------------------
+extern WF_API void wf_server_config_set_cache_size(
+    struct wf_server_config * config,
+    size_t size);
+
+//------------------------------------------------------------------------------
+/// \brief Sets the number of bytes written to a provider at once.
+///
+/// When a connection becomes writable, queued messages are written until
+/// the budget is exhausted or the connection cannot take more data.
+/// Smaller budgets improve fairness between connections, larger budgets
+/// reduce the number of event loop iterations.
+///
+/// \note By default, 64 KByte are written at once.
+///
+/// \param config pointer to configuration object
+/// \param budget number of bytes; 0 selects the default
+//------------------------------------------------------------------------------
+extern WF_API void wf_server_config_set_write_budget(
+    struct wf_server_config * config,
+    size_t budget);
+
+//------------------------------------------------------------------------------
+/// \brief Sets the maximum number of pending requests per provider.
+///
+/// When the number of requests awaiting a response from a provider
+/// reaches the window, no further requests are read from the kernel
+/// until responses arrive. This keeps memory usage predictable when
+/// a provider is slow.
+///
+/// \note By default, the window is 256 requests.
+///
+/// \param config pointer to configuration object
+/// \param window number of requests; 0 selects the default
+///
+/// \see wf_server_get_pending_requests
+//------------------------------------------------------------------------------
+extern WF_API void wf_server_config_set_request_window(
+    struct wf_server_config * config,
+    size_t window);
+
 //------------------------------------------------------------------------------
 /// \brief Adds an authenticator.
 ///
@@ -43,6 +43,12 @@ int wf_server_get_port(
     return wf_impl_server_get_port(server);
 }
 
+size_t wf_server_get_pending_requests(
+    struct wf_server * server)
+{
+    return wf_impl_server_get_pending_requests(server);
+}
+
 // server protocol
 
 struct wf_server_protocol * wf_server_protocol_create(
@@ -131,6 +137,27 @@ void wf_server_config_set_port(
     wf_impl_server_config_set_port(config, port);
 }
 
+void wf_server_config_set_cache_size(
+    struct wf_server_config * config,
+    size_t size)
+{
+    wf_impl_server_config_set_cache_size(config, size);
+}
+
+void wf_server_config_set_write_budget(
+    struct wf_server_config * config,
+    size_t budget)
+{
+    wf_impl_server_config_set_write_budget(config, budget);
+}
+
+void wf_server_config_set_request_window(
+    struct wf_server_config * config,
+    size_t window)
+{
+    wf_impl_server_config_set_request_window(config, window);
+}
+
 void wf_server_config_add_authenticator(
     struct wf_server_config * config,
     char const * type,
@@ -202,6 +229,54 @@ wf_mountpoint_set_userdata(
     wf_impl_mountpoint_set_userdata(mountpoint, user_data, dispose);
 }
 
+void
+wf_mountpoint_set_readahead(
+    struct wf_mountpoint * mountpoint,
+    size_t size)
+{
+    wf_impl_mountpoint_set_readahead(mountpoint, size);
+}
+
+void
+wf_mountpoint_set_cache_size(
+    struct wf_mountpoint * mountpoint,
+    size_t size)
+{
+    wf_impl_mountpoint_set_cache_size(mountpoint, size);
+}
+
+void
+wf_mountpoint_set_direct_io_threshold(
+    struct wf_mountpoint * mountpoint,
+    size_t size)
+{
+    wf_impl_mountpoint_set_direct_io_threshold(mountpoint, size);
+}
+
+void
+wf_mountpoint_set_attr_timeout(
+    struct wf_mountpoint * mountpoint,
+    double timeout)
+{
+    wf_impl_mountpoint_set_attr_timeout(mountpoint, timeout);
+}
+
+void
+wf_mountpoint_set_entry_timeout(
+    struct wf_mountpoint * mountpoint,
+    double timeout)
+{
+    wf_impl_mountpoint_set_entry_timeout(mountpoint, timeout);
+}
+
+void
+wf_mountpoint_set_negative_timeout(
+    struct wf_mountpoint * mountpoint,
+    double timeout)
+{
+    wf_impl_mountpoint_set_negative_timeout(mountpoint, timeout);
+}
+
 // client
 
 struct wf_client *
@@ -0,0 +1,438 @@
+#include "webfuse/impl/cache/block_cache.h"
+#include "webfuse/impl/util/hashmap.h"
+#include "webfuse/impl/util/container_of.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// attributes are only tracked for a limited number of files;
+// least recently used files are dropped including their blocks
+#define WF_BLOCK_CACHE_MAX_FILES 4096
+
+struct wf_impl_block_cache_link
+{
+    struct wf_impl_block_cache_link * prev;
+    struct wf_impl_block_cache_link * next;
+};
+
+struct wf_impl_block_cache_file
+{
+    struct wf_hashmap_item item;
+    struct wf_impl_block_cache_link lru;
+    struct wf_impl_block_cache_link blocks;
+    struct wf_hashmap block_index;
+    uint64_t size;
+    int64_t mtime;
+};
+
+struct wf_impl_block_cache_block
+{
+    struct wf_hashmap_item item;
+    struct wf_impl_block_cache_link lru;
+    struct wf_impl_block_cache_link sibling;
+    struct wf_impl_block_cache_file * file;
+    size_t length;
+    char data[];
+};
+
+struct wf_impl_block_cache
+{
+    size_t max_size;
+    size_t size;
+    uint64_t generation;
+    struct wf_hashmap files;
+    struct wf_impl_block_cache_link file_lru;
+    struct wf_impl_block_cache_link block_lru;
+};
+
+static void
+wf_impl_block_cache_link_init(
+    struct wf_impl_block_cache_link * head)
+{
+    head->prev = head;
+    head->next = head;
+}
+
+static bool
+wf_impl_block_cache_link_empty(
+    struct wf_impl_block_cache_link * head)
+{
+    return (head->next == head);
+}
+
+static void
+wf_impl_block_cache_link_remove(
+    struct wf_impl_block_cache_link * link)
+{
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+}
+
+static void
+wf_impl_block_cache_link_push_front(
+    struct wf_impl_block_cache_link * head,
+    struct wf_impl_block_cache_link * link)
+{
+    link->prev = head;
+    link->next = head->next;
+    head->next->prev = link;
+    head->next = link;
+}
+
+static void
+wf_impl_block_cache_link_move_to_front(
+    struct wf_impl_block_cache_link * head,
+    struct wf_impl_block_cache_link * link)
+{
+    wf_impl_block_cache_link_remove(link);
+    wf_impl_block_cache_link_push_front(head, link);
+}
+
+// the budget covers all memory held by the cache: block payloads as well as
+// per-file bookkeeping including the buckets of each file's block index
+static size_t
+wf_impl_block_cache_block_cost(
+    size_t length)
+{
+    return sizeof(struct wf_impl_block_cache_block) + length;
+}
+
+static size_t
+wf_impl_block_cache_index_cost(
+    struct wf_impl_block_cache_file * file)
+{
+    return file->block_index.capacity * sizeof(struct wf_hashmap_item *);
+}
+
+static size_t
+wf_impl_block_cache_file_cost(
+    struct wf_impl_block_cache_file * file)
+{
+    return sizeof(struct wf_impl_block_cache_file) + wf_impl_block_cache_index_cost(file);
+}
+
+static struct wf_impl_block_cache_file *
+wf_impl_block_cache_get_file(
+    struct wf_impl_block_cache * cache,
+    fuse_ino_t inode)
+{
+    struct wf_hashmap_item * item = wf_impl_hashmap_get(&cache->files, (uint64_t) inode);
+    return (NULL != item) ? wf_container_of(item, struct wf_impl_block_cache_file, item) : NULL;
+}
+
+static void
+wf_impl_block_cache_remove_block(
+    struct wf_impl_block_cache * cache,
+    struct wf_impl_block_cache_block * block)
+{
+    wf_impl_hashmap_remove(&block->file->block_index, block->item.key);
+    wf_impl_block_cache_link_remove(&block->lru);
+    wf_impl_block_cache_link_remove(&block->sibling);
+    cache->size -= wf_impl_block_cache_block_cost(block->length);
+    free(block);
+}
+
+static void
+wf_impl_block_cache_drop_blocks(
+    struct wf_impl_block_cache * cache,
+    struct wf_impl_block_cache_file * file)
+{
+    while (!wf_impl_block_cache_link_empty(&file->blocks))
+    {
+        struct wf_impl_block_cache_block * block = wf_container_of(file->blocks.next, struct wf_impl_block_cache_block, sibling);
+        wf_impl_block_cache_remove_block(cache, block);
+    }
+
+    // release the index buckets as well; they are allocated again on demand
+    cache->size -= wf_impl_block_cache_index_cost(file);
+    wf_impl_hashmap_cleanup(&file->block_index);
+}
+
+static void
+wf_impl_block_cache_remove_file(
+    struct wf_impl_block_cache * cache,
+    struct wf_impl_block_cache_file * file)
+{
+    wf_impl_block_cache_drop_blocks(cache, file);
+    wf_impl_hashmap_remove(&cache->files, file->item.key);
+    wf_impl_block_cache_link_remove(&file->lru);
+    cache->size -= wf_impl_block_cache_file_cost(file);
+    free(file);
+}
+
+// least recently used files without blocks only hold bookkeeping and are
+// dropped first; afterwards least recently used blocks are evicted; the
+// file currently in use is kept
+static void
+wf_impl_block_cache_evict(
+    struct wf_impl_block_cache * cache,
+    struct wf_impl_block_cache_file * keep)
+{
+    wf_impl_block_cache_link_move_to_front(&cache->file_lru, &keep->lru);
+
+    while (cache->size > cache->max_size)
+    {
+        struct wf_impl_block_cache_file * oldest_file = wf_container_of(cache->file_lru.prev, struct wf_impl_block_cache_file, lru);
+        if ((oldest_file != keep) && (wf_impl_block_cache_link_empty(&oldest_file->blocks)))
+        {
+            wf_impl_block_cache_remove_file(cache, oldest_file);
+        }
+        else if (!wf_impl_block_cache_link_empty(&cache->block_lru))
+        {
+            struct wf_impl_block_cache_block * oldest = wf_container_of(cache->block_lru.prev, struct wf_impl_block_cache_block, lru);
+            wf_impl_block_cache_remove_block(cache, oldest);
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+static void
+wf_impl_block_cache_store(
+    struct wf_impl_block_cache * cache,
+    struct wf_impl_block_cache_file * file,
+    uint64_t index,
+    char const * data,
+    size_t length)
+{
+    struct wf_hashmap_item * item = wf_impl_hashmap_get(&file->block_index, index);
+    if (NULL != item)
+    {
+        wf_impl_block_cache_remove_block(cache, wf_container_of(item, struct wf_impl_block_cache_block, item));
+    }
+
+    size_t const cost = wf_impl_block_cache_block_cost(length);
+    if (cost > cache->max_size) { return; }
+
+    while (((cache->size + cost) > cache->max_size) && (!wf_impl_block_cache_link_empty(&cache->block_lru)))
+    {
+        struct wf_impl_block_cache_block * oldest = wf_container_of(cache->block_lru.prev, struct wf_impl_block_cache_block, lru);
+        wf_impl_block_cache_remove_block(cache, oldest);
+    }
+
+    struct wf_impl_block_cache_block * block = malloc(cost);
+    block->file = file;
+    block->length = length;
+    memcpy(block->data, data, length);
+
+    // adding a block may grow the index
+    size_t const index_cost = wf_impl_block_cache_index_cost(file);
+    wf_impl_hashmap_add(&file->block_index, &block->item, index);
+    wf_impl_block_cache_link_push_front(&cache->block_lru, &block->lru);
+    wf_impl_block_cache_link_push_front(&file->blocks, &block->sibling);
+    cache->size += cost + (wf_impl_block_cache_index_cost(file) - index_cost);
+
+    wf_impl_block_cache_evict(cache, file);
+}
+
+struct wf_impl_block_cache *
+wf_impl_block_cache_create(
+    size_t max_size)
+{
+    struct wf_impl_block_cache * cache = malloc(sizeof(struct wf_impl_block_cache));
+    cache->max_size = max_size;
+    cache->size = 0;
+    cache->generation = 0;
+    wf_impl_hashmap_init(&cache->files);
+    wf_impl_block_cache_link_init(&cache->file_lru);
+    wf_impl_block_cache_link_init(&cache->block_lru);
+
+    return cache;
+}
+
+void
+wf_impl_block_cache_dispose(
+    struct wf_impl_block_cache * cache)
+{
+    while (!wf_impl_block_cache_link_empty(&cache->file_lru))
+    {
+        struct wf_impl_block_cache_file * file = wf_container_of(cache->file_lru.next, struct wf_impl_block_cache_file, lru);
+        wf_impl_block_cache_remove_file(cache, file);
+    }
+
+    wf_impl_hashmap_cleanup(&cache->files);
+    free(cache);
+}
+
+// walks the blocks covering the range; data is only copied if a buffer is
+// given, so that coverage can be checked without a buffer
+static bool
+wf_impl_block_cache_read(
+    struct wf_impl_block_cache * cache,
+    fuse_ino_t inode,
+    off_t offset,
+    size_t size,
+    char * buffer,
+    size_t * length)
+{
+    *length = 0;
+
+    struct wf_impl_block_cache_file * file = wf_impl_block_cache_get_file(cache, inode);
+    if (NULL == file) { return false; }
+
+    uint64_t index = ((uint64_t) offset) / WF_BLOCK_CACHE_BLOCK_SIZE;
+    size_t start = ((uint64_t) offset) % WF_BLOCK_CACHE_BLOCK_SIZE;
+    size_t copied = 0;
+    while (copied < size)
+    {
+        struct wf_hashmap_item * item = wf_impl_hashmap_get(&file->block_index, index);
+        if (NULL == item) { return false; }
+
+        struct wf_impl_block_cache_block * block = wf_container_of(item, struct wf_impl_block_cache_block, item);
+        size_t const available = (start < block->length) ? block->length - start : 0;
+        size_t const count = (available < (size - copied)) ? available : size - copied;
+        if (NULL != buffer)
+        {
+            wf_impl_block_cache_link_move_to_front(&cache->block_lru, &block->lru);
+            memcpy(&buffer[copied], &block->data[start], count);
+        }
+        copied += count;
+
+        // a partial block marks the end of the file
+        if (WF_BLOCK_CACHE_BLOCK_SIZE > block->length) { break; }
+
+        index++;
+        start = 0;
+    }
+
+    if (NULL != buffer)
+    {
+        wf_impl_block_cache_link_move_to_front(&cache->file_lru, &file->lru);
+    }
+    *length = copied;
+    return true;
+}
+
+bool
+wf_impl_block_cache_contains(
+    struct wf_impl_block_cache * cache,
+    fuse_ino_t inode,
+    off_t offset,
+    size_t size,
+    size_t * length)
+{
+    return wf_impl_block_cache_read(cache, inode, offset, size, NULL, length);
+}
+
+bool
+wf_impl_block_cache_get(
+    struct wf_impl_block_cache * cache,
+    fuse_ino_t inode,
+    off_t offset,
+    size_t size,
+    char * buffer,
+    size_t * length)
+{
+    return wf_impl_block_cache_read(cache, inode, offset, size, buffer, length);
+}
+
+uint64_t
+wf_impl_block_cache_get_generation(
+    struct wf_impl_block_cache * cache)
+{
+    return cache->generation;
+}
+
+void
+wf_impl_block_cache_put(
+    struct wf_impl_block_cache * cache,
+    uint64_t generation,
+    fuse_ino_t inode,
+    off_t offset,
+    size_t size,
+    char const * data,
+    size_t length)
+{
+    // data was requested before the file changed
+    if (generation != cache->generation) { return; }
+
+    // only files with known attributes are cached, since changes
+    // are detected by comparing attributes
+    struct wf_impl_block_cache_file * file = wf_impl_block_cache_get_file(cache, inode);
+    if (NULL == file) { return; }
+
+    bool const is_eof = (length < size);
+    uint64_t const end = ((uint64_t) offset) + length;
+    uint64_t index = (((uint64_t) offset) + WF_BLOCK_CACHE_BLOCK_SIZE - 1) / WF_BLOCK_CACHE_BLOCK_SIZE;
+    for(;;)
+    {
+        uint64_t const block_start = index * WF_BLOCK_CACHE_BLOCK_SIZE;
+        char const * block_data = &data[block_start - (uint64_t) offset];
+        if ((block_start + WF_BLOCK_CACHE_BLOCK_SIZE) <= end)
+        {
+            wf_impl_block_cache_store(cache, file, index, block_data, WF_BLOCK_CACHE_BLOCK_SIZE);
+        }
+        else
+        {
+            if ((is_eof) && (block_start <= end))
+            {
+                wf_impl_block_cache_store(cache, file, index, block_data, (size_t) (end - block_start));
+            }
+            break;
+        }
+
+        index++;
+    }
+}
+
+void
+wf_impl_block_cache_update(
+    struct wf_impl_block_cache * cache,
+    fuse_ino_t inode,
+    uint64_t size,
+    int64_t mtime)
+{
+    struct wf_impl_block_cache_file * file = wf_impl_block_cache_get_file(cache, inode);
+    if (NULL != file)
+    {
+        if ((size != file->size) || (mtime != file->mtime))
+        {
+            wf_impl_block_cache_drop_blocks(cache, file);
+            cache->generation++;
+        }
+
+        wf_impl_block_cache_link_move_to_front(&cache->file_lru, &file->lru);
+    }
+    else
+    {
+        if (WF_BLOCK_CACHE_MAX_FILES <= cache->files.size)
+        {
+            struct wf_impl_block_cache_file * oldest = wf_container_of(cache->file_lru.prev, struct wf_impl_block_cache_file, lru);
+            wf_impl_block_cache_remove_file(cache, oldest);
+        }
+
+        file = malloc(sizeof(struct wf_impl_block_cache_file));
+        wf_impl_block_cache_link_init(&file->blocks);
+        wf_impl_hashmap_init(&file->block_index);
+        wf_impl_hashmap_add(&cache->files, &file->item, (uint64_t) inode);
+        wf_impl_block_cache_link_push_front(&cache->file_lru, &file->lru);
+        cache->size += wf_impl_block_cache_file_cost(file);
+
+        wf_impl_block_cache_evict(cache, file);
+    }
+
+    file->size = size;
+    file->mtime = mtime;
+}
+
+void
+wf_impl_block_cache_invalidate(
+    struct wf_impl_block_cache * cache,
+    fuse_ino_t inode)
+{
+    struct wf_impl_block_cache_file * file = wf_impl_block_cache_get_file(cache, inode);
+    if (NULL != file)
+    {
+        wf_impl_block_cache_remove_file(cache, file);
+        cache->generation++;
+    }
+}
+
+size_t
+wf_impl_block_cache_size(
+    struct wf_impl_block_cache * cache)
+{
+    return cache->size;
+}
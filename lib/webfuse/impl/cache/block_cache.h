@@ -0,0 +1,84 @@
+#ifndef WF_IMPL_CACHE_BLOCK_CACHE_H
+#define WF_IMPL_CACHE_BLOCK_CACHE_H
+
+#include "webfuse/impl/fuse_wrapper.h"
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#else
+#include <cstddef>
+#include <cstdint>
+using std::size_t;
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define WF_BLOCK_CACHE_BLOCK_SIZE (4 * 1024)
+
+struct wf_impl_block_cache;
+
+extern struct wf_impl_block_cache *
+wf_impl_block_cache_create(
+    size_t max_size);
+
+extern void
+wf_impl_block_cache_dispose(
+    struct wf_impl_block_cache * cache);
+
+extern bool
+wf_impl_block_cache_contains(
+    struct wf_impl_block_cache * cache,
+    fuse_ino_t inode,
+    off_t offset,
+    size_t size,
+    size_t * length);
+
+extern bool
+wf_impl_block_cache_get(
+    struct wf_impl_block_cache * cache,
+    fuse_ino_t inode,
+    off_t offset,
+    size_t size,
+    char * buffer,
+    size_t * length);
+
+extern uint64_t
+wf_impl_block_cache_get_generation(
+    struct wf_impl_block_cache * cache);
+
+extern void
+wf_impl_block_cache_put(
+    struct wf_impl_block_cache * cache,
+    uint64_t generation,
+    fuse_ino_t inode,
+    off_t offset,
+    size_t size,
+    char const * data,
+    size_t length);
+
+extern void
+wf_impl_block_cache_update(
+    struct wf_impl_block_cache * cache,
+    fuse_ino_t inode,
+    uint64_t size,
+    int64_t mtime);
+
+extern void
+wf_impl_block_cache_invalidate(
+    struct wf_impl_block_cache * cache,
+    fuse_ino_t inode);
+
+extern size_t
+wf_impl_block_cache_size(
+    struct wf_impl_block_cache * cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
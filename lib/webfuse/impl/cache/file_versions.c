@@ -0,0 +1,130 @@
+#include "webfuse/impl/cache/file_versions.h"
+#include "webfuse/impl/util/hashmap.h"
+#include "webfuse/impl/util/container_of.h"
+
+#include <stdlib.h>
+
+// versions are only tracked for a limited number of files;
+// when the limit is reached, all versions are dropped
+#define WF_FILE_VERSIONS_MAX_FILES 4096
+
+struct wf_impl_file_version
+{
+    struct wf_hashmap_item item;
+    uint64_t size;
+    int64_t mtime;
+    bool is_opened;
+    uint64_t opened_size;
+    int64_t opened_mtime;
+};
+
+struct wf_impl_file_versions
+{
+    struct wf_hashmap files;
+};
+
+static void
+wf_impl_file_versions_clear(
+    struct wf_impl_file_versions * versions)
+{
+    for (size_t i = 0; i < versions->files.capacity; i++)
+    {
+        struct wf_hashmap_item * item = versions->files.buckets[i];
+        while (NULL != item)
+        {
+            struct wf_hashmap_item * next = item->next;
+            free(wf_container_of(item, struct wf_impl_file_version, item));
+            item = next;
+        }
+    }
+
+    wf_impl_hashmap_cleanup(&versions->files);
+}
+
+struct wf_impl_file_versions *
+wf_impl_file_versions_create(void)
+{
+    struct wf_impl_file_versions * versions = malloc(sizeof(struct wf_impl_file_versions));
+    wf_impl_hashmap_init(&versions->files);
+
+    return versions;
+}
+
+void
+wf_impl_file_versions_dispose(
+    struct wf_impl_file_versions * versions)
+{
+    wf_impl_file_versions_clear(versions);
+    free(versions);
+}
+
+void
+wf_impl_file_versions_update(
+    struct wf_impl_file_versions * versions,
+    fuse_ino_t inode,
+    uint64_t size,
+    int64_t mtime)
+{
+    struct wf_impl_file_version * version;
+    struct wf_hashmap_item * item = wf_impl_hashmap_get(&versions->files, (uint64_t) inode);
+    if (NULL != item)
+    {
+        version = wf_container_of(item, struct wf_impl_file_version, item);
+    }
+    else
+    {
+        if (WF_FILE_VERSIONS_MAX_FILES <= versions->files.size)
+        {
+            wf_impl_file_versions_clear(versions);
+        }
+
+        version = malloc(sizeof(struct wf_impl_file_version));
+        version->is_opened = false;
+        version->opened_size = 0;
+        version->opened_mtime = 0;
+        wf_impl_hashmap_add(&versions->files, &version->item, (uint64_t) inode);
+    }
+
+    version->size = size;
+    version->mtime = mtime;
+}
+
+bool
+wf_impl_file_versions_open(
+    struct wf_impl_file_versions * versions,
+    fuse_ino_t inode)
+{
+    struct wf_hashmap_item * item = wf_impl_hashmap_get(&versions->files, (uint64_t) inode);
+    if (NULL == item) { return false; }
+
+    struct wf_impl_file_version * version = wf_container_of(item, struct wf_impl_file_version, item);
+    bool const is_unchanged = (version->is_opened) &&
+        (version->size == version->opened_size) && (version->mtime == version->opened_mtime);
+
+    version->is_opened = true;
+    version->opened_size = version->size;
+    version->opened_mtime = version->mtime;
+
+    return is_unchanged;
+}
+
+bool
+wf_impl_file_versions_get_size(
+    struct wf_impl_file_versions * versions,
+    fuse_ino_t inode,
+    uint64_t * size)
+{
+    struct wf_hashmap_item * item = wf_impl_hashmap_get(&versions->files, (uint64_t) inode);
+    if (NULL == item) { return false; }
+
+    struct wf_impl_file_version * version = wf_container_of(item, struct wf_impl_file_version, item);
+    *size = version->size;
+    return true;
+}
+
+size_t
+wf_impl_file_versions_size(
+    struct wf_impl_file_versions * versions)
+{
+    return versions->files.size;
+}
@@ -0,0 +1,63 @@
+#ifndef WF_IMPL_CACHE_FILE_VERSIONS_H
+#define WF_IMPL_CACHE_FILE_VERSIONS_H
+
+#include "webfuse/impl/fuse_wrapper.h"
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#else
+#include <cstddef>
+#include <cstdint>
+using std::size_t;
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Tracks size and modification time of files, as reported by lookup
+// and getattr, to decide whether the kernel may keep cached pages of
+// a file when it is opened again.
+
+struct wf_impl_file_versions;
+
+extern struct wf_impl_file_versions *
+wf_impl_file_versions_create(void);
+
+extern void
+wf_impl_file_versions_dispose(
+    struct wf_impl_file_versions * versions);
+
+extern void
+wf_impl_file_versions_update(
+    struct wf_impl_file_versions * versions,
+    fuse_ino_t inode,
+    uint64_t size,
+    int64_t mtime);
+
+// Marks the file as opened; returns true, if the file was opened before
+// and its size and modification time did not change since then.
+extern bool
+wf_impl_file_versions_open(
+    struct wf_impl_file_versions * versions,
+    fuse_ino_t inode);
+
+// Returns the last known size of the file.
+extern bool
+wf_impl_file_versions_get_size(
+    struct wf_impl_file_versions * versions,
+    fuse_ino_t inode,
+    uint64_t * size);
+
+extern size_t
+wf_impl_file_versions_size(
+    struct wf_impl_file_versions * versions);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,142 @@
+#include "webfuse/impl/cache/negative_cache.h"
+#include "webfuse/impl/util/hashmap.h"
+#include "webfuse/impl/util/container_of.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// entries are only tracked for a limited number of names;
+// when the limit is reached, all entries are dropped
+#define WF_NEGATIVE_CACHE_MAX_ENTRIES 4096
+
+struct wf_impl_negative_cache_entry
+{
+    struct wf_hashmap_item item;
+    fuse_ino_t parent;
+    wf_timer_timepoint expires;
+    char name[];
+};
+
+struct wf_impl_negative_cache
+{
+    struct wf_hashmap entries;
+};
+
+static uint64_t
+wf_impl_negative_cache_key(
+    fuse_ino_t parent,
+    char const * name)
+{
+    // FNV-1a over parent inode and name
+    uint64_t key = UINT64_C(0xcbf29ce484222325);
+    for (size_t i = 0; i < sizeof(uint64_t); i++)
+    {
+        key ^= (((uint64_t) parent) >> (i * 8)) & 0xff;
+        key *= UINT64_C(0x100000001b3);
+    }
+
+    for (unsigned char const * c = (unsigned char const *) name; '\0' != *c; c++)
+    {
+        key ^= *c;
+        key *= UINT64_C(0x100000001b3);
+    }
+
+    return key;
+}
+
+static void
+wf_impl_negative_cache_clear(
+    struct wf_impl_negative_cache * cache)
+{
+    for (size_t i = 0; i < cache->entries.capacity; i++)
+    {
+        struct wf_hashmap_item * item = cache->entries.buckets[i];
+        while (NULL != item)
+        {
+            struct wf_hashmap_item * next = item->next;
+            free(wf_container_of(item, struct wf_impl_negative_cache_entry, item));
+            item = next;
+        }
+    }
+
+    wf_impl_hashmap_cleanup(&cache->entries);
+}
+
+static void
+wf_impl_negative_cache_remove(
+    struct wf_impl_negative_cache * cache,
+    uint64_t key)
+{
+    struct wf_hashmap_item * item = wf_impl_hashmap_remove(&cache->entries, key);
+    if (NULL != item)
+    {
+        free(wf_container_of(item, struct wf_impl_negative_cache_entry, item));
+    }
+}
+
+struct wf_impl_negative_cache *
+wf_impl_negative_cache_create(void)
+{
+    struct wf_impl_negative_cache * cache = malloc(sizeof(struct wf_impl_negative_cache));
+    wf_impl_hashmap_init(&cache->entries);
+
+    return cache;
+}
+
+void
+wf_impl_negative_cache_dispose(
+    struct wf_impl_negative_cache * cache)
+{
+    wf_impl_negative_cache_clear(cache);
+    free(cache);
+}
+
+void
+wf_impl_negative_cache_add(
+    struct wf_impl_negative_cache * cache,
+    fuse_ino_t parent,
+    char const * name,
+    wf_timer_timepoint expires)
+{
+    uint64_t const key = wf_impl_negative_cache_key(parent, name);
+    wf_impl_negative_cache_remove(cache, key);
+
+    if (WF_NEGATIVE_CACHE_MAX_ENTRIES <= cache->entries.size)
+    {
+        wf_impl_negative_cache_clear(cache);
+    }
+
+    size_t const length = strlen(name);
+    struct wf_impl_negative_cache_entry * entry = malloc(sizeof(struct wf_impl_negative_cache_entry) + length + 1);
+    entry->parent = parent;
+    entry->expires = expires;
+    memcpy(entry->name, name, length + 1);
+    wf_impl_hashmap_add(&cache->entries, &entry->item, key);
+}
+
+bool
+wf_impl_negative_cache_contains(
+    struct wf_impl_negative_cache * cache,
+    fuse_ino_t parent,
+    char const * name)
+{
+    uint64_t const key = wf_impl_negative_cache_key(parent, name);
+    struct wf_hashmap_item * item = wf_impl_hashmap_get(&cache->entries, key);
+    if (NULL == item) { return false; }
+
+    struct wf_impl_negative_cache_entry * entry = wf_container_of(item, struct wf_impl_negative_cache_entry, item);
+    if (wf_impl_timer_timepoint_is_elapsed(entry->expires))
+    {
+        wf_impl_negative_cache_remove(cache, key);
+        return false;
+    }
+
+    return ((parent == entry->parent) && (0 == strcmp(name, entry->name)));
+}
+
+size_t
+wf_impl_negative_cache_size(
+    struct wf_impl_negative_cache * cache)
+{
+    return cache->entries.size;
+}
@@ -0,0 +1,53 @@
+#ifndef WF_IMPL_CACHE_NEGATIVE_CACHE_H
+#define WF_IMPL_CACHE_NEGATIVE_CACHE_H
+
+#include "webfuse/impl/fuse_wrapper.h"
+#include "webfuse/impl/timer/timepoint.h"
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#include <stddef.h>
+#else
+#include <cstddef>
+using std::size_t;
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Remembers names which are known not to exist, so that repeated
+// lookups of missing entries are answered without contacting the provider.
+
+struct wf_impl_negative_cache;
+
+extern struct wf_impl_negative_cache *
+wf_impl_negative_cache_create(void);
+
+extern void
+wf_impl_negative_cache_dispose(
+    struct wf_impl_negative_cache * cache);
+
+extern void
+wf_impl_negative_cache_add(
+    struct wf_impl_negative_cache * cache,
+    fuse_ino_t parent,
+    char const * name,
+    wf_timer_timepoint expires);
+
+extern bool
+wf_impl_negative_cache_contains(
+    struct wf_impl_negative_cache * cache,
+    fuse_ino_t parent,
+    char const * name);
+
+extern size_t
+wf_impl_negative_cache_size(
+    struct wf_impl_negative_cache * cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
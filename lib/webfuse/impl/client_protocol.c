@@ -3,6 +3,7 @@
 #include "webfuse/impl/credentials.h"
 #include "webfuse/impl/filesystem.h"
 #include "webfuse/impl/mountpoint.h"
+#include "webfuse/impl/operation/read.h"
 #include "webfuse/protocol_names.h"
 #include "webfuse/impl/util/url.h"
 #include "webfuse/impl/util/util.h"
@@ -22,6 +23,9 @@
 
 #define WF_DEFAULT_TIMEOUT (10 * 1000)
 #define WF_DEFAULT_MESSAGE_SIZE (10 * 1024)
+#define WF_DEFAULT_BATCH_SIZE (64 * 1024)
+#define WF_DEFAULT_REQUEST_WINDOW 256
+#define WF_DEFAULT_ARENA_SIZE (4 * 1024)
 
 struct wf_impl_client_protocol_add_filesystem_context
 {
@@ -33,19 +37,43 @@ static void
 wf_impl_client_protocol_process(
      struct wf_client_protocol * protocol, 
      char * data,
-     size_t length)
+     size_t length,
+     bool is_binary)
 {
-    struct wf_json_doc * doc = wf_impl_json_doc_loadb(data, length);
+    if (is_binary)
+    {
+        wf_impl_jsonrpc_proxy_onbinary(protocol->proxy, data, length);
+        return;
+    }
+
+    struct wf_json_doc * doc = wf_impl_json_doc_loadb_arena(data, length, &protocol->arena);
     if (NULL != doc)
     {
         struct wf_json const * message = wf_impl_json_doc_root(doc);
-        if (wf_impl_jsonrpc_is_response(message))
+        if (wf_impl_json_is_array(message))
+        {
+            // providers sending batches accept batches in return
+            protocol->use_batch = true;
+
+            size_t const count = wf_impl_json_array_size(message);
+            for(size_t i = 0; i < count; i++)
+            {
+                struct wf_json const * item = wf_impl_json_array_get(message, i);
+                if (wf_impl_jsonrpc_is_response(item))
+                {
+                    wf_impl_jsonrpc_proxy_onresult(protocol->proxy, item);
+                }
+            }
+        }
+        else if (wf_impl_jsonrpc_is_response(message))
         {
             wf_impl_jsonrpc_proxy_onresult(protocol->proxy, message);
         }
 
         wf_impl_json_doc_dispose(doc);
     }
+
+    wf_impl_arena_reset(&protocol->arena);
 }
 
 static void
@@ -53,20 +81,22 @@ wf_impl_client_protocol_receive(
      struct wf_client_protocol * protocol, 
      char * data,
      size_t length,
-     bool is_final_fragment)
+     bool is_final_fragment,
+     bool is_binary)
 {
     if (is_final_fragment)
     {
         if (wf_impl_buffer_is_empty(&protocol->recv_buffer))
         {
-            wf_impl_client_protocol_process(protocol, data, length);
+            wf_impl_client_protocol_process(protocol, data, length, is_binary);
         }
         else
         {
             wf_impl_buffer_append(&protocol->recv_buffer, data, length);
             wf_impl_client_protocol_process(protocol,
                 wf_impl_buffer_data(&protocol->recv_buffer),
-                wf_impl_buffer_size(&protocol->recv_buffer));
+                wf_impl_buffer_size(&protocol->recv_buffer),
+                is_binary);
             wf_impl_buffer_clear(&protocol->recv_buffer);
         }        
     }
@@ -112,6 +142,20 @@ wf_impl_client_protocol_on_authenticate_finished(
     protocol->callback(protocol->user_data, reason, NULL);
 }
 
+static void
+wf_impl_client_protocol_onwindow(
+    void * user_data,
+    bool is_full)
+{
+    struct wf_client_protocol * protocol = user_data;
+    protocol->is_throttled = is_full;
+
+    if (NULL != protocol->filesystem)
+    {
+        lws_rx_flow_control(protocol->filesystem->wsi, is_full ? 0 : 1);
+    }
+}
+
 static void
 wf_impl_client_protocol_on_add_filesystem_finished(
 	void * user_data,
@@ -132,6 +176,11 @@ wf_impl_client_protocol_on_add_filesystem_finished(
             protocol->filesystem = wf_impl_filesystem_create(protocol->wsi,protocol->proxy, name, mountpoint);
             if (NULL != protocol->filesystem)
             {
+                if (protocol->is_throttled)
+                {
+                    lws_rx_flow_control(protocol->filesystem->wsi, 0);
+                }
+
                 reason = WF_CLIENT_FILESYSTEM_ADDED;
             }
             else
@@ -159,12 +208,17 @@ static int wf_impl_client_protocol_lws_callback(
 
     if (NULL != protocol)
     {
-        wf_impl_timer_manager_check(protocol->timer_manager);
-
         switch (reason)
         {
+            case LWS_CALLBACK_PROTOCOL_INIT:
+                wf_impl_timer_manager_set_context(protocol->timer_manager, lws_get_context(wsi));
+                break;
+            case LWS_CALLBACK_PROTOCOL_DESTROY:
+                wf_impl_timer_manager_set_context(protocol->timer_manager, NULL);
+                break;
             case LWS_CALLBACK_CLIENT_ESTABLISHED:
                 protocol->is_connected = true;
+                protocol->use_batch = false;
                 protocol->callback(protocol->user_data, WF_CLIENT_CONNECTED, NULL);
                 break;
             case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
@@ -178,7 +232,8 @@ static int wf_impl_client_protocol_lws_callback(
                 protocol->callback(protocol->user_data, WF_CLIENT_DISCONNECTED, NULL);
                 break;
             case LWS_CALLBACK_CLIENT_RECEIVE:
-                wf_impl_client_protocol_receive(protocol, in, len, lws_is_final_fragment(wsi));
+                wf_impl_client_protocol_receive(protocol, in, len,
+                    lws_is_final_fragment(wsi), lws_frame_is_binary(wsi));
                 break;
             case LWS_CALLBACK_SERVER_WRITEABLE:
                 // fall-through
@@ -189,17 +244,11 @@ static int wf_impl_client_protocol_lws_callback(
                     {
                         result = 1;
                     }
-                    else if (!wf_impl_slist_empty(&protocol->messages))
+                    else
                     {
-                        struct wf_slist_item * item = wf_impl_slist_remove_first(&protocol->messages);
-                        struct wf_message * message = wf_container_of(item, struct wf_message, item);
-                        lws_write(wsi, (unsigned char*) message->data, message->length, LWS_WRITE_TEXT);
-                        wf_impl_message_dispose(message);
-
-                        if (!wf_impl_slist_empty(&protocol->messages))
-                        {
-                            lws_callback_on_writable(wsi);
-                        }
+                        size_t const batch_size = (protocol->use_batch) ? WF_DEFAULT_BATCH_SIZE : 0;
+                        wf_impl_message_queue_write(&protocol->messages, wsi, batch_size,
+                            WF_IMPL_MESSAGE_QUEUE_DEFAULT_WRITE_BUDGET);
                     }
                 }
                 break;
@@ -224,15 +273,21 @@ wf_impl_client_protocol_init(
 {
     protocol->is_connected = false,
     protocol->is_shutdown_requested = false;
+    protocol->use_batch = false;
+    protocol->is_throttled = false;
     protocol->wsi = NULL;
     protocol->callback = callback;
     protocol->user_data = user_data;
     protocol->filesystem = NULL;
 
     wf_impl_buffer_init(&protocol->recv_buffer, WF_DEFAULT_MESSAGE_SIZE);
+    wf_impl_arena_init(&protocol->arena, WF_DEFAULT_ARENA_SIZE);
     wf_impl_slist_init(&protocol->messages);
+    wf_impl_message_pool_init(&protocol->message_pool);
     protocol->timer_manager = wf_impl_timer_manager_create();
     protocol->proxy = wf_impl_jsonrpc_proxy_create(protocol->timer_manager, WF_DEFAULT_TIMEOUT, &wf_impl_client_protocol_send, protocol);
+    wf_impl_jsonrpc_proxy_set_window(protocol->proxy, WF_DEFAULT_REQUEST_WINDOW, &wf_impl_client_protocol_onwindow, protocol);
+    wf_impl_jsonrpc_proxy_set_message_pool(protocol->proxy, &protocol->message_pool);
 
     protocol->callback(protocol->user_data, WF_CLIENT_INIT, NULL);
 }
@@ -254,6 +309,8 @@ wf_impl_client_protocol_cleanup(
     }
 
     wf_impl_buffer_cleanup(&protocol->recv_buffer);
+    wf_impl_arena_cleanup(&protocol->arena);
+    wf_impl_message_pool_cleanup(&protocol->message_pool);
 }
 
 void
@@ -360,8 +417,9 @@ wf_impl_client_protocol_add_filesystem(
             &wf_impl_client_protocol_on_add_filesystem_finished,
             context,
             "add_filesystem",
-            "s",
-            name);
+            "sj",
+            name,
+            &wf_impl_operation_read_write_formats, NULL);
     }
     else
     {
@@ -4,6 +4,8 @@
 #include "webfuse/client_callback.h"
 #include "webfuse/impl/util/slist.h"
 #include "webfuse/impl/util/buffer.h"
+#include "webfuse/impl/util/arena.h"
+#include "webfuse/impl/message_pool.h"
 
 #ifndef __cplusplus
 #include <stdbool.h>
@@ -31,6 +33,8 @@ struct wf_client_protocol
 {
     bool is_connected;
     bool is_shutdown_requested;
+    bool use_batch;
+    bool is_throttled;
     struct lws * wsi;
     wf_client_protocol_callback_fn * callback;
     struct wf_impl_filesystem * filesystem;
@@ -39,6 +43,8 @@ struct wf_client_protocol
     struct wf_jsonrpc_proxy * proxy;
     struct wf_slist messages;
     struct wf_buffer recv_buffer;
+    struct wf_arena arena;
+    struct wf_message_pool message_pool;
 };
 
 extern void
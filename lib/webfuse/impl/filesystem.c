@@ -3,7 +3,13 @@
 #include "webfuse/impl/operation/open.h"
 #include "webfuse/impl/operation/close.h"
 #include "webfuse/impl/operation/read.h"
+#include "webfuse/impl/operation/readahead.h"
+#include "webfuse/impl/cache/block_cache.h"
+#include "webfuse/impl/cache/file_versions.h"
+#include "webfuse/impl/cache/negative_cache.h"
 #include "webfuse/impl/operation/readdir.h"
+#include "webfuse/impl/operation/opendir.h"
+#include "webfuse/impl/operation/releasedir.h"
 #include "webfuse/impl/operation/getattr.h"
 #include "webfuse/impl/operation/lookup.h"
 #include "webfuse/impl/session.h"
@@ -25,7 +31,10 @@ static struct fuse_lowlevel_ops const filesystem_operations =
 {
 	.lookup = &wf_impl_operation_lookup,
 	.getattr = &wf_impl_operation_getattr,
+	.opendir = &wf_impl_operation_opendir,
 	.readdir = &wf_impl_operation_readdir,
+	.readdirplus = &wf_impl_operation_readdirplus,
+	.releasedir = &wf_impl_operation_releasedir,
 	.open	= &wf_impl_operation_open,
 	.release = &wf_impl_operation_close,
 	.read	= &wf_impl_operation_read
@@ -44,6 +53,22 @@ static void wf_impl_filesystem_cleanup(
 
 	wf_mountpoint_dispose(filesystem->mountpoint);
 
+	if (NULL != filesystem->user_data.readahead)
+	{
+		wf_impl_readahead_dispose(filesystem->user_data.readahead);
+	}
+	if (NULL != filesystem->user_data.cache)
+	{
+		wf_impl_block_cache_dispose(filesystem->user_data.cache);
+	}
+	if (NULL != filesystem->user_data.versions)
+	{
+		wf_impl_file_versions_dispose(filesystem->user_data.versions);
+	}
+	if (NULL != filesystem->user_data.negative_cache)
+	{
+		wf_impl_negative_cache_dispose(filesystem->user_data.negative_cache);
+	}
 	free(filesystem->user_data.name);
 }
 
@@ -63,8 +88,15 @@ static bool wf_impl_filesystem_init(
 	filesystem->args.allocated = 0;
 
 	filesystem->user_data.proxy = proxy;
-	filesystem->user_data.timeout = 1.0;
+	filesystem->user_data.attr_timeout = wf_impl_mountpoint_get_attr_timeout(mountpoint);
+	filesystem->user_data.entry_timeout = wf_impl_mountpoint_get_entry_timeout(mountpoint);
 	filesystem->user_data.name = strdup(name);
+	filesystem->user_data.readahead = NULL;
+	filesystem->user_data.cache = NULL;
+	filesystem->user_data.versions = NULL;
+	filesystem->user_data.direct_io_threshold = 0;
+	filesystem->user_data.negative_timeout = 0.0;
+	filesystem->user_data.negative_cache = NULL;
 	memset(&filesystem->buffer, 0, sizeof(struct fuse_buf));
 
 	filesystem->mountpoint = mountpoint;
@@ -95,6 +127,30 @@ static bool wf_impl_filesystem_init(
 
 	}
 
+	if (result)
+	{
+		size_t const cache_size = wf_impl_mountpoint_get_cache_size(mountpoint);
+		if (0 < cache_size)
+		{
+			filesystem->user_data.cache = wf_impl_block_cache_create(cache_size);
+		}
+
+		size_t const readahead = wf_impl_mountpoint_get_readahead(mountpoint);
+		if (0 < readahead)
+		{
+			filesystem->user_data.readahead = wf_impl_readahead_create(readahead, filesystem->user_data.cache);
+		}
+
+		filesystem->user_data.versions = wf_impl_file_versions_create();
+		filesystem->user_data.direct_io_threshold = wf_impl_mountpoint_get_direct_io_threshold(mountpoint);
+
+		filesystem->user_data.negative_timeout = wf_impl_mountpoint_get_negative_timeout(mountpoint);
+		if (0.0 < filesystem->user_data.negative_timeout)
+		{
+			filesystem->user_data.negative_cache = wf_impl_negative_cache_create();
+		}
+	}
+
 	return result;
 }
 
@@ -2,12 +2,14 @@
 #include "webfuse/impl/json/node_intern.h"
 #include "webfuse/impl/json/reader.h"
 #include "webfuse/impl/json/parser.h"
+#include "webfuse/impl/util/arena.h"
 
 #include <stdlib.h>
 
 struct wf_json_doc
 {
     struct wf_json root;
+    struct wf_arena * arena;
 };
 
 struct wf_json_doc *
@@ -19,6 +21,7 @@ wf_impl_json_doc_loadb(
     wf_impl_json_reader_init(&reader, data, length);
 
     struct wf_json_doc * doc = malloc(sizeof(struct wf_json_doc));
+    doc->arena = NULL;
     if (!wf_impl_json_parse_value(&reader, &doc->root))
     {
         free(doc);
@@ -28,12 +31,36 @@ wf_impl_json_doc_loadb(
     return doc;    
 }
 
+struct wf_json_doc *
+wf_impl_json_doc_loadb_arena(
+    char * data,
+    size_t length,
+    struct wf_arena * arena)
+{
+    struct wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, data, length);
+    reader.arena = arena;
+
+    struct wf_json_doc * doc = wf_impl_arena_alloc(arena, sizeof(struct wf_json_doc));
+    doc->arena = arena;
+    if (!wf_impl_json_parse_value(&reader, &doc->root))
+    {
+        doc = NULL;
+    }
+
+    return doc;
+}
+
 void
 wf_impl_json_doc_dispose(
     struct wf_json_doc * doc)
 {
-    wf_impl_json_cleanup(&doc->root);
-    free(doc);
+    // memory of arena documents is released when the arena is reset
+    if (NULL == doc->arena)
+    {
+        wf_impl_json_cleanup(&doc->root);
+        free(doc);
+    }
 }
 
 struct wf_json const *
@@ -14,12 +14,21 @@ extern "C"
 
 struct wf_json_doc;
 struct wf_json;
+struct wf_arena;
 
 extern struct wf_json_doc *
 wf_impl_json_doc_loadb(
     char * data,
     size_t length);
 
+// The document is allocated from the arena. It must be disposed before
+// the arena is reset.
+extern struct wf_json_doc *
+wf_impl_json_doc_loadb_arena(
+    char * data,
+    size_t length,
+    struct wf_arena * arena);
+
 extern void
 wf_impl_json_doc_dispose(
     struct wf_json_doc * doc);
@@ -0,0 +1,72 @@
+#include "webfuse/impl/json/fields.h"
+#include "webfuse/impl/json/node_intern.h"
+
+#include <string.h>
+
+static void
+wf_impl_json_fields_set(
+    struct wf_json const * json,
+    struct wf_json_field const * field,
+    void * target)
+{
+    char * member = ((char *) target) + field->offset;
+
+    switch (field->type)
+    {
+        case WF_JSON_TYPE_INT:
+            *((int64_t *) member) = json->value.i;
+            break;
+        case WF_JSON_TYPE_BOOL:
+            *((bool *) member) = json->value.b;
+            break;
+        case WF_JSON_TYPE_STRING:
+            {
+                struct wf_json_field_string * value = (struct wf_json_field_string *) member;
+                value->data = json->value.s.data;
+                value->size = json->value.s.size;
+            }
+            break;
+        case WF_JSON_TYPE_ARRAY:
+            // fall-through
+        case WF_JSON_TYPE_OBJECT:
+            *((struct wf_json const * *) member) = json;
+            break;
+        default:
+            break;
+    }
+}
+
+uint32_t
+wf_impl_json_fields_decode(
+    struct wf_json const * json,
+    struct wf_json_field const * fields,
+    size_t count,
+    void * target)
+{
+    uint32_t result = 0;
+    if ((NULL == json) || (WF_JSON_TYPE_OBJECT != json->type)) { return result; }
+
+    size_t const size = json->value.o.size;
+    for(size_t i = 0; i < size; i++)
+    {
+        struct wf_json_object_item const * item = &(json->value.o.items[i]);
+        char const * key = item->key;
+
+        for(size_t j = 0; j < count; j++)
+        {
+            struct wf_json_field const * field = &fields[j];
+            if ((key[0] == field->key[0]) && (0 == strcmp(&key[1], &field->key[1])))
+            {
+                uint32_t const bit = ((uint32_t) 1) << j;
+                if ((0 == (result & bit)) && (field->type == item->json.type))
+                {
+                    wf_impl_json_fields_set(&item->json, field, target);
+                    result |= bit;
+                }
+                break;
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,59 @@
+#ifndef WF_IMPL_JSON_FIELDS_H
+#define WF_IMPL_JSON_FIELDS_H
+
+#include "webfuse/impl/json/node.h"
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#else
+#include <cstddef>
+#include <cstdint>
+using std::size_t;
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Field tables describe the members of known JSON objects, such as RPC
+// results. An object is decoded in a single pass over its members; each
+// member is matched by its first byte before the rest of the key is
+// compared.
+//
+// Targets are int64_t (WF_JSON_TYPE_INT), bool (WF_JSON_TYPE_BOOL),
+// struct wf_json_field_string (WF_JSON_TYPE_STRING) or
+// struct wf_json const * (WF_JSON_TYPE_ARRAY and WF_JSON_TYPE_OBJECT).
+
+struct wf_json_field
+{
+    char const * key;
+    enum wf_json_type type;
+    size_t offset;
+};
+
+struct wf_json_field_string
+{
+    char const * data;
+    size_t size;
+};
+
+#define WF_JSON_FIELD(key, type, target_type, member) \
+    { (key), (type), offsetof(target_type, member) }
+
+// Returns a bit mask of decoded fields, where bit i refers to fields[i].
+// Members of unexpected type are ignored; so are duplicate keys.
+extern uint32_t
+wf_impl_json_fields_decode(
+    struct wf_json const * json,
+    struct wf_json_field const * fields,
+    size_t count,
+    void * target);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
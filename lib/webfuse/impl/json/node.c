@@ -75,6 +75,13 @@ wf_impl_json_is_object(
 int
 wf_impl_json_int_get(
     struct wf_json const * json)
+{
+    return (WF_JSON_TYPE_INT == json->type) ? (int) json->value.i : 0;
+}
+
+int64_t
+wf_impl_json_int64_get(
+    struct wf_json const * json)
 {
     return (WF_JSON_TYPE_INT == json->type) ? json->value.i : 0;
 }
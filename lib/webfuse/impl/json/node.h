@@ -4,8 +4,10 @@
 #ifndef __cplusplus
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #else
 #include <cstddef>
+#include <cstdint>
 #endif
 
 #ifdef __cplusplus
@@ -66,6 +68,10 @@ extern int
 wf_impl_json_int_get(
     struct wf_json const * json);
 
+extern int64_t
+wf_impl_json_int64_get(
+    struct wf_json const * json);
+
 extern char const *
 wf_impl_json_string_get(
     struct wf_json const * json);
@@ -1,6 +1,7 @@
 #include "webfuse/impl/json/parser.h"
 #include "webfuse/impl/json/reader.h"
 #include "webfuse/impl/json/node_intern.h"
+#include "webfuse/impl/util/arena.h"
 
 #include <stdlib.h>
 
@@ -43,6 +44,38 @@ wf_impl_json_parse_object(
 
 // --
 
+// items are allocated from the reader's arena, if any;
+// arena memory is released by the arena's owner, never by the parser
+
+static void *
+wf_impl_json_parser_alloc(
+    struct wf_json_reader * reader,
+    size_t size)
+{
+    return (NULL != reader->arena) ? wf_impl_arena_alloc(reader->arena, size) : malloc(size);
+}
+
+static void *
+wf_impl_json_parser_realloc(
+    struct wf_json_reader * reader,
+    void * data,
+    size_t old_size,
+    size_t new_size)
+{
+    return (NULL != reader->arena) ? wf_impl_arena_realloc(reader->arena, data, old_size, new_size) : realloc(data, new_size);
+}
+
+static void
+wf_impl_json_parser_cleanup(
+    struct wf_json_reader * reader,
+    struct wf_json * json)
+{
+    if (NULL == reader->arena)
+    {
+        wf_impl_json_cleanup(json);
+    }
+}
+
 bool
 wf_impl_json_parse_value(
     struct wf_json_reader * reader,
@@ -144,8 +177,8 @@ wf_impl_json_parse_int(
     struct wf_json_reader * reader,
     struct wf_json * json)
 {
-    int value;
-    bool const result = wf_impl_json_reader_read_int(reader, &value);
+    int64_t value;
+    bool const result = wf_impl_json_reader_read_int64(reader, &value);
     if (result)
     {
         json->type = WF_JSON_TYPE_INT;
@@ -184,7 +217,7 @@ wf_impl_json_parse_array(
 
     size_t capacity = WF_JSON_PARSER_INITIAL_CAPACITY;
     json->type = WF_JSON_TYPE_ARRAY;
-    json->value.a.items = malloc(sizeof(struct wf_json) * capacity);
+    json->value.a.items = wf_impl_json_parser_alloc(reader, sizeof(struct wf_json) * capacity);
     json->value.a.size = 0;
 
     c = wf_impl_json_reader_skip_whitespace(reader);
@@ -199,8 +232,9 @@ wf_impl_json_parse_array(
     {
         if (json->value.a.size >= capacity)
         {
+            json->value.a.items = wf_impl_json_parser_realloc(reader, json->value.a.items,
+                sizeof(struct wf_json) * capacity, sizeof(struct wf_json) * capacity * 2);
             capacity *= 2;
-            json->value.a.items = realloc(json->value.a.items, sizeof(struct wf_json) * capacity);
         }
 
         result = wf_impl_json_parse_value(reader, &(json->value.a.items[json->value.a.size]));
@@ -219,7 +253,7 @@ wf_impl_json_parse_array(
 
     if (!result)
     {
-        wf_impl_json_cleanup(json);
+        wf_impl_json_parser_cleanup(reader, json);
     }
 
     return result;
@@ -236,7 +270,7 @@ wf_impl_json_parse_object(
 
     size_t capacity = WF_JSON_PARSER_INITIAL_CAPACITY;
     json->type = WF_JSON_TYPE_OBJECT;
-    json->value.o.items = malloc(sizeof(struct wf_json_object_item) * capacity);
+    json->value.o.items = wf_impl_json_parser_alloc(reader, sizeof(struct wf_json_object_item) * capacity);
     json->value.o.size = 0;
 
     c = wf_impl_json_reader_skip_whitespace(reader);
@@ -251,8 +285,9 @@ wf_impl_json_parse_object(
     {
         if (json->value.o.size >= capacity)
         {
+            json->value.o.items = wf_impl_json_parser_realloc(reader, json->value.o.items,
+                sizeof(struct wf_json_object_item) * capacity, sizeof(struct wf_json_object_item) * capacity * 2);
             capacity *= 2;
-            json->value.o.items = realloc(json->value.o.items, sizeof(struct wf_json_object_item) * capacity);
         }
 
         struct wf_json_object_item * item = &(json->value.o.items[json->value.o.size]);
@@ -284,7 +319,7 @@ wf_impl_json_parse_object(
 
     if (!result)
     {
-        wf_impl_json_cleanup(json);
+        wf_impl_json_parser_cleanup(reader, json);
     }
 
     return result;
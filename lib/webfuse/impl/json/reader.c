@@ -1,6 +1,8 @@
 #include "webfuse/impl/json/reader.h"
+#include "webfuse/impl/json/scan.h"
 
 #include <string.h>
+#include <limits.h>
 
 static char
 wf_impl_json_unescape(
@@ -15,6 +17,7 @@ wf_impl_json_reader_init(
     reader->contents = contents;
     reader->length = length;
     reader->pos = 0;
+    reader->arena = NULL;
 }
 
 char
@@ -22,9 +25,10 @@ wf_impl_json_reader_skip_whitespace(
     struct wf_json_reader * reader)
 {
     char c = wf_impl_json_reader_peek(reader);
-    while ((' ' == c) || ('\n' == c) || ('\t' == c) || ('\r' == c))
+    if ((' ' == c) || ('\n' == c) || ('\t' == c) || ('\r' == c))
     {
         reader->pos++;
+        reader->pos += wf_impl_json_scan_whitespace(&reader->contents[reader->pos], reader->length - reader->pos);
         c = wf_impl_json_reader_peek(reader);
     }
 
@@ -87,6 +91,22 @@ bool
 wf_impl_json_reader_read_int(
     struct wf_json_reader * reader,
     int * value)
+{
+    int64_t v;
+    bool const result = (wf_impl_json_reader_read_int64(reader, &v)) &&
+        (INT_MIN <= v) && (v <= INT_MAX);
+    if (result)
+    {
+        *value = (int) v;
+    }
+
+    return result;
+}
+
+bool
+wf_impl_json_reader_read_int64(
+    struct wf_json_reader * reader,
+    int64_t * value)
 {
     char c = wf_impl_json_reader_get_char(reader);
     bool const is_signed = ('-' == c);
@@ -95,20 +115,26 @@ wf_impl_json_reader_read_int(
         c = wf_impl_json_reader_get_char(reader);
     }
 
-    bool const result = (('0' <= c) && (c <= '9'));
+    uint64_t const limit = (is_signed) ? ((uint64_t) INT64_MAX) + 1 : (uint64_t) INT64_MAX;
+    bool result = (('0' <= c) && (c <= '9'));
     if (result)
     {
-        int v = c - '0';
+        uint64_t v = (uint64_t) (c - '0');
         c = wf_impl_json_reader_peek(reader);
-        while (('0' <= c) && (c <= '9'))
+        while ((result) && ('0' <= c) && (c <= '9'))
         {
+            uint64_t const digit = (uint64_t) (c - '0');
+            result = (v <= ((limit - digit) / 10));
             v *= 10;
-            v += c - '0';
+            v += digit;
             reader->pos++;
             c = wf_impl_json_reader_peek(reader);
         }
 
-        *value = (is_signed) ? -v : v;
+        if (result)
+        {
+            *value = (!is_signed) ? (int64_t) v : ((limit == v) ? INT64_MIN : -((int64_t) v));
+        }
     }
 
     return result;
@@ -124,30 +150,32 @@ wf_impl_json_reader_read_string(
     char c = wf_impl_json_reader_get_char(reader);
     if ('\"' != c) { return false; }
 
-    size_t start = reader->pos;
-    size_t p = reader->pos;
-    c = wf_impl_json_reader_get_char(reader);
-    while (('\"' != c) && ('\0' != c))
+    // plain runs are found by the scanner; after the first escape sequence,
+    // they are moved to close the gap left by unescaping
+    size_t const start = reader->pos;
+    size_t p = start;
+    while (true)
     {
-        if ('\\' != c)
+        size_t const run = wf_impl_json_scan_string(&reader->contents[reader->pos], reader->length - reader->pos);
+        if (p != reader->pos)
         {
-            reader->contents[p++] = c;
+            memmove(&reader->contents[p], &reader->contents[reader->pos], run);
         }
-        else
+        p += run;
+        reader->pos += run;
+
+        c = wf_impl_json_reader_get_char(reader);
+        if ('\\' != c)
         {
-            char unescaped = wf_impl_json_unescape(wf_impl_json_reader_get_char(reader));
-            if ('\0' != unescaped)
-            {
-                reader->contents[p++] = unescaped;
-
-            }
-            else
-            {
-                return false;
-            }
+            break;
         }
 
-        c = wf_impl_json_reader_get_char(reader);
+        char const unescaped = wf_impl_json_unescape(wf_impl_json_reader_get_char(reader));
+        if ('\0' == unescaped)
+        {
+            return false;
+        }
+        reader->contents[p++] = unescaped;
     }
 
     bool const result = ('\"' == c);
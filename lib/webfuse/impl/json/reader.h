@@ -4,8 +4,10 @@
 #ifndef __cplusplus
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #else
 #include <cstddef>
+#include <cstdint>
 #endif
 
 #ifdef __cplusplus
@@ -13,11 +15,14 @@ extern "C"
 {
 #endif
 
+struct wf_arena;
+
 struct wf_json_reader
 {
     char * contents;
     size_t length;
     size_t pos;
+    struct wf_arena * arena;
 };
 
 extern void
@@ -53,6 +58,11 @@ wf_impl_json_reader_read_int(
     struct wf_json_reader * reader,
     int * value);
 
+extern bool
+wf_impl_json_reader_read_int64(
+    struct wf_json_reader * reader,
+    int64_t * value);
+
 extern bool
 wf_impl_json_reader_read_string(
     struct wf_json_reader * reader,
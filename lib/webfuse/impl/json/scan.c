@@ -0,0 +1,164 @@
+#include "webfuse/impl/json/scan.h"
+#include "webfuse/impl/json/scan_simd.h"
+#include "webfuse/impl/util/cpu.h"
+
+#include <stdint.h>
+#include <string.h>
+
+// Scalar strings are scanned word-wise; a byte is matched, if it
+// becomes zero when xor'ed with the searched character.
+static size_t
+wf_impl_json_scan_string_scalar(
+    char const * data,
+    size_t length)
+{
+    uint64_t const ones = UINT64_C(0x0101010101010101);
+    uint64_t const highs = UINT64_C(0x8080808080808080);
+    uint64_t const quotes = ones * (uint8_t) '\"';
+    uint64_t const backslashes = ones * (uint8_t) '\\';
+
+    size_t pos = 0;
+    for(; (length - pos) >= sizeof(uint64_t); pos += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, &data[pos], sizeof(uint64_t));
+
+        uint64_t const q = word ^ quotes;
+        uint64_t const b = word ^ backslashes;
+        uint64_t const special = ((q - ones) & ~q) | ((b - ones) & ~b) | ((word - ones) & ~word);
+        if (0 != (special & highs))
+        {
+            break;
+        }
+    }
+
+    return pos;
+}
+
+static inline bool
+wf_impl_json_scan_is_whitespace(
+    char c)
+{
+    return ((' ' == c) || ('\n' == c) || ('\t' == c) || ('\r' == c));
+}
+
+struct wf_impl_json_scan_variant_info
+{
+    char const * name;
+    enum wf_impl_cpu_feature feature;
+    wf_impl_json_scan_kernel_fn * string;
+    wf_impl_json_scan_kernel_fn * whitespace;
+};
+
+static struct wf_impl_json_scan_variant_info const wf_impl_json_scan_variants[] =
+{
+    [WF_IMPL_JSON_SCAN_SCALAR] = {"scalar", WF_IMPL_CPU_BASELINE, &wf_impl_json_scan_string_scalar, NULL},
+#if defined(WF_IMPL_JSON_SCAN_HAVE_X86)
+    [WF_IMPL_JSON_SCAN_SSE2] = {"sse2", WF_IMPL_CPU_SSE2, &wf_impl_json_scan_string_sse2, &wf_impl_json_scan_whitespace_sse2},
+    [WF_IMPL_JSON_SCAN_AVX2] = {"avx2", WF_IMPL_CPU_AVX2, &wf_impl_json_scan_string_avx2, &wf_impl_json_scan_whitespace_avx2},
+#else
+    [WF_IMPL_JSON_SCAN_SSE2] = {"sse2", WF_IMPL_CPU_SSE2, NULL, NULL},
+    [WF_IMPL_JSON_SCAN_AVX2] = {"avx2", WF_IMPL_CPU_AVX2, NULL, NULL},
+#endif
+#if defined(WF_IMPL_JSON_SCAN_HAVE_NEON)
+    [WF_IMPL_JSON_SCAN_NEON] = {"neon", WF_IMPL_CPU_NEON, &wf_impl_json_scan_string_neon, &wf_impl_json_scan_whitespace_neon}
+#else
+    [WF_IMPL_JSON_SCAN_NEON] = {"neon", WF_IMPL_CPU_NEON, NULL, NULL}
+#endif
+};
+
+static int wf_impl_json_scan_best_variant = -1;
+
+bool
+wf_impl_json_scan_variant_supported(
+    enum wf_impl_json_scan_variant variant)
+{
+    struct wf_impl_json_scan_variant_info const * info = &wf_impl_json_scan_variants[variant];
+    return (NULL != info->string) && (wf_impl_cpu_supports(info->feature));
+}
+
+static bool
+wf_impl_json_scan_is_supported(
+    int variant)
+{
+    return wf_impl_json_scan_variant_supported((enum wf_impl_json_scan_variant) variant);
+}
+
+char const *
+wf_impl_json_scan_variant_name(
+    enum wf_impl_json_scan_variant variant)
+{
+    return wf_impl_json_scan_variants[variant].name;
+}
+
+enum wf_impl_json_scan_variant
+wf_impl_json_scan_get_variant(void)
+{
+    static int const candidates[] =
+    {
+        WF_IMPL_JSON_SCAN_AVX2,
+        WF_IMPL_JSON_SCAN_NEON,
+        WF_IMPL_JSON_SCAN_SSE2
+    };
+
+    return (enum wf_impl_json_scan_variant) wf_impl_cpu_select_variant(&wf_impl_json_scan_best_variant,
+        candidates, sizeof(candidates) / sizeof(candidates[0]), &wf_impl_json_scan_is_supported, WF_IMPL_JSON_SCAN_SCALAR);
+}
+
+size_t
+wf_impl_json_scan_string_variant(
+    enum wf_impl_json_scan_variant variant,
+    char const * data,
+    size_t length)
+{
+    size_t pos = 0;
+    wf_impl_json_scan_kernel_fn * scan = wf_impl_json_scan_variants[variant].string;
+    if (NULL != scan)
+    {
+        pos = scan(data, length);
+    }
+
+    while ((pos < length) && ('\"' != data[pos]) && ('\\' != data[pos]) && ('\0' != data[pos]))
+    {
+        pos++;
+    }
+
+    return pos;
+}
+
+size_t
+wf_impl_json_scan_whitespace_variant(
+    enum wf_impl_json_scan_variant variant,
+    char const * data,
+    size_t length)
+{
+    size_t pos = 0;
+    wf_impl_json_scan_kernel_fn * scan = wf_impl_json_scan_variants[variant].whitespace;
+    if (NULL != scan)
+    {
+        pos = scan(data, length);
+    }
+
+    while ((pos < length) && (wf_impl_json_scan_is_whitespace(data[pos])))
+    {
+        pos++;
+    }
+
+    return pos;
+}
+
+size_t
+wf_impl_json_scan_string(
+    char const * data,
+    size_t length)
+{
+    return wf_impl_json_scan_string_variant(wf_impl_json_scan_get_variant(), data, length);
+}
+
+size_t
+wf_impl_json_scan_whitespace(
+    char const * data,
+    size_t length)
+{
+    return wf_impl_json_scan_whitespace_variant(wf_impl_json_scan_get_variant(), data, length);
+}
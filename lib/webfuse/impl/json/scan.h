@@ -0,0 +1,70 @@
+#ifndef WF_IMPL_JSON_SCAN_H
+#define WF_IMPL_JSON_SCAN_H
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <stdbool.h>
+#else
+#include <cstddef>
+using std::size_t;
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+enum wf_impl_json_scan_variant
+{
+    WF_IMPL_JSON_SCAN_SCALAR,
+    WF_IMPL_JSON_SCAN_SSE2,
+    WF_IMPL_JSON_SCAN_AVX2,
+    WF_IMPL_JSON_SCAN_NEON
+};
+
+#define WF_IMPL_JSON_SCAN_VARIANT_COUNT 4
+
+// Returns the length of the leading run of string characters, which need
+// no further processing, i.e. all characters except '"', '\\' and '\0'.
+extern size_t
+wf_impl_json_scan_string(
+    char const * data,
+    size_t length);
+
+// Returns the length of the leading run of whitespace (' ', '\t', '\n', '\r').
+extern size_t
+wf_impl_json_scan_whitespace(
+    char const * data,
+    size_t length);
+
+// Scanning uses the fastest variant supported by the CPU.
+// The variant specific functions are used by tests and benchmarks.
+
+extern enum wf_impl_json_scan_variant
+wf_impl_json_scan_get_variant(void);
+
+extern bool
+wf_impl_json_scan_variant_supported(
+    enum wf_impl_json_scan_variant variant);
+
+extern char const *
+wf_impl_json_scan_variant_name(
+    enum wf_impl_json_scan_variant variant);
+
+extern size_t
+wf_impl_json_scan_string_variant(
+    enum wf_impl_json_scan_variant variant,
+    char const * data,
+    size_t length);
+
+extern size_t
+wf_impl_json_scan_whitespace_variant(
+    enum wf_impl_json_scan_variant variant,
+    char const * data,
+    size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,197 @@
+#include "webfuse/impl/json/scan_simd.h"
+
+#include <stdint.h>
+
+#if defined(WF_IMPL_JSON_SCAN_HAVE_X86)
+
+#include <immintrin.h>
+
+// Each block is compared against the characters of interest; the movemask
+// of the comparison has one bit per byte, so the first match is found by
+// counting trailing zeros.
+
+__attribute__((target("sse2")))
+size_t
+wf_impl_json_scan_string_sse2(
+    char const * data,
+    size_t length)
+{
+    __m128i const quote = _mm_set1_epi8('\"');
+    __m128i const backslash = _mm_set1_epi8('\\');
+    __m128i const zero = _mm_setzero_si128();
+
+    size_t pos = 0;
+    for(; (length - pos) >= 16; pos += 16)
+    {
+        __m128i const block = _mm_loadu_si128((__m128i const *) &data[pos]);
+        __m128i const special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)),
+            _mm_cmpeq_epi8(block, zero));
+
+        unsigned int const mask = (unsigned int) _mm_movemask_epi8(special);
+        if (0 != mask)
+        {
+            return pos + (size_t) __builtin_ctz(mask);
+        }
+    }
+
+    return pos;
+}
+
+__attribute__((target("sse2")))
+size_t
+wf_impl_json_scan_whitespace_sse2(
+    char const * data,
+    size_t length)
+{
+    __m128i const space = _mm_set1_epi8(' ');
+    __m128i const tab = _mm_set1_epi8('\t');
+    __m128i const newline = _mm_set1_epi8('\n');
+    __m128i const carriage_return = _mm_set1_epi8('\r');
+
+    size_t pos = 0;
+    for(; (length - pos) >= 16; pos += 16)
+    {
+        __m128i const block = _mm_loadu_si128((__m128i const *) &data[pos]);
+        __m128i const whitespace = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(block, newline), _mm_cmpeq_epi8(block, carriage_return)));
+
+        unsigned int const mask = (~((unsigned int) _mm_movemask_epi8(whitespace))) & 0xffff;
+        if (0 != mask)
+        {
+            return pos + (size_t) __builtin_ctz(mask);
+        }
+    }
+
+    return pos;
+}
+
+__attribute__((target("avx2")))
+size_t
+wf_impl_json_scan_string_avx2(
+    char const * data,
+    size_t length)
+{
+    __m256i const quote = _mm256_set1_epi8('\"');
+    __m256i const backslash = _mm256_set1_epi8('\\');
+    __m256i const zero = _mm256_setzero_si256();
+
+    size_t pos = 0;
+    for(; (length - pos) >= 32; pos += 32)
+    {
+        __m256i const block = _mm256_loadu_si256((__m256i const *) &data[pos]);
+        __m256i const special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, quote), _mm256_cmpeq_epi8(block, backslash)),
+            _mm256_cmpeq_epi8(block, zero));
+
+        uint32_t const mask = (uint32_t) _mm256_movemask_epi8(special);
+        if (0 != mask)
+        {
+            return pos + (size_t) __builtin_ctz(mask);
+        }
+    }
+
+    return pos;
+}
+
+__attribute__((target("avx2")))
+size_t
+wf_impl_json_scan_whitespace_avx2(
+    char const * data,
+    size_t length)
+{
+    __m256i const space = _mm256_set1_epi8(' ');
+    __m256i const tab = _mm256_set1_epi8('\t');
+    __m256i const newline = _mm256_set1_epi8('\n');
+    __m256i const carriage_return = _mm256_set1_epi8('\r');
+
+    size_t pos = 0;
+    for(; (length - pos) >= 32; pos += 32)
+    {
+        __m256i const block = _mm256_loadu_si256((__m256i const *) &data[pos]);
+        __m256i const whitespace = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, space), _mm256_cmpeq_epi8(block, tab)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, newline), _mm256_cmpeq_epi8(block, carriage_return)));
+
+        uint32_t const mask = ~((uint32_t) _mm256_movemask_epi8(whitespace));
+        if (0 != mask)
+        {
+            return pos + (size_t) __builtin_ctz(mask);
+        }
+    }
+
+    return pos;
+}
+
+#endif
+
+#if defined(WF_IMPL_JSON_SCAN_HAVE_NEON)
+
+#include <arm_neon.h>
+
+// NEON has no movemask; narrowing each 16 bit lane by 4 bits yields
+// one nibble per byte, so the first match is at trailing zeros / 4
+static inline uint64_t
+wf_impl_json_scan_neon_mask(
+    uint8x16_t matches)
+{
+    uint8x8_t const nibbles = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+}
+
+size_t
+wf_impl_json_scan_string_neon(
+    char const * data,
+    size_t length)
+{
+    uint8x16_t const quote = vdupq_n_u8('\"');
+    uint8x16_t const backslash = vdupq_n_u8('\\');
+
+    size_t pos = 0;
+    for(; (length - pos) >= 16; pos += 16)
+    {
+        uint8x16_t const block = vld1q_u8((uint8_t const *) &data[pos]);
+        uint8x16_t const special = vorrq_u8(
+            vorrq_u8(vceqq_u8(block, quote), vceqq_u8(block, backslash)),
+            vceqzq_u8(block));
+
+        uint64_t const mask = wf_impl_json_scan_neon_mask(special);
+        if (0 != mask)
+        {
+            return pos + (size_t) (__builtin_ctzll(mask) >> 2);
+        }
+    }
+
+    return pos;
+}
+
+size_t
+wf_impl_json_scan_whitespace_neon(
+    char const * data,
+    size_t length)
+{
+    uint8x16_t const space = vdupq_n_u8(' ');
+    uint8x16_t const tab = vdupq_n_u8('\t');
+    uint8x16_t const newline = vdupq_n_u8('\n');
+    uint8x16_t const carriage_return = vdupq_n_u8('\r');
+
+    size_t pos = 0;
+    for(; (length - pos) >= 16; pos += 16)
+    {
+        uint8x16_t const block = vld1q_u8((uint8_t const *) &data[pos]);
+        uint8x16_t const whitespace = vorrq_u8(
+            vorrq_u8(vceqq_u8(block, space), vceqq_u8(block, tab)),
+            vorrq_u8(vceqq_u8(block, newline), vceqq_u8(block, carriage_return)));
+
+        uint64_t const mask = ~wf_impl_json_scan_neon_mask(whitespace);
+        if (0 != mask)
+        {
+            return pos + (size_t) (__builtin_ctzll(mask) >> 2);
+        }
+    }
+
+    return pos;
+}
+
+#endif
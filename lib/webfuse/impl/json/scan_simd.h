@@ -0,0 +1,74 @@
+#ifndef WF_IMPL_JSON_SCAN_SIMD_H
+#define WF_IMPL_JSON_SCAN_SIMD_H
+
+#ifndef __cplusplus
+#include <stddef.h>
+#else
+#include <cstddef>
+using std::size_t;
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Vectorized kernels scan complete blocks of 16 or 32 bytes only.
+//
+// Kernels return the position of the first character, which ends the run,
+// if it is found within a block. Otherwise the number of scanned bytes is
+// returned and the remainder (less than one block) is left to the scalar
+// implementation.
+
+typedef size_t
+wf_impl_json_scan_kernel_fn(
+    char const * data,
+    size_t length);
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#define WF_IMPL_JSON_SCAN_HAVE_X86
+
+extern size_t
+wf_impl_json_scan_string_sse2(
+    char const * data,
+    size_t length);
+
+extern size_t
+wf_impl_json_scan_whitespace_sse2(
+    char const * data,
+    size_t length);
+
+extern size_t
+wf_impl_json_scan_string_avx2(
+    char const * data,
+    size_t length);
+
+extern size_t
+wf_impl_json_scan_whitespace_avx2(
+    char const * data,
+    size_t length);
+
+#endif
+
+#if defined(__aarch64__)
+
+#define WF_IMPL_JSON_SCAN_HAVE_NEON
+
+extern size_t
+wf_impl_json_scan_string_neon(
+    char const * data,
+    size_t length);
+
+extern size_t
+wf_impl_json_scan_whitespace_neon(
+    char const * data,
+    size_t length);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
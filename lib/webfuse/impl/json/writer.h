@@ -4,8 +4,10 @@
 #ifndef __cplusplus
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #else
 #include <cstddef>
+#include <cstdint>
 #endif
 
 #ifdef __cplusplus
@@ -33,6 +35,21 @@ wf_impl_json_writer_take(
     struct wf_json_writer * writer,
     size_t * size);
 
+// Replaces the buffer of the writer and resets it, so that a writer
+// can be reused with pooled buffers. The writer takes ownership of
+// raw_data, which must provide room for pre + capacity bytes.
+extern void
+wf_impl_json_writer_attach(
+    struct wf_json_writer * writer,
+    char * raw_data,
+    size_t capacity);
+
+// Returns the capacity of the current buffer; after take, the capacity
+// of the taken buffer is returned.
+extern size_t
+wf_impl_json_writer_capacity(
+    struct wf_json_writer * writer);
+
 extern void
 wf_impl_json_write_null(
     struct wf_json_writer * writer);
@@ -47,6 +64,11 @@ wf_impl_json_write_int(
     struct wf_json_writer * writer,
     int value);
 
+extern void
+wf_impl_json_write_int64(
+    struct wf_json_writer * writer,
+    int64_t value);
+
 extern void
 wf_impl_json_write_string(
     struct wf_json_writer * writer,
@@ -101,6 +123,12 @@ wf_impl_json_write_object_int(
     char const * key,
     int value);
 
+extern void
+wf_impl_json_write_object_int64(
+    struct wf_json_writer * writer,
+    char const * key,
+    int64_t value);
+
 extern void
 wf_impl_json_write_object_string(
     struct wf_json_writer * writer,
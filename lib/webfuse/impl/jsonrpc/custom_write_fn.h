@@ -0,0 +1,20 @@
+#ifndef WF_IMPL_JSONRPC_CUSTOM_WRITE_FN_H
+#define WF_IMPL_JSONRPC_CUSTOM_WRITE_FN_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct wf_json_writer;
+
+typedef void
+wf_jsonrpc_custom_write_fn(
+	struct wf_json_writer * writer,
+	void * data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
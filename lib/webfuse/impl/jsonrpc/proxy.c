@@ -3,16 +3,28 @@
 #include "webfuse/impl/jsonrpc/response_intern.h"
 #include "webfuse/impl/jsonrpc/error.h"
 #include "webfuse/impl/json/writer.h"
+#include "webfuse/impl/json/node_intern.h"
 #include "webfuse/impl/message.h"
+#include "webfuse/impl/message_pool.h"
 #include "webfuse/status.h"
 
 #include <libwebsockets.h>
 
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 #define WF_JSONRPC_PROXY_DEFAULT_MESSAGE_SIZE 1024
 
+// binary result header: id (4 bytes), count (4 bytes), format (1 byte)
+#define WF_JSONRPC_PROXY_BINARY_ID_OFFSET     0
+#define WF_JSONRPC_PROXY_BINARY_COUNT_OFFSET  4
+#define WF_JSONRPC_PROXY_BINARY_FORMAT_OFFSET 8
+#define WF_JSONRPC_PROXY_BINARY_HEADER_SIZE   9
+
+#define WF_JSONRPC_PROXY_BINARY_FORMAT_IDENTITY 0
+#define WF_JSONRPC_PROXY_BINARY_FORMAT_DEFLATE 1
+
 struct wf_jsonrpc_proxy *
 wf_impl_jsonrpc_proxy_create(
     struct wf_timer_manager * manager,
@@ -34,14 +46,20 @@ void wf_impl_jsonrpc_proxy_dispose(
 }
 
 
+// requests are written by the writer of the proxy into pooled buffers,
+// so that neither writer nor buffer is allocated per request
 static struct wf_message * 
 wf_impl_jsonrpc_request_create(
+    struct wf_jsonrpc_proxy * proxy,
 	char const * method,
 	int id,
 	char const * param_info,
 	va_list args)
 {
-    struct wf_json_writer * writer = wf_impl_json_writer_create(WF_JSONRPC_PROXY_DEFAULT_MESSAGE_SIZE, LWS_PRE);
+    struct wf_message * message = wf_impl_message_pool_get(proxy->message_pool, WF_JSONRPC_PROXY_DEFAULT_MESSAGE_SIZE);
+    struct wf_json_writer * writer = proxy->writer;
+    wf_impl_json_writer_attach(writer, message->data - LWS_PRE, message->capacity);
+
     wf_impl_json_write_object_begin(writer);
     wf_impl_json_write_object_string(writer, "method", method);
     wf_impl_json_write_object_begin_array(writer, "params");
@@ -62,6 +80,12 @@ wf_impl_jsonrpc_request_create(
                 wf_impl_json_write_int(writer, value);
 			}
 			break;
+			case 'I':
+			{
+				int64_t const value = va_arg(args, int64_t);
+                wf_impl_json_write_int64(writer, value);
+			}
+			break;
             case 'j':
             {
                 wf_jsonrpc_custom_write_fn * write = va_arg(args, wf_jsonrpc_custom_write_fn *);
@@ -83,11 +107,10 @@ wf_impl_jsonrpc_request_create(
     
     wf_impl_json_write_object_end(writer);
 	
-    size_t length;
-    char * message = wf_impl_json_writer_take(writer, &length);
-    wf_impl_json_writer_dispose(writer);
+    message->data = wf_impl_json_writer_take(writer, &message->length);
+    message->capacity = wf_impl_json_writer_capacity(writer);
 
-	return wf_impl_message_create(message, length);
+	return message;
 }
 
 void wf_impl_jsonrpc_proxy_init(
@@ -99,19 +122,46 @@ void wf_impl_jsonrpc_proxy_init(
 {
     proxy->send = send;
     proxy->user_data = user_data;
+    proxy->writer = wf_impl_json_writer_create(WF_JSONRPC_PROXY_DEFAULT_MESSAGE_SIZE, LWS_PRE);
+    proxy->message_pool = NULL;
 
     proxy->request_manager = wf_impl_jsonrpc_proxy_request_manager_create(
         timeout_manager, timeout);
 }
 
+void wf_impl_jsonrpc_proxy_set_window(
+    struct wf_jsonrpc_proxy * proxy,
+    size_t window,
+    wf_jsonrpc_proxy_window_fn * on_window,
+    void * user_data)
+{
+    wf_impl_jsonrpc_proxy_request_manager_set_window(
+        proxy->request_manager, window, on_window, user_data);
+}
+
+size_t wf_impl_jsonrpc_proxy_pending_requests(
+    struct wf_jsonrpc_proxy * proxy)
+{
+    return wf_impl_jsonrpc_proxy_request_manager_count(proxy->request_manager);
+}
+
+void wf_impl_jsonrpc_proxy_set_message_pool(
+    struct wf_jsonrpc_proxy * proxy,
+    struct wf_message_pool * pool)
+{
+    proxy->message_pool = pool;
+}
+
 void wf_impl_jsonrpc_proxy_cleanup(
     struct wf_jsonrpc_proxy * proxy)
 {
     wf_impl_jsonrpc_proxy_request_manager_dispose(proxy->request_manager);
+    wf_impl_json_writer_dispose(proxy->writer);
 }
 
-void wf_impl_jsonrpc_proxy_vinvoke(
+static void wf_impl_jsonrpc_proxy_invoke_request(
 	struct wf_jsonrpc_proxy * proxy,
+	bool accepts_binary,
 	wf_jsonrpc_proxy_finished_fn * finished,
 	void * user_data,
 	char const * method_name,
@@ -121,7 +171,12 @@ void wf_impl_jsonrpc_proxy_vinvoke(
     int id = wf_impl_jsonrpc_proxy_request_manager_add_request(
             proxy->request_manager, finished, user_data);
 
-    struct wf_message * request = wf_impl_jsonrpc_request_create(method_name, id, param_info, args);
+    if (accepts_binary)
+    {
+        wf_impl_jsonrpc_proxy_request_manager_accept_binary(proxy->request_manager, id);
+    }
+
+    struct wf_message * request = wf_impl_jsonrpc_request_create(proxy, method_name, id, param_info, args);
     bool const is_send = proxy->send(request, proxy->user_data);
     if (!is_send)
     {
@@ -130,13 +185,35 @@ void wf_impl_jsonrpc_proxy_vinvoke(
     }
 }
 
+void wf_impl_jsonrpc_proxy_vinvoke(
+	struct wf_jsonrpc_proxy * proxy,
+	wf_jsonrpc_proxy_finished_fn * finished,
+	void * user_data,
+	char const * method_name,
+	char const * param_info,
+	va_list args)
+{
+    wf_impl_jsonrpc_proxy_invoke_request(proxy, false, finished, user_data, method_name, param_info, args);
+}
+
+void wf_impl_jsonrpc_proxy_vinvoke_binary(
+	struct wf_jsonrpc_proxy * proxy,
+	wf_jsonrpc_proxy_finished_fn * finished,
+	void * user_data,
+	char const * method_name,
+	char const * param_info,
+	va_list args)
+{
+    wf_impl_jsonrpc_proxy_invoke_request(proxy, true, finished, user_data, method_name, param_info, args);
+}
+
 extern void wf_impl_jsonrpc_proxy_vnotify(
 	struct wf_jsonrpc_proxy * proxy,
 	char const * method_name,
 	char const * param_info,
 	va_list args)
 {
-    struct wf_message * request = wf_impl_jsonrpc_request_create(method_name, 0, param_info, args);
+    struct wf_message * request = wf_impl_jsonrpc_request_create(proxy, method_name, 0, param_info, args);
     proxy->send(request, proxy->user_data);
 }
 
@@ -153,3 +230,80 @@ void wf_impl_jsonrpc_proxy_onresult(
 
     wf_impl_jsonrpc_response_cleanup(&response);
 }
+
+static uint32_t
+wf_impl_jsonrpc_proxy_get_uint32(
+    char const * data)
+{
+    unsigned char const * value = (unsigned char const *) data;
+
+    return (((uint32_t) value[0]) << 24) | (((uint32_t) value[1]) << 16)
+        | (((uint32_t) value[2]) << 8) | ((uint32_t) value[3]);
+}
+
+static char const *
+wf_impl_jsonrpc_proxy_get_binary_format(
+    unsigned char format)
+{
+    switch (format)
+    {
+        case WF_JSONRPC_PROXY_BINARY_FORMAT_IDENTITY:
+            return "identity";
+        case WF_JSONRPC_PROXY_BINARY_FORMAT_DEFLATE:
+            return "deflate";
+        default:
+            return NULL;
+    }
+}
+
+void wf_impl_jsonrpc_proxy_onbinary(
+    struct wf_jsonrpc_proxy * proxy,
+    char * data,
+    size_t length)
+{
+    if (WF_JSONRPC_PROXY_BINARY_HEADER_SIZE > length) { return; }
+
+    uint32_t const id = wf_impl_jsonrpc_proxy_get_uint32(&data[WF_JSONRPC_PROXY_BINARY_ID_OFFSET]);
+    uint32_t const count = wf_impl_jsonrpc_proxy_get_uint32(&data[WF_JSONRPC_PROXY_BINARY_COUNT_OFFSET]);
+    char const * format = wf_impl_jsonrpc_proxy_get_binary_format(
+        (unsigned char) data[WF_JSONRPC_PROXY_BINARY_FORMAT_OFFSET]);
+
+    struct wf_json_object_item items[3];
+    items[0].key = "data";
+    items[0].json.type = WF_JSON_TYPE_STRING;
+    items[0].json.value.s.data = &data[WF_JSONRPC_PROXY_BINARY_HEADER_SIZE];
+    items[0].json.value.s.size = length - WF_JSONRPC_PROXY_BINARY_HEADER_SIZE;
+    items[1].key = "format";
+    items[1].json.type = WF_JSON_TYPE_STRING;
+    items[1].json.value.s.data = (char *) format;
+    items[1].json.value.s.size = (NULL != format) ? strlen(format) : 0;
+    items[2].key = "count";
+    items[2].json.type = WF_JSON_TYPE_INT;
+    items[2].json.value.i = count;
+
+    struct wf_json result;
+    result.type = WF_JSON_TYPE_OBJECT;
+    result.value.o.items = items;
+    result.value.o.size = 3;
+
+    struct wf_jsonrpc_response response;
+    response.id = (int) id;
+    response.result = &result;
+    response.error = NULL;
+
+    if (!wf_impl_jsonrpc_proxy_request_manager_accepts_binary(proxy->request_manager, response.id))
+    {
+        response.result = NULL;
+        response.error = wf_impl_jsonrpc_error(WF_BAD_FORMAT, "invalid format: unexpected binary result");
+    }
+    else if ((NULL == format) || (INT32_MAX < count))
+    {
+        response.result = NULL;
+        response.error = wf_impl_jsonrpc_error(WF_BAD_FORMAT, "invalid format: unknown binary format");
+    }
+
+    wf_impl_jsonrpc_proxy_request_manager_finish_request(
+        proxy->request_manager, &response);
+
+    wf_impl_jsonrpc_response_cleanup(&response);
+}
@@ -13,6 +13,8 @@ using std::size_t;
 
 #include "webfuse/impl/jsonrpc/send_fn.h"
 #include "webfuse/impl/jsonrpc/proxy_finished_fn.h"
+#include "webfuse/impl/jsonrpc/proxy_window_fn.h"
+#include "webfuse/impl/jsonrpc/custom_write_fn.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,13 +22,8 @@ extern "C" {
 
 struct wf_jsonrpc_proxy;
 struct wf_timer_manager;
-struct wf_json_writer;
 struct wf_json;
-
-typedef void
-wf_jsonrpc_custom_write_fn(
-	struct wf_json_writer * writer,
-	void * data);
+struct wf_message_pool;
 
 extern struct wf_jsonrpc_proxy *
 wf_impl_jsonrpc_proxy_create(
@@ -38,6 +35,42 @@ wf_impl_jsonrpc_proxy_create(
 extern void wf_impl_jsonrpc_proxy_dispose(
     struct wf_jsonrpc_proxy * proxy);
 
+//------------------------------------------------------------------------------
+/// \brief Sets the window of pending requests.
+///
+/// The window does not limit the number of requests; instead on_window is
+/// invoked with is_full set to true, when the number of pending requests
+/// reaches the window, and with is_full set to false, when it falls below
+/// the window again. Callers use it to stop producing requests.
+///
+/// \param proxy pointer to proxy instance
+/// \param window maximum number of pending requests; 0 disables the window
+/// \param on_window function to invoke when window gets full or free
+/// \param user_data user data of on_window
+//------------------------------------------------------------------------------
+extern void wf_impl_jsonrpc_proxy_set_window(
+    struct wf_jsonrpc_proxy * proxy,
+    size_t window,
+    wf_jsonrpc_proxy_window_fn * on_window,
+    void * user_data);
+
+extern size_t wf_impl_jsonrpc_proxy_pending_requests(
+    struct wf_jsonrpc_proxy * proxy);
+
+//------------------------------------------------------------------------------
+/// \brief Sets the pool, requests are allocated from.
+///
+/// Requests are returned to the pool when they are disposed after sending,
+/// so the pool must outlive all requests. Without pool, each request is
+/// allocated separately.
+///
+/// \param proxy pointer to proxy instance
+/// \param pool pool of messages (may be NULL)
+//------------------------------------------------------------------------------
+extern void wf_impl_jsonrpc_proxy_set_message_pool(
+    struct wf_jsonrpc_proxy * proxy,
+    struct wf_message_pool * pool);
+
 //------------------------------------------------------------------------------
 /// \brief Invokes a method.
 ///
@@ -49,7 +82,7 @@ extern void wf_impl_jsonrpc_proxy_dispose(
 /// \param finished function which is called exactly once, either on success or
 ///                 on failure.
 /// \param method_name name of the method to invoke
-/// \param param_info types of the param (s = string, i = integer, j = json)
+/// \param param_info types of the param (s = string, i = integer, I = 64-bit integer, j = json)
 /// \param ... params
 //------------------------------------------------------------------------------
 extern void wf_impl_jsonrpc_proxy_invoke(
@@ -61,6 +94,21 @@ extern void wf_impl_jsonrpc_proxy_invoke(
 	...
 );
 
+//------------------------------------------------------------------------------
+/// \brief Invokes a method, which may be answered by a binary message.
+///
+/// Same as wf_impl_jsonrpc_proxy_invoke, but the provider may also send
+/// the result as binary message (see wf_impl_jsonrpc_proxy_onbinary).
+//------------------------------------------------------------------------------
+extern void wf_impl_jsonrpc_proxy_invoke_binary(
+	struct wf_jsonrpc_proxy * proxy,
+	wf_jsonrpc_proxy_finished_fn * finished,
+	void * user_data,
+	char const * method_name,
+	char const * param_info,
+	...
+);
+
 extern void wf_impl_jsonrpc_proxy_notify(
 	struct wf_jsonrpc_proxy * proxy,
 	char const * method_name,
@@ -72,6 +120,29 @@ extern void wf_impl_jsonrpc_proxy_onresult(
     struct wf_jsonrpc_proxy * proxy,
     struct wf_json const * message);
 
+//------------------------------------------------------------------------------
+/// \brief Processes a binary result.
+///
+/// Binary results are used by providers to answer read requests without
+/// JSON and base64 overhead. The message starts with a header containing
+/// the id of the request, the number of bytes read and the format of the
+/// payload, followed by the payload itself.
+///
+/// The pending request is finished with a result object containing the
+/// members "data", "format" and "count", just like a JSON read result.
+/// Data is not copied; it refers to the memory of the message.
+/// Pending requests not invoked by wf_impl_jsonrpc_proxy_invoke_binary
+/// are finished with an error.
+///
+/// \param proxy pointer to proxy instance
+/// \param data binary message (modifiable)
+/// \param length length of the message in bytes
+//------------------------------------------------------------------------------
+extern void wf_impl_jsonrpc_proxy_onbinary(
+    struct wf_jsonrpc_proxy * proxy,
+    char * data,
+    size_t length);
+
 #ifdef __cplusplus
 }
 #endif
@@ -17,6 +17,8 @@ struct wf_jsonrpc_proxy
     struct wf_jsonrpc_proxy_request_manager * request_manager;
     wf_jsonrpc_send_fn * send;
     void * user_data;
+    struct wf_json_writer * writer;
+    struct wf_message_pool * message_pool;
 };
 
 extern void 
@@ -39,6 +41,14 @@ extern void wf_impl_jsonrpc_proxy_vinvoke(
 	char const * param_info,
 	va_list args);
 
+extern void wf_impl_jsonrpc_proxy_vinvoke_binary(
+	struct wf_jsonrpc_proxy * proxy,
+	wf_jsonrpc_proxy_finished_fn * finished,
+	void * user_data,
+	char const * method_name,
+	char const * param_info,
+	va_list args);
+
 extern void wf_impl_jsonrpc_proxy_vnotify(
 	struct wf_jsonrpc_proxy * proxy,
 	char const * method_name,
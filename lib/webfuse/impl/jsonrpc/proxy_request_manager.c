@@ -3,20 +3,24 @@
 #include "webfuse/impl/timer/timer.h"
 #include "webfuse/impl/jsonrpc/response_intern.h"
 #include "webfuse/impl/jsonrpc/error.h"
+#include "webfuse/impl/util/hashmap.h"
+#include "webfuse/impl/util/container_of.h"
 
 #include <stdlib.h>
+#include <stdbool.h>
 #include <limits.h>
 
 struct wf_timer;
 
 struct wf_jsonrpc_proxy_request
 {
+    struct wf_hashmap_item item;
     struct wf_jsonrpc_proxy_request_manager * manager;
     int id;
     wf_jsonrpc_proxy_finished_fn * finished;
     void * user_data;
     struct wf_timer * timer;
-    struct wf_jsonrpc_proxy_request * next;
+    bool accepts_binary;
 };
 
 struct wf_jsonrpc_proxy_request_manager
@@ -24,9 +28,41 @@ struct wf_jsonrpc_proxy_request_manager
     struct wf_timer_manager * timer_manager;
     int timeout;
     int id;
-    struct wf_jsonrpc_proxy_request * requests;
+    struct wf_hashmap requests;
+    size_t window;
+    wf_jsonrpc_proxy_window_fn * on_window;
+    void * window_user_data;
 };
 
+static void
+wf_impl_jsonrpc_proxy_request_manager_notify(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    bool is_full)
+{
+    if (NULL != manager->on_window)
+    {
+        manager->on_window(manager->window_user_data, is_full);
+    }
+}
+
+// the window callback is invoked only when the window becomes full or
+// gets room again, not for each request
+static void
+wf_impl_jsonrpc_proxy_request_manager_remove(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    struct wf_jsonrpc_proxy_request * request)
+{
+    wf_impl_hashmap_remove(&manager->requests, request->item.key);
+    wf_impl_timer_cancel(request->timer);
+    wf_impl_timer_dispose(request->timer);
+    free(request);
+
+    if ((0 < manager->window) && ((manager->window - 1) == manager->requests.size))
+    {
+        wf_impl_jsonrpc_proxy_request_manager_notify(manager, false);
+    }
+}
+
 static void
 wf_impl_jsonrpc_proxy_request_on_timeout(
     struct wf_timer * timer,
@@ -41,19 +77,32 @@ wf_impl_jsonrpc_proxy_request_on_timeout(
         "Timeout");
 }
 
+static struct wf_jsonrpc_proxy_request *
+wf_impl_jsonrpc_proxy_request_manager_get(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    int id)
+{
+    struct wf_hashmap_item * item = wf_impl_hashmap_get(&manager->requests, (uint64_t) id);
+    return (NULL != item) ? wf_container_of(item, struct wf_jsonrpc_proxy_request, item) : NULL;
+}
+
 static int
 wf_impl_jsonrpc_proxy_request_manager_next_id(
     struct wf_jsonrpc_proxy_request_manager * manager)
 {
-    if (manager->id < INT_MAX)
+    // skip ids of requests still pending after wrap around
+    do
     {
-        manager->id++;
-    }
-    else
-    {
-        manager->id = 1;
-    }
-    
+        if (manager->id < INT_MAX)
+        {
+            manager->id++;
+        }
+        else
+        {
+            manager->id = 1;
+        }
+    } while (NULL != wf_impl_jsonrpc_proxy_request_manager_get(manager, manager->id));
+
     return manager->id;
 }
 
@@ -67,29 +116,49 @@ wf_impl_jsonrpc_proxy_request_manager_create(
     manager->id = 1;
     manager->timer_manager = timer_manager;
     manager->timeout = timeout;
-    manager->requests = NULL;
+    wf_impl_hashmap_init(&manager->requests);
+    manager->window = 0;
+    manager->on_window = NULL;
+    manager->window_user_data = NULL;
 
     return manager;
 }
 
+// callbacks may add requests and thereby grow the map; therefore pending
+// requests are detached from the manager, before their callbacks are invoked
 void
 wf_impl_jsonrpc_proxy_request_manager_dispose(
     struct wf_jsonrpc_proxy_request_manager * manager)
 {
-    struct wf_jsonrpc_proxy_request * request = manager->requests;
-    while (NULL != request)
+    while (0 < manager->requests.size)
     {
-        struct wf_jsonrpc_proxy_request * next = request->next;
-
-        wf_impl_jsonrpc_propate_error(
-            request->finished, request->user_data,
-            WF_BAD, "Bad: cancelled pending request during shutdown");
-        wf_impl_timer_cancel(request->timer);
-        wf_impl_timer_dispose(request->timer);
-        free(request);
-        request = next;
+        struct wf_hashmap requests = manager->requests;
+        wf_impl_hashmap_init(&manager->requests);
+
+        for (size_t i = 0; i < requests.capacity; i++)
+        {
+            while (NULL != requests.buckets[i])
+            {
+                struct wf_hashmap_item * item = requests.buckets[i];
+                requests.buckets[i] = item->next;
+
+                struct wf_jsonrpc_proxy_request * request = wf_container_of(item, struct wf_jsonrpc_proxy_request, item);
+                wf_jsonrpc_proxy_finished_fn * finished = request->finished;
+                void * user_data = request->user_data;
+                wf_impl_timer_cancel(request->timer);
+                wf_impl_timer_dispose(request->timer);
+                free(request);
+
+                wf_impl_jsonrpc_propate_error(
+                    finished, user_data,
+                    WF_BAD, "Bad: cancelled pending request during shutdown");
+            }
+        }
+
+        wf_impl_hashmap_cleanup(&requests);
     }
-    
+
+    wf_impl_hashmap_cleanup(&manager->requests);
     free(manager);
 }
 
@@ -103,17 +172,62 @@ wf_impl_jsonrpc_proxy_request_manager_add_request(
     request->finished = finished;
     request->user_data = user_data;
     request->manager = manager;
+    request->accepts_binary = false;
     request->id = wf_impl_jsonrpc_proxy_request_manager_next_id(manager);
     request->timer = wf_impl_timer_create(manager->timer_manager,
         &wf_impl_jsonrpc_proxy_request_on_timeout ,request);
     wf_impl_timer_start(request->timer, manager->timeout);
 
-    request->next = manager->requests;
-    manager->requests = request;
+    wf_impl_hashmap_add(&manager->requests, &request->item, (uint64_t) request->id);
+
+    if ((0 < manager->window) && (manager->window == manager->requests.size))
+    {
+        wf_impl_jsonrpc_proxy_request_manager_notify(manager, true);
+    }
 
     return request->id;
 }
 
+void
+wf_impl_jsonrpc_proxy_request_manager_accept_binary(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    int id)
+{
+    struct wf_jsonrpc_proxy_request * request = wf_impl_jsonrpc_proxy_request_manager_get(manager, id);
+    if (NULL != request)
+    {
+        request->accepts_binary = true;
+    }
+}
+
+bool
+wf_impl_jsonrpc_proxy_request_manager_accepts_binary(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    int id)
+{
+    struct wf_jsonrpc_proxy_request * request = wf_impl_jsonrpc_proxy_request_manager_get(manager, id);
+    return (NULL != request) && (request->accepts_binary);
+}
+
+void
+wf_impl_jsonrpc_proxy_request_manager_set_window(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    size_t window,
+    wf_jsonrpc_proxy_window_fn * on_window,
+    void * user_data)
+{
+    manager->window = window;
+    manager->on_window = on_window;
+    manager->window_user_data = user_data;
+}
+
+size_t
+wf_impl_jsonrpc_proxy_request_manager_count(
+    struct wf_jsonrpc_proxy_request_manager * manager)
+{
+    return manager->requests.size;
+}
+
 void
 wf_impl_jsonrpc_proxy_request_manager_cancel_request(
     struct wf_jsonrpc_proxy_request_manager * manager,
@@ -121,33 +235,14 @@ wf_impl_jsonrpc_proxy_request_manager_cancel_request(
     int error_code,
     char const * error_message)
 {
-    struct wf_jsonrpc_proxy_request * prev = NULL;
-    struct wf_jsonrpc_proxy_request * request = manager->requests;
-    while (request != NULL)
+    struct wf_jsonrpc_proxy_request * request = wf_impl_jsonrpc_proxy_request_manager_get(manager, id);
+    if (NULL != request)
     {
-        struct wf_jsonrpc_proxy_request * next = request->next;
-        if (id == request->id)
-        {
-            wf_impl_jsonrpc_propate_error(
-                request->finished, request->user_data,
-                error_code, error_message);
-            wf_impl_timer_cancel(request->timer);
-            wf_impl_timer_dispose(request->timer);
-            free(request);
-            
-            if (NULL != prev)
-            {
-                prev->next = next;
-            }
-            else
-            {
-                manager->requests = next;
-            }
-            break;
-        }
+        wf_jsonrpc_proxy_finished_fn * finished = request->finished;
+        void * user_data = request->user_data;
+        wf_impl_jsonrpc_proxy_request_manager_remove(manager, request);
 
-        prev = request;
-        request = next;
+        wf_impl_jsonrpc_propate_error(finished, user_data, error_code, error_message);
     }
 }
 
@@ -156,34 +251,13 @@ wf_impl_jsonrpc_proxy_request_manager_finish_request(
     struct wf_jsonrpc_proxy_request_manager * manager,
     struct wf_jsonrpc_response * response)
 {
-    struct wf_jsonrpc_proxy_request * prev = NULL;
-    struct wf_jsonrpc_proxy_request * request = manager->requests;
-    while (request != NULL)
+    struct wf_jsonrpc_proxy_request * request = wf_impl_jsonrpc_proxy_request_manager_get(manager, response->id);
+    if (NULL != request)
     {
-        struct wf_jsonrpc_proxy_request * next = request->next;
-        if (response->id == request->id)
-        {
-            wf_jsonrpc_proxy_finished_fn * finished = request->finished;
-            void * user_data = request->user_data;
-
-            wf_impl_timer_cancel(request->timer);
-            wf_impl_timer_dispose(request->timer);
-            free(request);
-            
-            if (NULL != prev)
-            {
-                prev->next = next;
-            }
-            else
-            {
-                manager->requests = next;
-            }
-
-            finished(user_data, response->result, response->error);
-            break;
-        }
+        wf_jsonrpc_proxy_finished_fn * finished = request->finished;
+        void * user_data = request->user_data;
+        wf_impl_jsonrpc_proxy_request_manager_remove(manager, request);
 
-        prev = request;
-        request = next;
+        finished(user_data, response->result, response->error);
     }
 }
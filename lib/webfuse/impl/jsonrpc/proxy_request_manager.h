@@ -2,6 +2,15 @@
 #define WF_IMPL_JSONRPC_PROXY_REQUEST_MANAGER_H
 
 #include "webfuse/impl/jsonrpc/proxy_finished_fn.h"
+#include "webfuse/impl/jsonrpc/proxy_window_fn.h"
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <stdbool.h>
+#else
+#include <cstddef>
+using std::size_t;
+#endif
 
 #ifdef __cplusplus
 extern "C"
@@ -27,6 +36,27 @@ wf_impl_jsonrpc_proxy_request_manager_add_request(
     wf_jsonrpc_proxy_finished_fn * finished,
     void * user_data);
 
+extern void
+wf_impl_jsonrpc_proxy_request_manager_accept_binary(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    int id);
+
+extern bool
+wf_impl_jsonrpc_proxy_request_manager_accepts_binary(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    int id);
+
+extern void
+wf_impl_jsonrpc_proxy_request_manager_set_window(
+    struct wf_jsonrpc_proxy_request_manager * manager,
+    size_t window,
+    wf_jsonrpc_proxy_window_fn * on_window,
+    void * user_data);
+
+extern size_t
+wf_impl_jsonrpc_proxy_request_manager_count(
+    struct wf_jsonrpc_proxy_request_manager * manager);
+
 extern void
 wf_impl_jsonrpc_proxy_request_manager_cancel_request(
     struct wf_jsonrpc_proxy_request_manager * manager,
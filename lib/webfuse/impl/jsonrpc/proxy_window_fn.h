@@ -0,0 +1,21 @@
+#ifndef WF_IMPL_JSONRPC_PROXY_WINDOW_FN_H
+#define WF_IMPL_JSONRPC_PROXY_WINDOW_FN_H
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef void wf_jsonrpc_proxy_window_fn(
+	void * user_data,
+    bool is_full);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -65,3 +65,14 @@ wf_impl_jsonrpc_response_add_string(
 {
     wf_impl_json_write_object_string(writer->json_writer, key, value);
 }
+
+void
+wf_impl_jsonrpc_response_add_custom(
+    struct wf_jsonrpc_response_writer * writer,
+    char const * key,
+    wf_jsonrpc_custom_write_fn * write,
+    void * data)
+{
+    wf_impl_json_write_object_key(writer->json_writer, key);
+    write(writer->json_writer, data);
+}
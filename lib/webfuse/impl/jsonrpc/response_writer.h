@@ -1,6 +1,8 @@
 #ifndef WF_IMPL_JSONRPC_RESPONSE_WRITER_H
 #define WF_IMPL_JSONRPC_RESPONSE_WRITER_H
 
+#include "webfuse/impl/jsonrpc/custom_write_fn.h"
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -32,6 +34,12 @@ wf_impl_jsonrpc_response_add_string(
     char const * key,
     char const * value);
 
+extern void
+wf_impl_jsonrpc_response_add_custom(
+    struct wf_jsonrpc_response_writer * writer,
+    char const * key,
+    wf_jsonrpc_custom_write_fn * write,
+    void * data);
 
 #ifdef __cplusplus
 }
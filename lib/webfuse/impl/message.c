@@ -1,4 +1,5 @@
 #include "webfuse/impl/message.h"
+#include "webfuse/impl/message_pool.h"
 
 #include <stdlib.h>
 #include <libwebsockets.h>
@@ -11,6 +12,8 @@ wf_impl_message_create(
     struct wf_message * message = malloc(sizeof(struct wf_message));
     message->data = data;
     message->length = length;
+    message->capacity = length;
+    message->pool = NULL;
 
     return message;
 }
@@ -19,6 +22,12 @@ void
 wf_impl_message_dispose(
     struct wf_message * message)
 {
+    if (NULL != message->pool)
+    {
+        wf_impl_message_pool_put(message->pool, message);
+        return;
+    }
+
     char * raw_data = message->data - LWS_PRE;
     free(raw_data);
     free(message);    
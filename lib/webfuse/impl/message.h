@@ -10,11 +10,17 @@ using std::size_t;
 
 #include "webfuse/impl/util/slist.h"
 
+struct wf_message_pool;
+
+// data is prefixed by LWS_PRE bytes; capacity is the size of the buffer
+// behind data, pool is the pool the message is returned to on dispose
 struct wf_message
 {
     struct wf_slist_item item;
     char * data;
     size_t length;
+    size_t capacity;
+    struct wf_message_pool * pool;
 };
 
 #ifdef __cplusplus
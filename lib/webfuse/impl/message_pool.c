@@ -0,0 +1,118 @@
+#include "webfuse/impl/message_pool.h"
+#include "webfuse/impl/message.h"
+#include "webfuse/impl/util/container_of.h"
+
+#include <stdlib.h>
+#include <libwebsockets.h>
+
+#define WF_IMPL_MESSAGE_POOL_MAX_SIZE \
+    (((size_t) WF_IMPL_MESSAGE_POOL_MIN_SIZE) << (WF_IMPL_MESSAGE_POOL_CLASS_COUNT - 1))
+
+// returns the smallest class providing capacity bytes
+static size_t
+wf_impl_message_pool_get_class(
+    size_t capacity)
+{
+    size_t index = 0;
+    size_t size = WF_IMPL_MESSAGE_POOL_MIN_SIZE;
+    while (size < capacity)
+    {
+        size *= 2;
+        index++;
+    }
+
+    return index;
+}
+
+static void
+wf_impl_message_pool_free(
+    struct wf_message * message)
+{
+    free(message->data - LWS_PRE);
+    free(message);
+}
+
+void
+wf_impl_message_pool_init(
+    struct wf_message_pool * pool)
+{
+    for (size_t i = 0; i < WF_IMPL_MESSAGE_POOL_CLASS_COUNT; i++)
+    {
+        pool->free[i] = NULL;
+        pool->free_count[i] = 0;
+    }
+}
+
+void
+wf_impl_message_pool_cleanup(
+    struct wf_message_pool * pool)
+{
+    for (size_t i = 0; i < WF_IMPL_MESSAGE_POOL_CLASS_COUNT; i++)
+    {
+        struct wf_slist_item * item = pool->free[i];
+        while (NULL != item)
+        {
+            struct wf_slist_item * next = item->next;
+            wf_impl_message_pool_free(wf_container_of(item, struct wf_message, item));
+            item = next;
+        }
+
+        pool->free[i] = NULL;
+        pool->free_count[i] = 0;
+    }
+}
+
+struct wf_message *
+wf_impl_message_pool_get(
+    struct wf_message_pool * pool,
+    size_t capacity)
+{
+    size_t size = capacity;
+    if (capacity <= WF_IMPL_MESSAGE_POOL_MAX_SIZE)
+    {
+        size_t const index = wf_impl_message_pool_get_class(capacity);
+        if ((NULL != pool) && (NULL != pool->free[index]))
+        {
+            struct wf_slist_item * item = pool->free[index];
+            pool->free[index] = item->next;
+            pool->free_count[index]--;
+
+            struct wf_message * message = wf_container_of(item, struct wf_message, item);
+            message->item.next = NULL;
+            message->length = 0;
+            return message;
+        }
+
+        size = ((size_t) WF_IMPL_MESSAGE_POOL_MIN_SIZE) << index;
+    }
+
+    char * raw_data = malloc(LWS_PRE + size);
+    struct wf_message * message = wf_impl_message_create(&raw_data[LWS_PRE], 0);
+    message->capacity = size;
+    message->pool = pool;
+
+    return message;
+}
+
+void
+wf_impl_message_pool_put(
+    struct wf_message_pool * pool,
+    struct wf_message * message)
+{
+    // buffers grown by a writer are pooled as long as they match a class
+    size_t const capacity = message->capacity;
+    if (capacity <= WF_IMPL_MESSAGE_POOL_MAX_SIZE)
+    {
+        size_t const index = wf_impl_message_pool_get_class(capacity);
+        if ((capacity == (((size_t) WF_IMPL_MESSAGE_POOL_MIN_SIZE) << index)) &&
+            (pool->free_count[index] < WF_IMPL_MESSAGE_POOL_MAX_FREE))
+        {
+            message->item.next = pool->free[index];
+            pool->free[index] = &message->item;
+            pool->free_count[index]++;
+            return;
+        }
+    }
+
+    wf_impl_message_pool_free(message);
+}
@@ -0,0 +1,60 @@
+#ifndef WF_IMPL_MESSAGE_POOL_H
+#define WF_IMPL_MESSAGE_POOL_H
+
+#ifndef __cplusplus
+#include <stddef.h>
+#else
+#include <cstddef>
+using std::size_t;
+#endif
+
+#define WF_IMPL_MESSAGE_POOL_MIN_SIZE 512
+#define WF_IMPL_MESSAGE_POOL_CLASS_COUNT 8
+#define WF_IMPL_MESSAGE_POOL_MAX_FREE 32
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct wf_message;
+struct wf_slist_item;
+
+// Recycles messages along with their LWS_PRE-prefixed buffers.
+//
+// Buffers are sized by power-of-two classes from 512 bytes to 64 KiB;
+// larger buffers are not pooled. Disposed messages return to the pool
+// they were taken from, so the pool must outlive its messages.
+
+struct wf_message_pool
+{
+    struct wf_slist_item * free[WF_IMPL_MESSAGE_POOL_CLASS_COUNT];
+    size_t free_count[WF_IMPL_MESSAGE_POOL_CLASS_COUNT];
+};
+
+extern void
+wf_impl_message_pool_init(
+    struct wf_message_pool * pool);
+
+extern void
+wf_impl_message_pool_cleanup(
+    struct wf_message_pool * pool);
+
+// Returns an empty message with room for at least capacity bytes.
+// Without pool (NULL), the message is allocated and freed on dispose.
+extern struct wf_message *
+wf_impl_message_pool_get(
+    struct wf_message_pool * pool,
+    size_t capacity);
+
+// Called by wf_impl_message_dispose for pooled messages.
+extern void
+wf_impl_message_pool_put(
+    struct wf_message_pool * pool,
+    struct wf_message * message);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
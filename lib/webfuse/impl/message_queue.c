@@ -1,7 +1,12 @@
 #include "webfuse/impl/message_queue.h"
 #include "webfuse/impl/message.h"
+#include "webfuse/impl/message_pool.h"
 #include "webfuse/impl/util/container_of.h"
 
+#include <stdlib.h>
+#include <string.h>
+#include <libwebsockets.h>
+
 void wf_impl_message_queue_cleanup(
     struct wf_slist * queue)
 {
@@ -15,3 +20,88 @@ void wf_impl_message_queue_cleanup(
     }
     wf_impl_slist_init(queue);
 }
+
+struct wf_message * wf_impl_message_queue_take_batch(
+    struct wf_slist * queue,
+    size_t max_size)
+{
+    if (wf_impl_slist_empty(queue)) { return NULL; }
+
+    struct wf_slist_item * item = wf_impl_slist_first(queue);
+    struct wf_message * first = wf_container_of(item, struct wf_message, item);
+
+    // brackets and separating commas
+    size_t length = first->length + 2;
+    size_t count = 1;
+    item = item->next;
+    while (NULL != item)
+    {
+        struct wf_message * message = wf_container_of(item, struct wf_message, item);
+        if (max_size < (length + message->length + 1)) { break; }
+
+        length += message->length + 1;
+        count++;
+        item = item->next;
+    }
+
+    if (1 == count)
+    {
+        wf_impl_slist_remove_first(queue);
+        return first;
+    }
+
+    // batches are taken from the pool of the first message (if any)
+    struct wf_message * batch = wf_impl_message_pool_get(first->pool, length);
+    char * data = batch->data;
+    size_t position = 0;
+    data[position++] = '[';
+    for(size_t i = 0; i < count; i++)
+    {
+        item = wf_impl_slist_remove_first(queue);
+        struct wf_message * message = wf_container_of(item, struct wf_message, item);
+        if (0 < i)
+        {
+            data[position++] = ',';
+        }
+        memcpy(&data[position], message->data, message->length);
+        position += message->length;
+        wf_impl_message_dispose(message);
+    }
+    data[position] = ']';
+    batch->length = length;
+
+    return batch;
+}
+
+void wf_impl_message_queue_write(
+    struct wf_slist * queue,
+    struct lws * wsi,
+    size_t batch_size,
+    size_t budget)
+{
+    size_t written = 0;
+    while ((!wf_impl_slist_empty(queue)) && (written < budget) && (!lws_send_pipe_choked(wsi)))
+    {
+        struct wf_message * message;
+        if (0 < batch_size)
+        {
+            message = wf_impl_message_queue_take_batch(queue, batch_size);
+        }
+        else
+        {
+            struct wf_slist_item * item = wf_impl_slist_remove_first(queue);
+            message = wf_container_of(item, struct wf_message, item);
+        }
+
+        int const result = lws_write(wsi, (unsigned char*) message->data, message->length, LWS_WRITE_TEXT);
+        written += message->length;
+        wf_impl_message_dispose(message);
+
+        if (0 > result) { return; }
+    }
+
+    if (!wf_impl_slist_empty(queue))
+    {
+        lws_callback_on_writable(wsi);
+    }
+}
@@ -1,16 +1,46 @@
 #ifndef WF_IMPL_MESSAGE_QUEUE_H
 #define WF_IMPL_MESSAGE_QUEUE_H
 
+#ifndef __cplusplus
+#include <stddef.h>
+#else
+#include <cstddef>
+using std::size_t;
+#endif
+
+#define WF_IMPL_MESSAGE_QUEUE_DEFAULT_WRITE_BUDGET (64 * 1024)
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
 struct wf_slist;
+struct wf_message;
+struct lws;
 
 extern void wf_impl_message_queue_cleanup(
     struct wf_slist * queue);
 
+// Removes the first message of the queue and packs it along with
+// subsequent messages into a JSON-RPC batch array, as long as the
+// batch does not exceed max_size.
+// A single message is returned as is.
+// Returns NULL if the queue is empty.
+extern struct wf_message * wf_impl_message_queue_take_batch(
+    struct wf_slist * queue,
+    size_t max_size);
+
+// Writes queued messages to wsi, until the queue is empty, budget bytes
+// are written or the connection is choked.
+// If batch_size is not 0, messages are packed into batches.
+// Requests another writable callback, if messages remain.
+extern void wf_impl_message_queue_write(
+    struct wf_slist * queue,
+    struct lws * wsi,
+    size_t batch_size,
+    size_t budget);
+
 
 #ifdef __cplusplus
 }
@@ -1,13 +1,25 @@
 #include "webfuse/impl/mountpoint.h"
 
 #include <stdlib.h>
+#include <stdbool.h>
 #include <string.h>
 
+#define WF_MOUNTPOINT_DEFAULT_ATTR_TIMEOUT 1.0
+#define WF_MOUNTPOINT_DEFAULT_ENTRY_TIMEOUT 1.0
+#define WF_MOUNTPOINT_DEFAULT_NEGATIVE_TIMEOUT 0.0
+
 struct wf_mountpoint
 {
     char * path;
     void * user_data;
     wf_mountpoint_userdata_dispose_fn * dispose;
+    size_t readahead;
+    size_t cache_size;
+    bool has_cache_size;
+    size_t direct_io_threshold;
+    double attr_timeout;
+    double entry_timeout;
+    double negative_timeout;
 };
 
 struct wf_mountpoint *
@@ -18,6 +30,13 @@ wf_impl_mountpoint_create(
     mountpoint->path = strdup(path);
     mountpoint->user_data = NULL;
     mountpoint->dispose = NULL;
+    mountpoint->readahead = 0;
+    mountpoint->cache_size = 0;
+    mountpoint->has_cache_size = false;
+    mountpoint->direct_io_threshold = 0;
+    mountpoint->attr_timeout = WF_MOUNTPOINT_DEFAULT_ATTR_TIMEOUT;
+    mountpoint->entry_timeout = WF_MOUNTPOINT_DEFAULT_ENTRY_TIMEOUT;
+    mountpoint->negative_timeout = WF_MOUNTPOINT_DEFAULT_NEGATIVE_TIMEOUT;
 
     return mountpoint;
 }
@@ -51,3 +70,101 @@ wf_impl_mountpoint_set_userdata(
     mountpoint->user_data = user_data;
     mountpoint->dispose = dispose;
 }
+
+void
+wf_impl_mountpoint_set_readahead(
+    struct wf_mountpoint * mountpoint,
+    size_t size)
+{
+    mountpoint->readahead = size;
+}
+
+size_t
+wf_impl_mountpoint_get_readahead(
+    struct wf_mountpoint const * mountpoint)
+{
+    return mountpoint->readahead;
+}
+
+void
+wf_impl_mountpoint_set_cache_size(
+    struct wf_mountpoint * mountpoint,
+    size_t size)
+{
+    mountpoint->cache_size = size;
+    mountpoint->has_cache_size = true;
+}
+
+size_t
+wf_impl_mountpoint_get_cache_size(
+    struct wf_mountpoint const * mountpoint)
+{
+    return mountpoint->cache_size;
+}
+
+bool
+wf_impl_mountpoint_has_cache_size(
+    struct wf_mountpoint const * mountpoint)
+{
+    return mountpoint->has_cache_size;
+}
+
+void
+wf_impl_mountpoint_set_direct_io_threshold(
+    struct wf_mountpoint * mountpoint,
+    size_t size)
+{
+    mountpoint->direct_io_threshold = size;
+}
+
+size_t
+wf_impl_mountpoint_get_direct_io_threshold(
+    struct wf_mountpoint const * mountpoint)
+{
+    return mountpoint->direct_io_threshold;
+}
+
+void
+wf_impl_mountpoint_set_attr_timeout(
+    struct wf_mountpoint * mountpoint,
+    double timeout)
+{
+    mountpoint->attr_timeout = timeout;
+}
+
+double
+wf_impl_mountpoint_get_attr_timeout(
+    struct wf_mountpoint const * mountpoint)
+{
+    return mountpoint->attr_timeout;
+}
+
+void
+wf_impl_mountpoint_set_entry_timeout(
+    struct wf_mountpoint * mountpoint,
+    double timeout)
+{
+    mountpoint->entry_timeout = timeout;
+}
+
+double
+wf_impl_mountpoint_get_entry_timeout(
+    struct wf_mountpoint const * mountpoint)
+{
+    return mountpoint->entry_timeout;
+}
+
+void
+wf_impl_mountpoint_set_negative_timeout(
+    struct wf_mountpoint * mountpoint,
+    double timeout)
+{
+    mountpoint->negative_timeout = timeout;
+}
+
+double
+wf_impl_mountpoint_get_negative_timeout(
+    struct wf_mountpoint const * mountpoint)
+{
+    return mountpoint->negative_timeout;
+}
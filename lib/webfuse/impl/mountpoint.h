@@ -3,6 +3,10 @@
 
 #include "webfuse/mountpoint.h"
 
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -26,6 +30,64 @@ wf_impl_mountpoint_set_userdata(
     void * user_data,
     wf_mountpoint_userdata_dispose_fn * dispose);
 
+extern void
+wf_impl_mountpoint_set_readahead(
+    struct wf_mountpoint * mountpoint,
+    size_t size);
+
+extern size_t
+wf_impl_mountpoint_get_readahead(
+    struct wf_mountpoint const * mountpoint);
+
+extern void
+wf_impl_mountpoint_set_cache_size(
+    struct wf_mountpoint * mountpoint,
+    size_t size);
+
+extern size_t
+wf_impl_mountpoint_get_cache_size(
+    struct wf_mountpoint const * mountpoint);
+
+extern bool
+wf_impl_mountpoint_has_cache_size(
+    struct wf_mountpoint const * mountpoint);
+
+extern void
+wf_impl_mountpoint_set_direct_io_threshold(
+    struct wf_mountpoint * mountpoint,
+    size_t size);
+
+extern size_t
+wf_impl_mountpoint_get_direct_io_threshold(
+    struct wf_mountpoint const * mountpoint);
+
+extern void
+wf_impl_mountpoint_set_attr_timeout(
+    struct wf_mountpoint * mountpoint,
+    double timeout);
+
+extern double
+wf_impl_mountpoint_get_attr_timeout(
+    struct wf_mountpoint const * mountpoint);
+
+extern void
+wf_impl_mountpoint_set_entry_timeout(
+    struct wf_mountpoint * mountpoint,
+    double timeout);
+
+extern double
+wf_impl_mountpoint_get_entry_timeout(
+    struct wf_mountpoint const * mountpoint);
+
+extern void
+wf_impl_mountpoint_set_negative_timeout(
+    struct wf_mountpoint * mountpoint,
+    double timeout);
+
+extern double
+wf_impl_mountpoint_get_negative_timeout(
+    struct wf_mountpoint const * mountpoint);
+
 #ifdef __cplusplus
 }
 #endif
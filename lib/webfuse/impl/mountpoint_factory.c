@@ -1,4 +1,5 @@
 #include "webfuse/impl/mountpoint_factory.h"
+#include "webfuse/impl/mountpoint.h"
 #include <stddef.h>
 
 void
@@ -7,6 +8,7 @@ wf_impl_mountpoint_factory_init_default(
 {
     factory->create_mountpoint = NULL;
     factory->user_data = NULL;
+    factory->cache_size = 0;
 }
 
 void
@@ -17,6 +19,7 @@ wf_impl_mountpoint_factory_init(
 {
     factory->create_mountpoint = create_mountpoint;
     factory->user_data = user_data;
+    factory->cache_size = 0;
 }
 
 void
@@ -26,6 +29,7 @@ wf_impl_mountpoint_factory_clone(
 {
     other->create_mountpoint = factory->create_mountpoint;
     other->user_data = factory->user_data;
+    other->cache_size = factory->cache_size;
 }
 
 bool
@@ -42,6 +46,7 @@ wf_impl_mountpoint_factory_cleanup(
 
     factory->create_mountpoint = NULL;
     factory->user_data = NULL;
+    factory->cache_size = 0;
 }
 
 struct wf_mountpoint *
@@ -49,6 +54,20 @@ wf_impl_mountpoint_factory_create_mountpoint(
     struct wf_impl_mountpoint_factory * factory,
     char const * filesystem)
 {
-    return factory->create_mountpoint(filesystem, factory->user_data);
+    struct wf_mountpoint * mountpoint = factory->create_mountpoint(filesystem, factory->user_data);
+    if ((NULL != mountpoint) && (!wf_impl_mountpoint_has_cache_size(mountpoint)))
+    {
+        wf_impl_mountpoint_set_cache_size(mountpoint, factory->cache_size);
+    }
+
+    return mountpoint;
+}
+
+void
+wf_impl_mountpoint_factory_set_cache_size(
+    struct wf_impl_mountpoint_factory * factory,
+    size_t cache_size)
+{
+    factory->cache_size = cache_size;
 }
 
@@ -3,6 +3,7 @@
 
 #include "webfuse/mountpoint_factory.h"
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -13,6 +14,7 @@ struct wf_impl_mountpoint_factory
 {
     wf_create_mountpoint_fn * create_mountpoint;
     void * user_data;
+    size_t cache_size;
 };
 
 extern void
@@ -43,6 +45,11 @@ extern void
 wf_impl_mountpoint_factory_cleanup(
     struct wf_impl_mountpoint_factory * factory);
 
+extern void
+wf_impl_mountpoint_factory_set_cache_size(
+    struct wf_impl_mountpoint_factory * factory,
+    size_t cache_size);
+
 extern struct wf_mountpoint *
 wf_impl_mountpoint_factory_create_mountpoint(
     struct wf_impl_mountpoint_factory * factory,
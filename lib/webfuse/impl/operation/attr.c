@@ -0,0 +1,87 @@
+#include "webfuse/impl/operation/attr.h"
+
+#include <string.h>
+
+#define WF_IMPL_OPERATION_ATTR_FIELD(key, type, member) \
+    WF_JSON_FIELD(key, type, struct wf_impl_operation_attr, member)
+
+// order must match the WF_IMPL_OPERATION_ATTR_* bits
+static struct wf_json_field const wf_impl_operation_attr_fields[] =
+{
+    WF_IMPL_OPERATION_ATTR_FIELD("name"     , WF_JSON_TYPE_STRING, name),
+    WF_IMPL_OPERATION_ATTR_FIELD("type"     , WF_JSON_TYPE_STRING, type),
+    WF_IMPL_OPERATION_ATTR_FIELD("inode"    , WF_JSON_TYPE_INT   , inode),
+    WF_IMPL_OPERATION_ATTR_FIELD("mode"     , WF_JSON_TYPE_INT   , mode),
+    WF_IMPL_OPERATION_ATTR_FIELD("size"     , WF_JSON_TYPE_INT   , size),
+    WF_IMPL_OPERATION_ATTR_FIELD("atime"    , WF_JSON_TYPE_INT   , atime),
+    WF_IMPL_OPERATION_ATTR_FIELD("mtime"    , WF_JSON_TYPE_INT   , mtime),
+    WF_IMPL_OPERATION_ATTR_FIELD("ctime"    , WF_JSON_TYPE_INT   , ctime),
+    WF_IMPL_OPERATION_ATTR_FIELD("attr_ttl" , WF_JSON_TYPE_INT   , attr_ttl),
+    WF_IMPL_OPERATION_ATTR_FIELD("entry_ttl", WF_JSON_TYPE_INT   , entry_ttl)
+};
+
+#define WF_IMPL_OPERATION_ATTR_FIELD_COUNT \
+    (sizeof(wf_impl_operation_attr_fields) / sizeof(wf_impl_operation_attr_fields[0]))
+
+void
+wf_impl_operation_attr_decode(
+    struct wf_json const * json,
+    struct wf_impl_operation_attr * attr)
+{
+    memset(attr, 0, sizeof(struct wf_impl_operation_attr));
+    attr->attr_ttl = -1;
+    attr->entry_ttl = -1;
+
+    attr->fields = wf_impl_json_fields_decode(json,
+        wf_impl_operation_attr_fields, WF_IMPL_OPERATION_ATTR_FIELD_COUNT, attr);
+}
+
+bool
+wf_impl_operation_attr_has(
+    struct wf_impl_operation_attr const * attr,
+    uint32_t fields)
+{
+    return (fields == (attr->fields & fields));
+}
+
+mode_t
+wf_impl_operation_attr_get_type(
+    struct wf_impl_operation_attr const * attr)
+{
+    mode_t result = 0;
+    char const * type = attr->type.data;
+    if (NULL != type)
+    {
+        if (0 == strcmp("file", type))
+        {
+            result = S_IFREG;
+        }
+        else if (0 == strcmp("dir", type))
+        {
+            result = S_IFDIR;
+        }
+    }
+
+    return result;
+}
+
+void
+wf_impl_operation_attr_fill(
+    struct wf_impl_operation_attr const * attr,
+    struct stat * buffer)
+{
+    buffer->st_mode = (attr->mode & 0555) | wf_impl_operation_attr_get_type(attr);
+    buffer->st_nlink = 1;
+    buffer->st_size = attr->size;
+    buffer->st_atime = attr->atime;
+    buffer->st_mtime = attr->mtime;
+    buffer->st_ctime = attr->ctime;
+}
+
+double
+wf_impl_operation_attr_get_timeout(
+    int64_t ttl,
+    double default_value)
+{
+    return (0 <= ttl) ? (double) ttl : default_value;
+}
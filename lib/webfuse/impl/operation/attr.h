@@ -0,0 +1,82 @@
+#ifndef WF_ADAPTER_IMPL_OPERATION_ATTR_H
+#define WF_ADAPTER_IMPL_OPERATION_ATTR_H
+
+#include "webfuse/impl/json/fields.h"
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#include <stdint.h>
+#else
+#include <cstdint>
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Attributes of a file system entry, as returned by lookup, getattr and
+// extended readdir entries. All members are decoded in a single pass over
+// the result object; fields tells which of them were present.
+
+#define WF_IMPL_OPERATION_ATTR_NAME      (1u << 0)
+#define WF_IMPL_OPERATION_ATTR_TYPE      (1u << 1)
+#define WF_IMPL_OPERATION_ATTR_INODE     (1u << 2)
+#define WF_IMPL_OPERATION_ATTR_MODE      (1u << 3)
+#define WF_IMPL_OPERATION_ATTR_SIZE      (1u << 4)
+#define WF_IMPL_OPERATION_ATTR_ATIME     (1u << 5)
+#define WF_IMPL_OPERATION_ATTR_MTIME     (1u << 6)
+#define WF_IMPL_OPERATION_ATTR_CTIME     (1u << 7)
+#define WF_IMPL_OPERATION_ATTR_ATTR_TTL  (1u << 8)
+#define WF_IMPL_OPERATION_ATTR_ENTRY_TTL (1u << 9)
+
+struct wf_impl_operation_attr
+{
+    struct wf_json_field_string name;
+    struct wf_json_field_string type;
+    int64_t inode;
+    int64_t mode;
+    int64_t size;
+    int64_t atime;
+    int64_t mtime;
+    int64_t ctime;
+    int64_t attr_ttl;
+    int64_t entry_ttl;
+    uint32_t fields;
+};
+
+extern void
+wf_impl_operation_attr_decode(
+    struct wf_json const * json,
+    struct wf_impl_operation_attr * attr);
+
+extern bool
+wf_impl_operation_attr_has(
+    struct wf_impl_operation_attr const * attr,
+    uint32_t fields);
+
+// S_IFREG for "file", S_IFDIR for "dir", 0 otherwise
+extern mode_t
+wf_impl_operation_attr_get_type(
+    struct wf_impl_operation_attr const * attr);
+
+// fills mode, nlink, size and times; other members are left untouched
+extern void
+wf_impl_operation_attr_fill(
+    struct wf_impl_operation_attr const * attr,
+    struct stat * buffer);
+
+// returns ttl, if provided by the result, and default_value otherwise
+extern double
+wf_impl_operation_attr_get_timeout(
+    int64_t ttl,
+    double default_value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,7 +1,7 @@
 #include "webfuse/impl/operation/close.h"
 #include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/operation/readahead.h"
 
-#include <limits.h>
 #include <errno.h>
 
 #include "webfuse/impl/jsonrpc/proxy.h"
@@ -16,8 +16,13 @@ void wf_impl_operation_close(
 
 	if (NULL != rpc)
 	{
-		int handle = (int) (file_info->fh & INT_MAX);
-		wf_impl_jsonrpc_proxy_notify(rpc, "close", "siii", user_data->name, inode, handle, file_info->flags);
+		uint64_t const handle = file_info->fh;
+		if (NULL != user_data->readahead)
+		{
+			wf_impl_readahead_release(user_data->readahead, inode, handle);
+		}
+
+		wf_impl_jsonrpc_proxy_notify(rpc, "close", "sIIi", user_data->name, (int64_t) inode, (int64_t) handle, file_info->flags);
 	}
 	
 	fuse_reply_err(request, 0);
@@ -8,12 +8,23 @@ extern "C" {
 #endif
 
 struct wf_jsonrpc_proxy;
+struct wf_impl_readahead;
+struct wf_impl_block_cache;
+struct wf_impl_file_versions;
+struct wf_impl_negative_cache;
 
 struct wf_impl_operation_context
 {
 	struct wf_jsonrpc_proxy * proxy;
-	double timeout;
+	double attr_timeout;
+	double entry_timeout;
 	char * name;
+	struct wf_impl_readahead * readahead;
+	struct wf_impl_block_cache * cache;
+	struct wf_impl_file_versions * versions;
+	size_t direct_io_threshold;
+	double negative_timeout;
+	struct wf_impl_negative_cache * negative_cache;
 };
 
 extern struct wf_jsonrpc_proxy * wf_impl_operation_context_get_proxy(
@@ -0,0 +1,205 @@
+#include "webfuse/impl/operation/dir_snapshot.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define WF_IMPL_DIR_SNAPSHOT_INITIAL_CAPACITY 16
+
+struct wf_impl_dir_snapshot_entry
+{
+    char * name;
+    struct stat attr;
+    bool has_attr;
+    double attr_timeout;
+    double entry_timeout;
+};
+
+struct wf_impl_dir_snapshot
+{
+    struct wf_impl_dir_snapshot_entry * entries;
+    size_t size;
+    size_t capacity;
+    off_t offset;
+    int64_t cursor;
+    bool is_loaded;
+    bool has_next;
+};
+
+struct wf_impl_dir_snapshot *
+wf_impl_dir_snapshot_create(void)
+{
+    struct wf_impl_dir_snapshot * snapshot = malloc(sizeof(struct wf_impl_dir_snapshot));
+    snapshot->entries = NULL;
+    snapshot->size = 0;
+    snapshot->capacity = 0;
+    wf_impl_dir_snapshot_reset(snapshot, 0);
+
+    return snapshot;
+}
+
+void
+wf_impl_dir_snapshot_dispose(
+    struct wf_impl_dir_snapshot * snapshot)
+{
+    wf_impl_dir_snapshot_reset(snapshot, 0);
+    free(snapshot->entries);
+    free(snapshot);
+}
+
+void
+wf_impl_dir_snapshot_reset(
+    struct wf_impl_dir_snapshot * snapshot,
+    off_t offset)
+{
+    for(size_t i = 0; i < snapshot->size; i++)
+    {
+        free(snapshot->entries[i].name);
+    }
+
+    snapshot->size = 0;
+    snapshot->offset = offset;
+    snapshot->cursor = 0;
+    snapshot->is_loaded = false;
+    snapshot->has_next = false;
+}
+
+void
+wf_impl_dir_snapshot_set_loaded(
+    struct wf_impl_dir_snapshot * snapshot,
+    bool has_next,
+    int64_t cursor)
+{
+    snapshot->is_loaded = true;
+    snapshot->has_next = has_next;
+    snapshot->cursor = cursor;
+}
+
+bool
+wf_impl_dir_snapshot_contains(
+    struct wf_impl_dir_snapshot const * snapshot,
+    off_t offset)
+{
+    if ((!snapshot->is_loaded) || (offset < snapshot->offset))
+    {
+        return false;
+    }
+
+    size_t const index = (size_t) (offset - snapshot->offset);
+    return (index < snapshot->size) || (!snapshot->has_next);
+}
+
+bool
+wf_impl_dir_snapshot_get_next(
+    struct wf_impl_dir_snapshot const * snapshot,
+    off_t * offset,
+    int64_t * cursor)
+{
+    if ((!snapshot->is_loaded) || (!snapshot->has_next))
+    {
+        return false;
+    }
+
+    *offset = snapshot->offset + (off_t) snapshot->size;
+    *cursor = snapshot->cursor;
+    return true;
+}
+
+size_t
+wf_impl_dir_snapshot_size(
+    struct wf_impl_dir_snapshot const * snapshot)
+{
+    return snapshot->size;
+}
+
+void
+wf_impl_dir_snapshot_add(
+    struct wf_impl_dir_snapshot * snapshot,
+    char const * name,
+    struct stat const * attr,
+    bool has_attr,
+    double attr_timeout,
+    double entry_timeout)
+{
+    if (snapshot->size >= snapshot->capacity)
+    {
+        snapshot->capacity = (0 < snapshot->capacity) ? (snapshot->capacity * 2) : WF_IMPL_DIR_SNAPSHOT_INITIAL_CAPACITY;
+        snapshot->entries = realloc(snapshot->entries, snapshot->capacity * sizeof(struct wf_impl_dir_snapshot_entry));
+    }
+
+    struct wf_impl_dir_snapshot_entry * entry = &snapshot->entries[snapshot->size];
+    entry->name = strdup(name);
+    entry->attr = *attr;
+    entry->has_attr = has_attr;
+    entry->attr_timeout = attr_timeout;
+    entry->entry_timeout = entry_timeout;
+    snapshot->size++;
+}
+
+size_t
+wf_impl_dir_snapshot_fill(
+    struct wf_impl_dir_snapshot const * snapshot,
+    fuse_req_t request,
+    off_t offset,
+    char * buffer,
+    size_t size)
+{
+    size_t position = 0;
+    size_t const first = (offset > snapshot->offset) ? (size_t) (offset - snapshot->offset) : 0;
+    for(size_t i = first; i < snapshot->size; i++)
+    {
+        struct wf_impl_dir_snapshot_entry const * entry = &snapshot->entries[i];
+        size_t const entry_size = fuse_add_direntry(request, &buffer[position], size - position,
+            entry->name, &entry->attr, snapshot->offset + (off_t) (i + 1));
+        if (entry_size > (size - position))
+        {
+            break;
+        }
+
+        position += entry_size;
+    }
+
+    return position;
+}
+
+size_t
+wf_impl_dir_snapshot_fill_plus(
+    struct wf_impl_dir_snapshot const * snapshot,
+    fuse_req_t request,
+    uid_t uid,
+    gid_t gid,
+    off_t offset,
+    char * buffer,
+    size_t size)
+{
+    size_t position = 0;
+    size_t const first = (offset > snapshot->offset) ? (size_t) (offset - snapshot->offset) : 0;
+    for(size_t i = first; i < snapshot->size; i++)
+    {
+        struct wf_impl_dir_snapshot_entry const * entry = &snapshot->entries[i];
+
+        // without attributes, the entry is added as plain directory entry;
+        // inode 0 prevents the kernel from caching it
+        struct fuse_entry_param entry_param;
+        memset(&entry_param, 0, sizeof(struct fuse_entry_param));
+        entry_param.attr = entry->attr;
+        if (entry->has_attr)
+        {
+            entry_param.ino = entry->attr.st_ino;
+            entry_param.attr.st_uid = uid;
+            entry_param.attr.st_gid = gid;
+            entry_param.attr_timeout = entry->attr_timeout;
+            entry_param.entry_timeout = entry->entry_timeout;
+        }
+
+        size_t const entry_size = fuse_add_direntry_plus(request, &buffer[position], size - position,
+            entry->name, &entry_param, snapshot->offset + (off_t) (i + 1));
+        if (entry_size > (size - position))
+        {
+            break;
+        }
+
+        position += entry_size;
+    }
+
+    return position;
+}
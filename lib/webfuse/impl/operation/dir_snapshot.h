@@ -0,0 +1,116 @@
+#ifndef WF_ADAPTER_IMPL_OPERATION_DIR_SNAPSHOT_H
+#define WF_ADAPTER_IMPL_OPERATION_DIR_SNAPSHOT_H
+
+#include "webfuse/impl/fuse_wrapper.h"
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#else
+#include <cstddef>
+#include <cstdint>
+using std::size_t;
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Holds the entries of a directory listing.
+//
+// A snapshot is created by opendir and stored in the directory handle,
+// so that the listing is fetched only once per open directory.
+// Offsets passed to the kernel are entry indices, so that readdir and
+// readdirplus can be served from the same snapshot.
+//
+// When the provider pages the listing, the snapshot holds the current
+// page only: offset is the index of the first entry of the page and
+// cursor identifies the next page.
+
+struct wf_impl_dir_snapshot;
+
+extern struct wf_impl_dir_snapshot *
+wf_impl_dir_snapshot_create(void);
+
+extern void
+wf_impl_dir_snapshot_dispose(
+    struct wf_impl_dir_snapshot * snapshot);
+
+// Removes all entries and marks the snapshot as not loaded.
+// Entries added afterwards start at offset.
+extern void
+wf_impl_dir_snapshot_reset(
+    struct wf_impl_dir_snapshot * snapshot,
+    off_t offset);
+
+// Marks the snapshot as loaded.
+// If has_next is true, cursor identifies the next page.
+extern void
+wf_impl_dir_snapshot_set_loaded(
+    struct wf_impl_dir_snapshot * snapshot,
+    bool has_next,
+    int64_t cursor);
+
+// Returns true, if a request at offset can be answered by the snapshot,
+// either by its entries or by end of directory.
+extern bool
+wf_impl_dir_snapshot_contains(
+    struct wf_impl_dir_snapshot const * snapshot,
+    off_t offset);
+
+// Returns true, if there is a page following the loaded one.
+// Offset and cursor of the next page are returned.
+extern bool
+wf_impl_dir_snapshot_get_next(
+    struct wf_impl_dir_snapshot const * snapshot,
+    off_t * offset,
+    int64_t * cursor);
+
+extern size_t
+wf_impl_dir_snapshot_size(
+    struct wf_impl_dir_snapshot const * snapshot);
+
+// Adds an entry to the snapshot.
+// If has_attr is false, only inode and type of attr are used.
+extern void
+wf_impl_dir_snapshot_add(
+    struct wf_impl_dir_snapshot * snapshot,
+    char const * name,
+    struct stat const * attr,
+    bool has_attr,
+    double attr_timeout,
+    double entry_timeout);
+
+// Fills buffer with directory entries, starting at offset.
+// Returns the number of bytes written.
+extern size_t
+wf_impl_dir_snapshot_fill(
+    struct wf_impl_dir_snapshot const * snapshot,
+    fuse_req_t request,
+    off_t offset,
+    char * buffer,
+    size_t size);
+
+// Fills buffer with directory entries including attributes
+// (readdirplus), starting at offset.
+// Returns the number of bytes written.
+extern size_t
+wf_impl_dir_snapshot_fill_plus(
+    struct wf_impl_dir_snapshot const * snapshot,
+    fuse_req_t request,
+    uid_t uid,
+    gid_t gid,
+    off_t offset,
+    char * buffer,
+    size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,5 +1,8 @@
 #include "webfuse/impl/operation/getattr.h"
 #include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/operation/attr.h"
+#include "webfuse/impl/cache/block_cache.h"
+#include "webfuse/impl/cache/file_versions.h"
 
 #include <errno.h>
 #include <string.h>
@@ -23,33 +26,18 @@ void wf_impl_operation_getattr_finished(
 	struct wf_impl_operation_getattr_context * context = user_data;
 
     struct stat buffer;
+	struct wf_impl_operation_attr attr;
+	wf_impl_operation_attr_decode(result, &attr);
 	if (NULL != result)
 	{
-		struct wf_json const * mode_holder = wf_impl_json_object_get(result, "mode");
-		struct wf_json const * type_holder = wf_impl_json_object_get(result, "type");
-		if ((wf_impl_json_is_int(mode_holder)) && (wf_impl_json_is_string(type_holder)))
+		if (wf_impl_operation_attr_has(&attr, WF_IMPL_OPERATION_ATTR_MODE | WF_IMPL_OPERATION_ATTR_TYPE))
 		{
             memset(&buffer, 0, sizeof(struct stat));
 
 			buffer.st_ino = context->inode;
-			buffer.st_mode = wf_impl_json_int_get(mode_holder) & 0555;
-			char const * type = wf_impl_json_string_get(type_holder);
-			if (0 == strcmp("file", type)) 
-			{
-				buffer.st_mode |= S_IFREG;
-			}
-			else if (0 == strcmp("dir", type))
-			{
-				buffer.st_mode |= S_IFDIR;
-			}
-
             buffer.st_uid = context->uid;
             buffer.st_gid = context->gid;
-            buffer.st_nlink = 1;
-			buffer.st_size = wf_impl_json_get_int(result, "size", 0);
-			buffer.st_atime = wf_impl_json_get_int(result, "atime", 0);
-			buffer.st_mtime = wf_impl_json_get_int(result, "mtime", 0);
-			buffer.st_ctime = wf_impl_json_get_int(result, "ctime", 0);
+			wf_impl_operation_attr_fill(&attr, &buffer);
 		}
 		else
 		{
@@ -59,7 +47,18 @@ void wf_impl_operation_getattr_finished(
 
     if (WF_GOOD == status)
     {
-        fuse_reply_attr(context->request, &buffer, context->timeout);
+        if ((NULL != context->cache) && (S_ISREG(buffer.st_mode)))
+        {
+            wf_impl_block_cache_update(context->cache, context->inode, buffer.st_size, buffer.st_mtime);
+        }
+
+        if ((NULL != context->versions) && (S_ISREG(buffer.st_mode)))
+        {
+            wf_impl_file_versions_update(context->versions, context->inode, buffer.st_size, buffer.st_mtime);
+        }
+
+        double const timeout = wf_impl_operation_attr_get_timeout(attr.attr_ttl, context->timeout);
+        fuse_reply_attr(context->request, &buffer, timeout);
     }
     else
     {
@@ -85,9 +84,11 @@ void wf_impl_operation_getattr (
 		getattr_context->inode = inode;		
 		getattr_context->uid = context->uid;
 		getattr_context->gid = context->gid;
-		getattr_context->timeout = user_data->timeout;
+		getattr_context->timeout = user_data->attr_timeout;
+		getattr_context->cache = user_data->cache;
+		getattr_context->versions = user_data->versions;
 
-		wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_getattr_finished, getattr_context, "getattr", "si", user_data->name, inode);
+		wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_getattr_finished, getattr_context, "getattr", "sI", user_data->name, (int64_t) inode);
 	}
 	else
 	{
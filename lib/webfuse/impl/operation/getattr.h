@@ -12,6 +12,8 @@ extern "C"
 
 struct wf_jsonrpc_error;
 struct wf_json;
+struct wf_impl_block_cache;
+struct wf_impl_file_versions;
 
 struct wf_impl_operation_getattr_context
 {
@@ -20,6 +22,8 @@ struct wf_impl_operation_getattr_context
 	double timeout;
 	uid_t uid;
 	gid_t gid;
+	struct wf_impl_block_cache * cache;
+	struct wf_impl_file_versions * versions;
 };
 
 extern void wf_impl_operation_getattr_finished(
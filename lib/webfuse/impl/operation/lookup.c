@@ -1,7 +1,10 @@
 #include "webfuse/impl/operation/lookup.h"
 #include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/operation/attr.h"
+#include "webfuse/impl/cache/block_cache.h"
+#include "webfuse/impl/cache/file_versions.h"
+#include "webfuse/impl/cache/negative_cache.h"
 
-#include <limits.h>
 #include <errno.h>
 #include <string.h>
 
@@ -16,6 +19,19 @@
 #include "webfuse/impl/util/json_util.h"
 #include "webfuse/impl/util/util.h"
 
+// missing entries are replied with inode 0, so that the kernel caches them
+static void wf_impl_operation_lookup_reply_negative(
+	fuse_req_t request,
+	double timeout)
+{
+	struct fuse_entry_param buffer;
+	memset(&buffer, 0, sizeof(struct fuse_entry_param));
+	buffer.ino = 0;
+	buffer.entry_timeout = timeout;
+
+	fuse_reply_entry(request, &buffer);
+}
+
 void wf_impl_operation_lookup_finished(
 	void * user_data,
 	struct wf_json const * result,
@@ -26,40 +42,22 @@ void wf_impl_operation_lookup_finished(
 	struct wf_impl_operation_lookup_context * context = user_data; 	
     struct fuse_entry_param buffer;
 
+	struct wf_impl_operation_attr attr;
+	wf_impl_operation_attr_decode(result, &attr);
 	if (NULL != result)
 	{
-		struct wf_json const * inode_holder = wf_impl_json_object_get(result, "inode"); 
-		struct wf_json const * mode_holder = wf_impl_json_object_get(result, "mode");
-		struct wf_json const * type_holder = wf_impl_json_object_get(result, "type");
-		if ((wf_impl_json_is_int(inode_holder)) &&
-			(wf_impl_json_is_int(mode_holder)) && 
-		    (wf_impl_json_is_string(type_holder)))
+		if (wf_impl_operation_attr_has(&attr,
+			WF_IMPL_OPERATION_ATTR_INODE | WF_IMPL_OPERATION_ATTR_MODE | WF_IMPL_OPERATION_ATTR_TYPE))
 		{
-            memset(&buffer, 0, sizeof(struct stat));
+            memset(&buffer, 0, sizeof(struct fuse_entry_param));
 
-			buffer.ino = wf_impl_json_int_get(inode_holder);
+			buffer.ino = (fuse_ino_t) attr.inode;
 			buffer.attr.st_ino = buffer.ino;
-			buffer.attr.st_mode = wf_impl_json_int_get(mode_holder) & 0555;
-			char const * type = wf_impl_json_string_get(type_holder);
-			if (0 == strcmp("file", type)) 
-			{
-				buffer.attr.st_mode |= S_IFREG;
-			}
-			else if (0 == strcmp("dir", type))
-			{
-				buffer.attr.st_mode |= S_IFDIR;
-			}
-
-
-			buffer.attr_timeout = context->timeout;
-			buffer.entry_timeout = context->timeout;
+			buffer.attr_timeout = wf_impl_operation_attr_get_timeout(attr.attr_ttl, context->attr_timeout);
+			buffer.entry_timeout = wf_impl_operation_attr_get_timeout(attr.entry_ttl, context->entry_timeout);
             buffer.attr.st_uid = context->uid;
             buffer.attr.st_gid = context->gid;
-            buffer.attr.st_nlink = 1;
-			buffer.attr.st_size = wf_impl_json_get_int(result, "size", 0);
-			buffer.attr.st_atime = wf_impl_json_get_int(result, "atime", 0);
-			buffer.attr.st_mtime = wf_impl_json_get_int(result, "mtime", 0);
-			buffer.attr.st_ctime = wf_impl_json_get_int(result, "ctime", 0);
+			wf_impl_operation_attr_fill(&attr, &buffer.attr);
 		}
 		else
 		{
@@ -69,13 +67,34 @@ void wf_impl_operation_lookup_finished(
 
     if (WF_GOOD == status)
     {
+        if ((NULL != context->cache) && (S_ISREG(buffer.attr.st_mode)))
+        {
+            wf_impl_block_cache_update(context->cache, buffer.ino, buffer.attr.st_size, buffer.attr.st_mtime);
+        }
+
+        if ((NULL != context->versions) && (S_ISREG(buffer.attr.st_mode)))
+        {
+            wf_impl_file_versions_update(context->versions, buffer.ino, buffer.attr.st_size, buffer.attr.st_mtime);
+        }
+
         fuse_reply_entry(context->request, &buffer);
     }
+    else if ((WF_BAD_NOENTRY == status) && (0.0 < context->negative_timeout))
+    {
+        if (NULL != context->negative_cache)
+        {
+            wf_timer_timepoint const expires = wf_impl_timer_timepoint_in_msec((wf_timer_timediff) (context->negative_timeout * 1000));
+            wf_impl_negative_cache_add(context->negative_cache, context->parent, context->name, expires);
+        }
+
+        wf_impl_operation_lookup_reply_negative(context->request, context->negative_timeout);
+    }
     else
     {
 	    fuse_reply_err(context->request, ENOENT);
     }
 
+	free(context->name);
 	free(context);
 }
 
@@ -88,15 +107,27 @@ void wf_impl_operation_lookup (
     struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
     struct wf_jsonrpc_proxy * rpc = wf_impl_operation_context_get_proxy(user_data);
 
-	if (NULL != rpc)
+	if ((NULL != user_data) && (NULL != user_data->negative_cache) &&
+		(wf_impl_negative_cache_contains(user_data->negative_cache, parent, name)))
+	{
+		wf_impl_operation_lookup_reply_negative(request, user_data->negative_timeout);
+	}
+	else if (NULL != rpc)
 	{
 		struct wf_impl_operation_lookup_context * lookup_context = malloc(sizeof(struct wf_impl_operation_lookup_context));
 		lookup_context->request = request;
 		lookup_context->uid = context->uid;
 		lookup_context->gid = context->gid;
-		lookup_context->timeout = user_data->timeout;
+		lookup_context->attr_timeout = user_data->attr_timeout;
+		lookup_context->entry_timeout = user_data->entry_timeout;
+		lookup_context->cache = user_data->cache;
+		lookup_context->versions = user_data->versions;
+		lookup_context->parent = parent;
+		lookup_context->name = strdup(name);
+		lookup_context->negative_timeout = user_data->negative_timeout;
+		lookup_context->negative_cache = user_data->negative_cache;
 
-		wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_lookup_finished, lookup_context, "lookup", "sis", user_data->name, (int) (parent & INT_MAX), name);
+		wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_lookup_finished, lookup_context, "lookup", "sIs", user_data->name, (int64_t) parent, name);
 	}
 	else
 	{
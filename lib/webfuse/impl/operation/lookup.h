@@ -12,13 +12,23 @@ extern "C"
 
 struct wf_jsonrpc_error;
 struct wf_json;
+struct wf_impl_block_cache;
+struct wf_impl_file_versions;
+struct wf_impl_negative_cache;
 
 struct wf_impl_operation_lookup_context
 {
 	fuse_req_t request;
-	double timeout;
+	double attr_timeout;
+	double entry_timeout;
 	uid_t uid;
 	gid_t gid;
+	struct wf_impl_block_cache * cache;
+	struct wf_impl_file_versions * versions;
+	fuse_ino_t parent;
+	char * name;
+	double negative_timeout;
+	struct wf_impl_negative_cache * negative_cache;
 };
 
 extern void wf_impl_operation_lookup_finished(
@@ -1,47 +1,95 @@
 #include "webfuse/impl/operation/open.h"
 #include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/cache/file_versions.h"
 
 #include "webfuse/impl/jsonrpc/proxy.h"
 #include "webfuse/impl/json/node.h"
+#include "webfuse/impl/json/fields.h"
 #include "webfuse/impl/util/util.h"
 #include "webfuse/status.h"
 #include "webfuse/impl/util/json_util.h"
 
 #include <string.h>
+#include <stdlib.h>
 #include <errno.h>
 
+struct wf_impl_operation_open_result
+{
+	int64_t handle;
+	bool cacheable;
+	bool immutable;
+	bool direct_io;
+};
+
+#define WF_IMPL_OPERATION_OPEN_RESULT_HANDLE (1u << 0)
+
+#define WF_IMPL_OPERATION_OPEN_RESULT_FIELD(key, type, member) \
+	WF_JSON_FIELD(key, type, struct wf_impl_operation_open_result, member)
+
+static struct wf_json_field const wf_impl_operation_open_result_fields[] =
+{
+	WF_IMPL_OPERATION_OPEN_RESULT_FIELD("handle"   , WF_JSON_TYPE_INT , handle),
+	WF_IMPL_OPERATION_OPEN_RESULT_FIELD("cacheable", WF_JSON_TYPE_BOOL, cacheable),
+	WF_IMPL_OPERATION_OPEN_RESULT_FIELD("immutable", WF_JSON_TYPE_BOOL, immutable),
+	WF_IMPL_OPERATION_OPEN_RESULT_FIELD("direct_io", WF_JSON_TYPE_BOOL, direct_io)
+};
+
+#define WF_IMPL_OPERATION_OPEN_RESULT_FIELD_COUNT \
+	(sizeof(wf_impl_operation_open_result_fields) / sizeof(wf_impl_operation_open_result_fields[0]))
+
 void wf_impl_operation_open_finished(
 	void * user_data,
 	struct wf_json const * result,
 	struct wf_jsonrpc_error const * error)
 {
 	wf_status status = wf_impl_jsonrpc_get_status(error);
-	fuse_req_t request = user_data;
+	struct wf_impl_operation_open_context * context = user_data;
 	struct fuse_file_info file_info;
 	memset(&file_info, 0, sizeof(struct fuse_file_info));
 
 	if (NULL != result)
 	{
-        struct wf_json const * handle_holder = wf_impl_json_object_get(result, "handle");
-        if (wf_impl_json_is_int(handle_holder))
-        {
-            file_info.fh = wf_impl_json_int_get(handle_holder);
-        }
-        else
-        {
-            status = WF_BAD_FORMAT;
-        }        
+		struct wf_impl_operation_open_result open_result = { 0, false, false, false };
+		uint32_t const fields = wf_impl_json_fields_decode(result, wf_impl_operation_open_result_fields,
+			WF_IMPL_OPERATION_OPEN_RESULT_FIELD_COUNT, &open_result);
+		if (0 != (fields & WF_IMPL_OPERATION_OPEN_RESULT_HANDLE))
+		{
+			file_info.fh = (uint64_t) open_result.handle;
+
+			// keep pages cached by the kernel, if the provider states that
+			// contents did not change or if size and mtime are unchanged
+			bool const is_unchanged = (NULL != context->versions) &&
+				(wf_impl_file_versions_open(context->versions, context->inode));
+			bool const is_cacheable = open_result.cacheable || open_result.immutable;
+			file_info.keep_cache = (is_unchanged || is_cacheable) ? 1 : 0;
+
+			// large files are streamed without polluting the page cache
+			uint64_t size;
+			bool const is_large = (0 < context->direct_io_threshold) && (NULL != context->versions) &&
+				(wf_impl_file_versions_get_size(context->versions, context->inode, &size)) &&
+				(context->direct_io_threshold <= size);
+			if ((is_large) || (open_result.direct_io))
+			{
+				file_info.direct_io = 1;
+				file_info.keep_cache = 0;
+			}
+		}
+		else
+		{
+			status = WF_BAD_FORMAT;
+		}
 	}
 
 	if (WF_GOOD == status)
 	{
-		fuse_reply_open(request, &file_info);		
+		fuse_reply_open(context->request, &file_info);		
 	}
 	else
 	{
-		fuse_reply_err(request, ENOENT);
+		fuse_reply_err(context->request, ENOENT);
 	}
 
+	free(context);
 }
 
 void wf_impl_operation_open(
@@ -54,7 +102,13 @@ void wf_impl_operation_open(
 
 	if (NULL != rpc)
 	{
-		wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_open_finished, request, "open", "sii", user_data->name, inode, file_info->flags);
+		struct wf_impl_operation_open_context * open_context = malloc(sizeof(struct wf_impl_operation_open_context));
+		open_context->request = request;
+		open_context->inode = inode;
+		open_context->versions = user_data->versions;
+		open_context->direct_io_threshold = user_data->direct_io_threshold;
+
+		wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_open_finished, open_context, "open", "sIi", user_data->name, (int64_t) inode, file_info->flags);
 	}
 	else
 	{
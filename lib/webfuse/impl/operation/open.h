@@ -10,6 +10,15 @@ extern "C"
 
 struct wf_jsonrpc_error;
 struct wf_json;
+struct wf_impl_file_versions;
+
+struct wf_impl_operation_open_context
+{
+	fuse_req_t request;
+	fuse_ino_t inode;
+	struct wf_impl_file_versions * versions;
+	size_t direct_io_threshold;
+};
 
 extern void wf_impl_operation_open(
 	fuse_req_t request,
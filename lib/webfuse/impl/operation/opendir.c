@@ -0,0 +1,23 @@
+#include "webfuse/impl/operation/opendir.h"
+#include "webfuse/impl/operation/dir_snapshot.h"
+
+#include "webfuse/impl/util/util.h"
+
+#include <stdint.h>
+
+void wf_impl_operation_opendir(
+	fuse_req_t request,
+	fuse_ino_t WF_UNUSED_PARAM(inode),
+	struct fuse_file_info * file_info)
+{
+	// the listing is fetched by the first readdir request and
+	// kept until the directory is released
+	struct wf_impl_dir_snapshot * snapshot = wf_impl_dir_snapshot_create();
+	file_info->fh = (uint64_t) (uintptr_t) snapshot;
+
+	if (0 != fuse_reply_open(request, file_info))
+	{
+		// request was interrupted, releasedir will not be called
+		wf_impl_dir_snapshot_dispose(snapshot);
+	}
+}
@@ -1,19 +1,48 @@
 #include "webfuse/impl/operation/read.h"
 #include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/operation/readahead.h"
+#include "webfuse/impl/cache/block_cache.h"
 
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
-#include <limits.h>
+
+#include <zlib.h>
 
 #include "webfuse/impl/jsonrpc/proxy.h"
 #include "webfuse/impl/json/node.h"
+#include "webfuse/impl/json/fields.h"
+#include "webfuse/impl/json/writer.h"
 #include "webfuse/impl/util/base64.h"
 #include "webfuse/impl/util/json_util.h"
+#include "webfuse/impl/util/util.h"
 
-// do not read chunks larger than 1 MByte
+// do not request chunks larger than 1 MByte;
+// larger reads are split into multiple requests
 #define WF_MAX_READ_LENGTH (1024 * 1024)
 
+struct wf_impl_operation_read_result
+{
+	struct wf_json_field_string data;
+	struct wf_json_field_string format;
+	int64_t count;
+};
+
+#define WF_IMPL_OPERATION_READ_RESULT_ALL ((1u << 3) - 1)
+
+#define WF_IMPL_OPERATION_READ_RESULT_FIELD(key, type, member) \
+	WF_JSON_FIELD(key, type, struct wf_impl_operation_read_result, member)
+
+static struct wf_json_field const wf_impl_operation_read_result_fields[] =
+{
+	WF_IMPL_OPERATION_READ_RESULT_FIELD("data"  , WF_JSON_TYPE_STRING, data),
+	WF_IMPL_OPERATION_READ_RESULT_FIELD("format", WF_JSON_TYPE_STRING, format),
+	WF_IMPL_OPERATION_READ_RESULT_FIELD("count" , WF_JSON_TYPE_INT   , count)
+};
+
+#define WF_IMPL_OPERATION_READ_RESULT_FIELD_COUNT \
+	(sizeof(wf_impl_operation_read_result_fields) / sizeof(wf_impl_operation_read_result_fields[0]))
+
 char * wf_impl_operation_read_transform(
 	char * data,
 	size_t data_size,
@@ -50,32 +79,83 @@ char * wf_impl_operation_read_transform(
 	return buffer;
 }
 
-void wf_impl_operation_read_finished(
-	void * user_data, 
+char * wf_impl_operation_read_inflate(
+	char * data,
+	size_t data_size,
+	char const * format,
+	size_t count,
+	wf_status * status)
+{
+	*status = WF_BAD;
+	size_t compressed_size = data_size;
+
+	if (0 == strcmp("deflate+base64", format))
+	{
+		compressed_size = wf_impl_base64_decode(data, data_size, (uint8_t *) data, data_size);
+		if (0 == compressed_size) { return NULL; }
+	}
+	else if (0 != strcmp("deflate", format))
+	{
+		return NULL;
+	}
+
+	// count is announced by the provider; limit it to prevent
+	// huge allocations caused by malicious responses
+	if (WF_MAX_READ_LENGTH < count) { return NULL; }
+
+	char * buffer = malloc((0 < count) ? count : 1);
+	uLongf buffer_size = (uLongf) count;
+	int const rc = uncompress((Bytef *) buffer, &buffer_size, (Bytef const *) data, (uLong) compressed_size);
+	if ((Z_OK != rc) || (count != (size_t) buffer_size))
+	{
+		free(buffer);
+		return NULL;
+	}
+
+	*status = WF_GOOD;
+	return buffer;
+}
+
+static bool wf_impl_operation_read_is_compressed(
+	char const * format)
+{
+	return (0 == strncmp("deflate", format, 7));
+}
+
+wf_status wf_impl_operation_read_get_data(
 	struct wf_json const * result,
-	struct wf_jsonrpc_error const * error)
+	struct wf_jsonrpc_error const * error,
+	char * * buffer,
+	size_t * length,
+	char * * allocated)
 {
 	wf_status status = wf_impl_jsonrpc_get_status(error);
-	fuse_req_t request = user_data;
+	*buffer = NULL;
+	*length = 0;
+	*allocated = NULL;
 
-	char * buffer = NULL;	
-	size_t length = 0;
 	if (NULL != result)
 	{
-		struct wf_json const * data_holder = wf_impl_json_object_get(result, "data");
-		struct wf_json const * format_holder = wf_impl_json_object_get(result, "format");
-		struct wf_json const * count_holder = wf_impl_json_object_get(result, "count");
+		struct wf_impl_operation_read_result read_result;
+		uint32_t const fields = wf_impl_json_fields_decode(result, wf_impl_operation_read_result_fields,
+			WF_IMPL_OPERATION_READ_RESULT_FIELD_COUNT, &read_result);
 
-		if ((wf_impl_json_is_string(data_holder)) &&
-        	(wf_impl_json_is_string(format_holder)) &&
-            (wf_impl_json_is_int(count_holder)))
+		if (WF_IMPL_OPERATION_READ_RESULT_ALL == fields)
 		{
-			char * const data = (char*) wf_impl_json_string_get(data_holder);
-			size_t const data_size = wf_impl_json_string_size(data_holder);
-			char const * const format = wf_impl_json_string_get(format_holder);
-			length = (size_t) wf_impl_json_int_get(count_holder);
+			char * const data = (char*) read_result.data.data;
+			size_t const data_size = read_result.data.size;
+			char const * const format = read_result.format.data;
+			*length = (size_t) read_result.count;
 
-			buffer = wf_impl_operation_read_transform(data, data_size, format, length, &status);
+			if (wf_impl_operation_read_is_compressed(format))
+			{
+				*allocated = wf_impl_operation_read_inflate(data, data_size, format, *length, &status);
+				*buffer = *allocated;
+			}
+			else
+			{
+				*buffer = wf_impl_operation_read_transform(data, data_size, format, *length, &status);
+			}
 		}
 		else
 		{
@@ -83,6 +163,21 @@ void wf_impl_operation_read_finished(
 		}
 	}
 
+	return status;
+}
+
+void wf_impl_operation_read_finished(
+	void * user_data, 
+	struct wf_json const * result,
+	struct wf_jsonrpc_error const * error)
+{
+	fuse_req_t request = user_data;
+
+	char * buffer;
+	size_t length;
+	char * allocated;
+	wf_status const status = wf_impl_operation_read_get_data(result, error, &buffer, &length, &allocated);
+
 	if (WF_GOOD == status)
 	{
 		fuse_reply_buf(request, buffer, length);
@@ -91,6 +186,257 @@ void wf_impl_operation_read_finished(
 	{
    		fuse_reply_err(request, ENOENT);
 	}
+
+	free(allocated);
+}
+
+struct wf_impl_operation_read_context
+{
+	fuse_req_t request;
+	struct wf_impl_block_cache * cache;
+	uint64_t generation;
+	fuse_ino_t inode;
+	off_t offset;
+	size_t size;
+};
+
+static void wf_impl_operation_read_cached_finished(
+	void * user_data, 
+	struct wf_json const * result,
+	struct wf_jsonrpc_error const * error)
+{
+	struct wf_impl_operation_read_context * context = user_data;
+
+	char * buffer;
+	size_t length;
+	char * allocated;
+	wf_status status = wf_impl_operation_read_get_data(result, error, &buffer, &length, &allocated);
+
+	// data beyond the requested range must neither be cached nor replied
+	if ((WF_GOOD == status) && (context->size < length))
+	{
+		status = WF_BAD_FORMAT;
+	}
+
+	if (WF_GOOD == status)
+	{
+		wf_impl_block_cache_put(context->cache, context->generation, context->inode,
+			context->offset, context->size, buffer, length);
+		fuse_reply_buf(context->request, buffer, length);
+	}
+	else
+	{
+   		fuse_reply_err(context->request, ENOENT);
+	}
+
+	free(allocated);
+	free(context);
+}
+
+struct wf_impl_operation_read_split;
+
+struct wf_impl_operation_read_split_chunk
+{
+	struct wf_impl_operation_read_split * split;
+	wf_status status;
+	size_t size;
+	size_t length;
+};
+
+struct wf_impl_operation_read_split
+{
+	fuse_req_t request;
+	struct wf_impl_block_cache * cache;
+	uint64_t generation;
+	fuse_ino_t inode;
+	off_t offset;
+	size_t pending;
+	size_t count;
+	char * buffer;
+	struct wf_impl_operation_read_split_chunk * chunks;
+};
+
+// replies the longest sequence of successfully read chunks,
+// so that failed chunks result in a short read
+static void wf_impl_operation_read_split_reply(
+	struct wf_impl_operation_read_split * split)
+{
+	size_t length = 0;
+	for (size_t i = 0; i < split->count; i++)
+	{
+		struct wf_impl_operation_read_split_chunk * chunk = &split->chunks[i];
+		if (WF_GOOD != chunk->status) { break; }
+
+		length += chunk->length;
+		if (chunk->size > chunk->length) { break; }
+	}
+
+	if ((0 < length) || (WF_GOOD == split->chunks[0].status))
+	{
+		fuse_reply_buf(split->request, split->buffer, length);
+	}
+	else
+	{
+		fuse_reply_err(split->request, ENOENT);
+	}
+}
+
+static void wf_impl_operation_read_split_finished(
+	void * user_data, 
+	struct wf_json const * result,
+	struct wf_jsonrpc_error const * error)
+{
+	struct wf_impl_operation_read_split_chunk * chunk = user_data;
+	struct wf_impl_operation_read_split * split = chunk->split;
+	size_t const index = (size_t) (chunk - split->chunks);
+	off_t const offset = split->offset + (off_t) (index * WF_MAX_READ_LENGTH);
+
+	char * buffer;
+	size_t length;
+	char * allocated;
+	chunk->status = wf_impl_operation_read_get_data(result, error, &buffer, &length, &allocated);
+
+	if ((WF_GOOD == chunk->status) && (chunk->size < length))
+	{
+		chunk->status = WF_BAD_FORMAT;
+	}
+
+	if (WF_GOOD == chunk->status)
+	{
+		memcpy(&split->buffer[index * WF_MAX_READ_LENGTH], buffer, length);
+		chunk->length = length;
+
+		if (NULL != split->cache)
+		{
+			wf_impl_block_cache_put(split->cache, split->generation, split->inode,
+				offset, chunk->size, buffer, length);
+		}
+	}
+
+	free(allocated);
+
+	split->pending--;
+	if (0 == split->pending)
+	{
+		wf_impl_operation_read_split_reply(split);
+
+		free(split->chunks);
+		free(split->buffer);
+		free(split);
+	}
+}
+
+// reads exceeding WF_MAX_READ_LENGTH are split into multiple read
+// requests, which are processed concurrently by the provider
+static void wf_impl_operation_read_split_invoke(
+	struct wf_jsonrpc_proxy * proxy,
+	char const * name,
+	struct wf_impl_block_cache * cache,
+	fuse_req_t request,
+	fuse_ino_t inode,
+	uint64_t handle,
+	size_t size,
+	off_t offset)
+{
+	size_t const count = (size + WF_MAX_READ_LENGTH - 1) / WF_MAX_READ_LENGTH;
+
+	struct wf_impl_operation_read_split * split = malloc(sizeof(struct wf_impl_operation_read_split));
+	split->request = request;
+	split->cache = cache;
+	split->generation = (NULL != cache) ? wf_impl_block_cache_get_generation(cache) : 0;
+	split->inode = inode;
+	split->offset = offset;
+	split->count = count;
+	split->pending = count;
+	split->buffer = malloc(size);
+	split->chunks = malloc(count * sizeof(struct wf_impl_operation_read_split_chunk));
+
+	for (size_t i = 0; i < count; i++)
+	{
+		size_t const chunk_offset = i * WF_MAX_READ_LENGTH;
+		struct wf_impl_operation_read_split_chunk * chunk = &split->chunks[i];
+		chunk->split = split;
+		chunk->status = WF_BAD;
+		chunk->size = ((size - chunk_offset) < WF_MAX_READ_LENGTH) ? (size - chunk_offset) : WF_MAX_READ_LENGTH;
+		chunk->length = 0;
+	}
+
+	// split may be disposed during last invocation
+	for (size_t i = 0; i < count; i++)
+	{
+		size_t const chunk_offset = i * WF_MAX_READ_LENGTH;
+		size_t const chunk_size = split->chunks[i].size;
+		struct wf_impl_operation_read_split_chunk * chunk = &split->chunks[i];
+
+		wf_impl_jsonrpc_proxy_invoke_binary(proxy, &wf_impl_operation_read_split_finished, chunk, "read", "sIIIi",
+			name, (int64_t) inode, (int64_t) handle, (int64_t) (offset + (off_t) chunk_offset), (int) chunk_size);
+	}
+}
+
+void wf_impl_operation_read_invoke(
+	struct wf_jsonrpc_proxy * proxy,
+	char const * name,
+	struct wf_impl_block_cache * cache,
+	fuse_req_t request,
+	fuse_ino_t inode,
+	uint64_t handle,
+	size_t size,
+	off_t offset)
+{
+	if (WF_MAX_READ_LENGTH < size)
+	{
+		wf_impl_operation_read_split_invoke(proxy, name, cache, request, inode, handle, size, offset);
+	}
+	else if (NULL != cache)
+	{
+		struct wf_impl_operation_read_context * context = malloc(sizeof(struct wf_impl_operation_read_context));
+		context->request = request;
+		context->cache = cache;
+		context->generation = wf_impl_block_cache_get_generation(cache);
+		context->inode = inode;
+		context->offset = offset;
+		context->size = size;
+
+		wf_impl_jsonrpc_proxy_invoke_binary(proxy, &wf_impl_operation_read_cached_finished, context, "read", "sIIIi", name, (int64_t) inode, (int64_t) handle, (int64_t) offset, (int) size);
+	}
+	else
+	{
+		wf_impl_jsonrpc_proxy_invoke_binary(proxy, &wf_impl_operation_read_finished, request, "read", "sIIIi", name, (int64_t) inode, (int64_t) handle, (int64_t) offset, (int) size);
+	}
+}
+
+static bool wf_impl_operation_read_from_cache(
+	struct wf_impl_block_cache * cache,
+	fuse_req_t request,
+	fuse_ino_t inode,
+	size_t size,
+	off_t offset)
+{
+	size_t length;
+	bool const is_cached = wf_impl_block_cache_contains(cache, inode, offset, size, &length);
+	if (is_cached)
+	{
+		// length is limited by the end of file, which may be below size
+		char * buffer = malloc((0 < length) ? length : 1);
+		wf_impl_block_cache_get(cache, inode, offset, length, buffer, &length);
+		fuse_reply_buf(request, buffer, length);
+		free(buffer);
+	}
+
+	return is_cached;
+}
+
+void wf_impl_operation_read_write_formats(
+	struct wf_json_writer * writer,
+	void * WF_UNUSED_PARAM(data))
+{
+	wf_impl_json_write_array_begin(writer);
+	wf_impl_json_write_string(writer, "identity");
+	wf_impl_json_write_string(writer, "base64");
+	wf_impl_json_write_string(writer, "deflate");
+	wf_impl_json_write_string(writer, "deflate+base64");
+	wf_impl_json_write_string(writer, "binary");
+	wf_impl_json_write_array_end(writer);
 }
 
 void wf_impl_operation_read(
@@ -103,15 +449,24 @@ void wf_impl_operation_read(
     struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
     struct wf_jsonrpc_proxy * rpc = wf_impl_operation_context_get_proxy(user_data);
 
-	if ((NULL != rpc) && (size <= WF_MAX_READ_LENGTH))
+	if (NULL != rpc)
 	{
-		int const length = (int) size;
-		int handle = (file_info->fh & INT_MAX);
-		wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_read_finished, request, "read", "siiii", user_data->name, (int) inode, handle, (int) offset, length);
-	}
-	else if (size > WF_MAX_READ_LENGTH)
-	{
-		fuse_reply_err(request, ENOMEM);
+		uint64_t const handle = file_info->fh;
+		bool const is_cached = (NULL != user_data->cache) &&
+			(wf_impl_operation_read_from_cache(user_data->cache, request, inode, size, offset));
+
+		if ((!is_cached) && (NULL != user_data->readahead))
+		{
+			wf_impl_readahead_read(user_data->readahead, rpc, user_data->name, request, inode, handle, size, offset);
+		}
+		else if (!is_cached)
+		{
+			wf_impl_operation_read_invoke(rpc, user_data->name, user_data->cache, request, inode, handle, size, offset);
+		}
+		else if (NULL != user_data->readahead)
+		{
+			wf_impl_readahead_advance(user_data->readahead, inode, handle, size, offset);
+		}
 	}
 	else
 	{
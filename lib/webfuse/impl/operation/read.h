@@ -4,6 +4,12 @@
 #include "webfuse/impl/fuse_wrapper.h"
 #include "webfuse/status.h"
 
+#ifndef __cplusplus
+#include <stdint.h>
+#else
+#include <cstdint>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -11,6 +17,9 @@ extern "C"
 
 struct wf_jsonrpc_error;
 struct wf_json;
+struct wf_json_writer;
+struct wf_jsonrpc_proxy;
+struct wf_impl_block_cache;
 
 extern void wf_impl_operation_read(
 	fuse_req_t request,
@@ -24,11 +33,43 @@ extern char * wf_impl_operation_read_transform(
 	size_t count,
 	wf_status * status);
 
+extern char * wf_impl_operation_read_inflate(
+	char * data,
+	size_t data_size,
+	char const * format,
+	size_t count,
+	wf_status * status);
+
+// Decodes the result of a read request.
+// Compressed data is inflated into a newly allocated buffer, which is
+// returned in allocated and must be freed by the caller; otherwise data
+// is decoded in place and allocated is set to NULL.
+extern wf_status wf_impl_operation_read_get_data(
+	struct wf_json const * result,
+	struct wf_jsonrpc_error const * error,
+	char * * buffer,
+	size_t * length,
+	char * * allocated);
+
 extern void wf_impl_operation_read_finished(
 	void * user_data, 
 	struct wf_json const * result,
 	struct wf_jsonrpc_error const * error);
 
+extern void wf_impl_operation_read_invoke(
+	struct wf_jsonrpc_proxy * proxy,
+	char const * name,
+	struct wf_impl_block_cache * cache,
+	fuse_req_t request,
+	fuse_ino_t inode,
+	uint64_t handle,
+	size_t size,
+	off_t offset);
+
+extern void wf_impl_operation_read_write_formats(
+	struct wf_json_writer * writer,
+	void * data);
+
 
 #ifdef __cplusplus
 }
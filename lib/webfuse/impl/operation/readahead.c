@@ -0,0 +1,435 @@
+#include "webfuse/impl/operation/readahead.h"
+#include "webfuse/impl/operation/read.h"
+
+#include "webfuse/impl/cache/block_cache.h"
+#include "webfuse/impl/jsonrpc/proxy.h"
+#include "webfuse/impl/util/slist.h"
+#include "webfuse/impl/util/container_of.h"
+#include "webfuse/status.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// sequential reads are answered from chunks fetched ahead of the kernel;
+// each chunk is requested by a separate read RPC, so that up to
+// max_size / size requests are in flight
+
+struct wf_impl_readahead_stream;
+
+struct wf_impl_readahead_waiter
+{
+    struct wf_slist_item item;
+    fuse_req_t request;
+    off_t offset;
+    size_t size;
+};
+
+struct wf_impl_readahead_chunk
+{
+    struct wf_slist_item item;
+    struct wf_impl_readahead_stream * stream;
+    struct wf_impl_block_cache * cache;
+    uint64_t generation;
+    fuse_ino_t inode;
+    off_t offset;
+    size_t size;
+    bool is_pending;
+    wf_status status;
+    char * data;
+    size_t length;
+    struct wf_slist waiters;
+};
+
+struct wf_impl_readahead_stream
+{
+    struct wf_slist_item item;
+    fuse_ino_t inode;
+    uint64_t handle;
+    off_t next_offset;
+    off_t prefetch_offset;
+    size_t window;
+    bool is_eof;
+    struct wf_slist chunks;
+};
+
+struct wf_impl_readahead
+{
+    size_t max_size;
+    struct wf_impl_block_cache * cache;
+    struct wf_slist streams;
+};
+
+static void
+wf_impl_readahead_chunk_reply(
+    struct wf_impl_readahead_chunk * chunk,
+    fuse_req_t request,
+    off_t offset,
+    size_t size)
+{
+    if (WF_GOOD == chunk->status)
+    {
+        size_t const start = (size_t) (offset - chunk->offset);
+        size_t const available = (start < chunk->length) ? chunk->length - start : 0;
+        size_t const length = (available < size) ? available : size;
+
+        fuse_reply_buf(request, (0 < length) ? &chunk->data[start] : NULL, length);
+    }
+    else
+    {
+        fuse_reply_err(request, ENOENT);
+    }
+}
+
+static void
+wf_impl_readahead_chunk_dispose(
+    struct wf_impl_readahead_chunk * chunk)
+{
+    free(chunk->data);
+    free(chunk);
+}
+
+static void
+wf_impl_readahead_chunk_finished(
+	void * user_data,
+	struct wf_json const * result,
+	struct wf_jsonrpc_error const * error)
+{
+    struct wf_impl_readahead_chunk * chunk = user_data;
+
+    char * data;
+    size_t length;
+    char * allocated;
+    chunk->status = wf_impl_operation_read_get_data(result, error, &data, &length, &allocated);
+    chunk->is_pending = false;
+    if ((WF_GOOD == chunk->status) && (chunk->size < length))
+    {
+        chunk->status = WF_BAD_FORMAT;
+        free(allocated);
+    }
+
+    if (WF_GOOD == chunk->status)
+    {
+        if (NULL != allocated)
+        {
+            // take ownership of inflated data
+            chunk->data = allocated;
+        }
+        else
+        {
+            chunk->data = malloc((0 < length) ? length : 1);
+            memcpy(chunk->data, data, length);
+        }
+        chunk->length = length;
+
+        if (NULL != chunk->cache)
+        {
+            wf_impl_block_cache_put(chunk->cache, chunk->generation, chunk->inode,
+                chunk->offset, chunk->size, data, length);
+        }
+    }
+
+    while (!wf_impl_slist_empty(&chunk->waiters))
+    {
+        struct wf_slist_item * item = wf_impl_slist_remove_first(&chunk->waiters);
+        struct wf_impl_readahead_waiter * waiter = wf_container_of(item, struct wf_impl_readahead_waiter, item);
+        wf_impl_readahead_chunk_reply(chunk, waiter->request, waiter->offset, waiter->size);
+        free(waiter);
+    }
+
+    if (NULL == chunk->stream)
+    {
+        wf_impl_readahead_chunk_dispose(chunk);
+    }
+    else if ((WF_GOOD == chunk->status) && (chunk->length < chunk->size))
+    {
+        chunk->stream->is_eof = true;
+    }
+}
+
+// Pending chunks cannot be freed, since their RPC is still in flight.
+// They are detached from the stream and freed on completion.
+static void
+wf_impl_readahead_chunk_release(
+    struct wf_impl_readahead_chunk * chunk)
+{
+    if (chunk->is_pending)
+    {
+        chunk->stream = NULL;
+    }
+    else
+    {
+        wf_impl_readahead_chunk_dispose(chunk);
+    }
+}
+
+static void
+wf_impl_readahead_stream_drop_chunks(
+    struct wf_impl_readahead_stream * stream)
+{
+    while (!wf_impl_slist_empty(&stream->chunks))
+    {
+        struct wf_slist_item * item = wf_impl_slist_remove_first(&stream->chunks);
+        struct wf_impl_readahead_chunk * chunk = wf_container_of(item, struct wf_impl_readahead_chunk, item);
+        wf_impl_readahead_chunk_release(chunk);
+    }
+}
+
+static void
+wf_impl_readahead_stream_drop_consumed(
+    struct wf_impl_readahead_stream * stream,
+    off_t offset)
+{
+    struct wf_slist_item * item = wf_impl_slist_first(&stream->chunks);
+    while (NULL != item)
+    {
+        struct wf_impl_readahead_chunk * chunk = wf_container_of(item, struct wf_impl_readahead_chunk, item);
+        if (offset < (off_t) (chunk->offset + chunk->size))
+        {
+            break;
+        }
+
+        wf_impl_slist_remove_first(&stream->chunks);
+        wf_impl_readahead_chunk_release(chunk);
+        item = wf_impl_slist_first(&stream->chunks);
+    }
+}
+
+static size_t
+wf_impl_readahead_stream_count_chunks(
+    struct wf_impl_readahead_stream * stream)
+{
+    size_t count = 0;
+    for (struct wf_slist_item * item = wf_impl_slist_first(&stream->chunks); NULL != item; item = item->next)
+    {
+        count++;
+    }
+
+    return count;
+}
+
+static void
+wf_impl_readahead_stream_prefetch(
+    struct wf_impl_readahead * readahead,
+    struct wf_impl_readahead_stream * stream,
+    struct wf_jsonrpc_proxy * proxy,
+    char const * name,
+    size_t size)
+{
+    size_t count = wf_impl_readahead_stream_count_chunks(stream);
+    while ((!stream->is_eof) && (count < stream->window))
+    {
+        struct wf_impl_readahead_chunk * chunk = malloc(sizeof(struct wf_impl_readahead_chunk));
+        chunk->stream = stream;
+        chunk->cache = readahead->cache;
+        chunk->generation = (NULL != readahead->cache) ? wf_impl_block_cache_get_generation(readahead->cache) : 0;
+        chunk->inode = stream->inode;
+        chunk->offset = stream->prefetch_offset;
+        chunk->size = size;
+        chunk->is_pending = true;
+        chunk->status = WF_GOOD;
+        chunk->data = NULL;
+        chunk->length = 0;
+        wf_impl_slist_init(&chunk->waiters);
+        wf_impl_slist_append(&stream->chunks, &chunk->item);
+
+        stream->prefetch_offset += size;
+        count++;
+
+        wf_impl_jsonrpc_proxy_invoke_binary(proxy, &wf_impl_readahead_chunk_finished, chunk,
+            "read", "sIIIi", name, (int64_t) stream->inode, (int64_t) stream->handle, (int64_t) chunk->offset, (int) size);
+    }
+}
+
+static bool
+wf_impl_readahead_stream_serve(
+    struct wf_impl_readahead_stream * stream,
+    fuse_req_t request,
+    size_t size,
+    off_t offset)
+{
+    struct wf_slist_item * item = wf_impl_slist_first(&stream->chunks);
+    if (NULL == item) { return false; }
+
+    struct wf_impl_readahead_chunk * chunk = wf_container_of(item, struct wf_impl_readahead_chunk, item);
+    bool const is_covered = (chunk->offset <= offset) &&
+        ((off_t) (offset + size) <= (off_t) (chunk->offset + chunk->size));
+    if ((!is_covered) || ((!chunk->is_pending) && (WF_GOOD != chunk->status)))
+    {
+        return false;
+    }
+
+    if (chunk->is_pending)
+    {
+        struct wf_impl_readahead_waiter * waiter = malloc(sizeof(struct wf_impl_readahead_waiter));
+        waiter->request = request;
+        waiter->offset = offset;
+        waiter->size = size;
+        wf_impl_slist_append(&chunk->waiters, &waiter->item);
+    }
+    else
+    {
+        wf_impl_readahead_chunk_reply(chunk, request, offset, size);
+
+        if ((off_t) (chunk->offset + chunk->size) <= (off_t) (offset + size))
+        {
+            wf_impl_slist_remove_first(&stream->chunks);
+            wf_impl_readahead_chunk_dispose(chunk);
+        }
+    }
+
+    return true;
+}
+
+static struct wf_impl_readahead_stream *
+wf_impl_readahead_get_stream(
+    struct wf_impl_readahead * readahead,
+    fuse_ino_t inode,
+    uint64_t handle)
+{
+    for (struct wf_slist_item * item = wf_impl_slist_first(&readahead->streams); NULL != item; item = item->next)
+    {
+        struct wf_impl_readahead_stream * stream = wf_container_of(item, struct wf_impl_readahead_stream, item);
+        if ((inode == stream->inode) && (handle == stream->handle))
+        {
+            return stream;
+        }
+    }
+
+    struct wf_impl_readahead_stream * stream = malloc(sizeof(struct wf_impl_readahead_stream));
+    stream->inode = inode;
+    stream->handle = handle;
+    stream->next_offset = -1;
+    stream->prefetch_offset = 0;
+    stream->window = 0;
+    stream->is_eof = false;
+    wf_impl_slist_init(&stream->chunks);
+    wf_impl_slist_append(&readahead->streams, &stream->item);
+
+    return stream;
+}
+
+static void
+wf_impl_readahead_stream_dispose(
+    struct wf_impl_readahead_stream * stream)
+{
+    wf_impl_readahead_stream_drop_chunks(stream);
+    free(stream);
+}
+
+struct wf_impl_readahead *
+wf_impl_readahead_create(
+    size_t max_size,
+    struct wf_impl_block_cache * cache)
+{
+    struct wf_impl_readahead * readahead = malloc(sizeof(struct wf_impl_readahead));
+    readahead->max_size = max_size;
+    readahead->cache = cache;
+    wf_impl_slist_init(&readahead->streams);
+
+    return readahead;
+}
+
+void
+wf_impl_readahead_dispose(
+    struct wf_impl_readahead * readahead)
+{
+    while (!wf_impl_slist_empty(&readahead->streams))
+    {
+        struct wf_slist_item * item = wf_impl_slist_remove_first(&readahead->streams);
+        struct wf_impl_readahead_stream * stream = wf_container_of(item, struct wf_impl_readahead_stream, item);
+        wf_impl_readahead_stream_dispose(stream);
+    }
+
+    free(readahead);
+}
+
+void
+wf_impl_readahead_read(
+    struct wf_impl_readahead * readahead,
+    struct wf_jsonrpc_proxy * proxy,
+    char const * name,
+    fuse_req_t request,
+    fuse_ino_t inode,
+    uint64_t handle,
+    size_t size,
+    off_t offset)
+{
+    struct wf_impl_readahead_stream * stream = wf_impl_readahead_get_stream(readahead, inode, handle);
+    size_t const max_window = (0 < size) ? readahead->max_size / size : 0;
+
+    if ((offset == stream->next_offset) && (0 < max_window))
+    {
+        wf_impl_readahead_stream_drop_consumed(stream, offset);
+        stream->window = (0 < stream->window) ? stream->window * 2 : 1;
+        if (max_window < stream->window)
+        {
+            stream->window = max_window;
+        }
+    }
+    else
+    {
+        // random access: stop read-ahead until sequential access is detected again
+        wf_impl_readahead_stream_drop_chunks(stream);
+        stream->window = 0;
+        stream->is_eof = false;
+    }
+    stream->next_offset = offset + size;
+
+    if (!wf_impl_readahead_stream_serve(stream, request, size, offset))
+    {
+        wf_impl_readahead_stream_drop_chunks(stream);
+        stream->prefetch_offset = offset + size;
+
+        wf_impl_operation_read_invoke(proxy, name, readahead->cache, request, inode, handle, size, offset);
+    }
+
+    wf_impl_readahead_stream_prefetch(readahead, stream, proxy, name, size);
+}
+
+// reads answered elsewhere (e.g. by the block cache) still move the stream,
+// so that sequential access is detected once they miss again
+void
+wf_impl_readahead_advance(
+    struct wf_impl_readahead * readahead,
+    fuse_ino_t inode,
+    uint64_t handle,
+    size_t size,
+    off_t offset)
+{
+    struct wf_impl_readahead_stream * stream = wf_impl_readahead_get_stream(readahead, inode, handle);
+
+    if (offset == stream->next_offset)
+    {
+        wf_impl_readahead_stream_drop_consumed(stream, offset + size);
+    }
+    else
+    {
+        wf_impl_readahead_stream_drop_chunks(stream);
+        stream->window = 0;
+        stream->is_eof = false;
+    }
+    stream->next_offset = offset + size;
+}
+
+void
+wf_impl_readahead_release(
+    struct wf_impl_readahead * readahead,
+    fuse_ino_t inode,
+    uint64_t handle)
+{
+    struct wf_slist_item * prev = &readahead->streams.head;
+    while (NULL != prev->next)
+    {
+        struct wf_impl_readahead_stream * stream = wf_container_of(prev->next, struct wf_impl_readahead_stream, item);
+        if ((inode == stream->inode) && (handle == stream->handle))
+        {
+            wf_impl_slist_remove_after(&readahead->streams, prev);
+            wf_impl_readahead_stream_dispose(stream);
+            break;
+        }
+
+        prev = prev->next;
+    }
+}
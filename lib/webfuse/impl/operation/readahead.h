@@ -0,0 +1,62 @@
+#ifndef WF_ADAPTER_IMPL_OPERATION_READAHEAD_H
+#define WF_ADAPTER_IMPL_OPERATION_READAHEAD_H
+
+#include "webfuse/impl/fuse_wrapper.h"
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <stdint.h>
+#else
+#include <cstddef>
+#include <cstdint>
+using std::size_t;
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+struct wf_impl_readahead;
+struct wf_jsonrpc_proxy;
+struct wf_impl_block_cache;
+
+extern struct wf_impl_readahead *
+wf_impl_readahead_create(
+    size_t max_size,
+    struct wf_impl_block_cache * cache);
+
+extern void
+wf_impl_readahead_dispose(
+    struct wf_impl_readahead * readahead);
+
+extern void
+wf_impl_readahead_read(
+    struct wf_impl_readahead * readahead,
+    struct wf_jsonrpc_proxy * proxy,
+    char const * name,
+    fuse_req_t request,
+    fuse_ino_t inode,
+    uint64_t handle,
+    size_t size,
+    off_t offset);
+
+extern void
+wf_impl_readahead_advance(
+    struct wf_impl_readahead * readahead,
+    fuse_ino_t inode,
+    uint64_t handle,
+    size_t size,
+    off_t offset);
+
+extern void
+wf_impl_readahead_release(
+    struct wf_impl_readahead * readahead,
+    fuse_ino_t inode,
+    uint64_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,9 +1,14 @@
 #include "webfuse/impl/operation/readdir.h"
 #include "webfuse/impl/operation/context.h"
+#include "webfuse/impl/operation/dir_snapshot.h"
+#include "webfuse/impl/operation/attr.h"
+#include "webfuse/impl/cache/block_cache.h"
+#include "webfuse/impl/cache/file_versions.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <stdint.h>
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -11,60 +16,100 @@
 
 #include "webfuse/impl/jsonrpc/proxy.h"
 #include "webfuse/impl/json/node.h"
+#include "webfuse/impl/json/fields.h"
 #include "webfuse/impl/util/util.h"
 #include "webfuse/impl/util/json_util.h"
 
+// paged readdir result
+struct wf_impl_operation_readdir_page
+{
+	struct wf_json const * entries;
+	int64_t next;
+};
 
-#define WF_DIRBUFFER_INITIAL_SIZE 1024
+#define WF_IMPL_OPERATION_READDIR_PAGE_NEXT (1u << 1)
 
-struct wf_impl_dirbuffer
+static struct wf_json_field const wf_impl_operation_readdir_page_fields[] =
 {
-	char * data;
-	size_t position;
-	size_t capacity;
+	WF_JSON_FIELD("entries", WF_JSON_TYPE_ARRAY, struct wf_impl_operation_readdir_page, entries),
+	WF_JSON_FIELD("next"   , WF_JSON_TYPE_INT  , struct wf_impl_operation_readdir_page, next)
 };
 
-static void wf_impl_dirbuffer_init(
-	struct wf_impl_dirbuffer * buffer)
-{
-	buffer->data = malloc(WF_DIRBUFFER_INITIAL_SIZE);
-	buffer->position = 0;
-	buffer->capacity = WF_DIRBUFFER_INITIAL_SIZE;
-}
+#define WF_IMPL_OPERATION_READDIR_PAGE_FIELD_COUNT \
+	(sizeof(wf_impl_operation_readdir_page_fields) / sizeof(wf_impl_operation_readdir_page_fields[0]))
 
-static void wf_impl_dirbuffer_dispose(
-	struct wf_impl_dirbuffer * buffer)
+// entries of an extended readdir result carry the same attributes
+// as a lookup result; mode and type are mandatory
+static void wf_impl_operation_readdir_add(
+	struct wf_impl_operation_readdir_context * context,
+	struct wf_impl_dir_snapshot * snapshot,
+	struct wf_impl_operation_attr const * entry)
 {
-	free(buffer->data);
+	fuse_ino_t const inode = (fuse_ino_t) entry->inode;
+	struct stat attr;
+	memset(&attr, 0, sizeof(struct stat));
+	bool const has_attr = wf_impl_operation_attr_has(entry, WF_IMPL_OPERATION_ATTR_MODE | WF_IMPL_OPERATION_ATTR_TYPE);
+	if (has_attr)
+	{
+		wf_impl_operation_attr_fill(entry, &attr);
+	}
+	else
+	{
+		attr.st_mode = wf_impl_operation_attr_get_type(entry);
+	}
+	attr.st_ino = inode;
+
+	if ((has_attr) && (S_ISREG(attr.st_mode)))
+	{
+		if (NULL != context->cache)
+		{
+			wf_impl_block_cache_update(context->cache, inode, attr.st_size, attr.st_mtime);
+		}
+		if (NULL != context->versions)
+		{
+			wf_impl_file_versions_update(context->versions, inode, attr.st_size, attr.st_mtime);
+		}
+	}
+
+	wf_impl_dir_snapshot_add(snapshot, entry->name.data, &attr, has_attr,
+		wf_impl_operation_attr_get_timeout(entry->attr_ttl, context->attr_timeout),
+		wf_impl_operation_attr_get_timeout(entry->entry_ttl, context->entry_timeout));
 }
 
-static void wf_impl_dirbuffer_add(
+static void wf_impl_operation_readdir_reply(
 	fuse_req_t request,
-	struct wf_impl_dirbuffer * buffer,
-	char const * name,
-	fuse_ino_t inode)
+	struct wf_impl_dir_snapshot const * snapshot,
+	bool plus,
+	uid_t uid,
+	gid_t gid,
+	size_t size,
+	off_t offset)
 {
-	size_t const size = fuse_add_direntry(request, NULL, 0, name, NULL, 0);
-	size_t remaining = buffer->capacity - buffer->position;
-	while (remaining < size)
-	{
-		buffer->capacity *= 2;
-		buffer->data = realloc(buffer->data, buffer->capacity);
-		remaining = buffer->capacity - buffer->position;
-	}
+	char * buffer = malloc(size);
+	size_t const length = (plus)
+		? wf_impl_dir_snapshot_fill_plus(snapshot, request, uid, gid, offset, buffer, size)
+		: wf_impl_dir_snapshot_fill(snapshot, request, offset, buffer, size);
 
-	struct stat stat_buffer;
-	memset(&stat_buffer, 0, sizeof(struct stat));
-	stat_buffer.st_ino = inode;
-	fuse_add_direntry(request, 
-		&buffer->data[buffer->position], remaining, name,
-		&stat_buffer, buffer->position + size);
-	buffer->position += size;
+	fuse_reply_buf(request, buffer, length);
+	free(buffer);
 }
 
-static size_t wf_impl_min(size_t a, size_t b)
+// minimal size of an entry with a name of up to 8 characters;
+// pages are requested large enough to fill the kernel's buffer
+#define WF_IMPL_READDIR_ENTRY_SIZE 32
+#define WF_IMPL_READDIRPLUS_ENTRY_SIZE 160
+
+static void wf_impl_operation_readdir_fetch(
+	struct wf_impl_operation_readdir_context * context,
+	off_t page_offset,
+	int64_t cursor)
 {
-	return (a < b) ? a : b;
+	size_t const entry_size = (context->plus) ? WF_IMPL_READDIRPLUS_ENTRY_SIZE : WF_IMPL_READDIR_ENTRY_SIZE;
+	size_t const limit = (context->size > entry_size) ? (context->size / entry_size) : 1;
+	context->page_offset = page_offset;
+
+	wf_impl_jsonrpc_proxy_invoke(context->rpc, &wf_impl_operation_readdir_finished, context, "readdir", "sIIi",
+		context->name, (int64_t) context->inode, cursor, (int) limit);
 }
 
 void wf_impl_operation_readdir_finished(
@@ -75,31 +120,40 @@ void wf_impl_operation_readdir_finished(
 	wf_status status = wf_impl_jsonrpc_get_status(error);
 	struct wf_impl_operation_readdir_context * context = user_data;
 
-	struct wf_impl_dirbuffer buffer;
-	wf_impl_dirbuffer_init(&buffer);
+	// without directory handle, the listing is fetched for each request
+	struct wf_impl_dir_snapshot * snapshot = (NULL != context->snapshot)
+		? context->snapshot : wf_impl_dir_snapshot_create();
 
-	if ((NULL != result) && (wf_impl_json_is_array(result)))
+	// providers either return all entries as array or
+	// a page of entries along with the cursor of the next page
+	struct wf_impl_operation_readdir_page page = { result, 0 };
+	uint32_t page_fields = 0;
+	if ((NULL != result) && (wf_impl_json_is_object(result)))
 	{
-		size_t const count = wf_impl_json_array_size(result);
+		page.entries = NULL;
+		page_fields = wf_impl_json_fields_decode(result, wf_impl_operation_readdir_page_fields,
+			WF_IMPL_OPERATION_READDIR_PAGE_FIELD_COUNT, &page);
+		wf_impl_dir_snapshot_reset(snapshot, context->page_offset);
+	}
+	else
+	{
+		wf_impl_dir_snapshot_reset(snapshot, 0);
+	}
+
+	struct wf_json const * entries = page.entries;
+	bool has_next = (0 != (page_fields & WF_IMPL_OPERATION_READDIR_PAGE_NEXT));
+	int64_t cursor = page.next;
+	if ((NULL != entries) && (wf_impl_json_is_array(entries)))
+	{
+		size_t const count = wf_impl_json_array_size(entries);
 		for(size_t i = 0; i < count; i++)
 		{
-			struct wf_json const * entry = wf_impl_json_array_get(result, i);
-			if (wf_impl_json_is_object(entry))
+			struct wf_impl_operation_attr entry;
+			wf_impl_operation_attr_decode(wf_impl_json_array_get(entries, i), &entry);
+
+			if (wf_impl_operation_attr_has(&entry, WF_IMPL_OPERATION_ATTR_NAME | WF_IMPL_OPERATION_ATTR_INODE))
 			{
-				struct wf_json const * name_holder = wf_impl_json_object_get(entry, "name");
-				struct wf_json const * inode_holder = wf_impl_json_object_get(entry, "inode");
-
-				if ((wf_impl_json_is_string(name_holder)) && (wf_impl_json_is_int(inode_holder)))
-				{
-					char const * name = wf_impl_json_string_get(name_holder);
-					fuse_ino_t entry_inode = (fuse_ino_t) wf_impl_json_int_get(inode_holder);
-					wf_impl_dirbuffer_add(context->request, &buffer, name, entry_inode);	
-				}
-				else
-				{
-					status = WF_BAD_FORMAT;
-					break;
-				}
+				wf_impl_operation_readdir_add(context, snapshot, &entry);
 			}
 			else
 			{
@@ -107,6 +161,9 @@ void wf_impl_operation_readdir_finished(
 				break;
 			}
 		}
+
+		// an empty page ends the directory, even if a cursor is provided
+		has_next = has_next && (0 < count);
 	}
 	else if (WF_GOOD == status)
 	{
@@ -115,47 +172,117 @@ void wf_impl_operation_readdir_finished(
 
 	if (WF_GOOD == status)
 	{
-		if (((size_t) context->offset) < buffer.position)
-		{
-			fuse_reply_buf(context->request, &buffer.data[context->offset],
-				wf_impl_min(buffer.position - context->offset, context->size));
-		}
-		else
+		wf_impl_dir_snapshot_set_loaded(snapshot, has_next, cursor);
+
+		off_t page_offset;
+		if ((!wf_impl_dir_snapshot_contains(snapshot, context->offset)) &&
+			(wf_impl_dir_snapshot_get_next(snapshot, &page_offset, &cursor)))
 		{
-			fuse_reply_buf(context->request, NULL, 0);			
+			// requested offset is beyond the current page
+			if (snapshot != context->snapshot)
+			{
+				wf_impl_dir_snapshot_dispose(snapshot);
+			}
+			wf_impl_operation_readdir_fetch(context, page_offset, cursor);
+			return;
 		}
-		
+
+		wf_impl_operation_readdir_reply(context->request, snapshot, context->plus,
+			context->uid, context->gid, context->size, context->offset);
 	}
 	else
 	{
+		wf_impl_dir_snapshot_reset(snapshot, 0);
 		fuse_reply_err(context->request, ENOENT);
 	}
 
-	wf_impl_dirbuffer_dispose(&buffer);
+	if (snapshot != context->snapshot)
+	{
+		wf_impl_dir_snapshot_dispose(snapshot);
+	}
 	free(context);
 }
 
-void wf_impl_operation_readdir (
+static void wf_impl_operation_readdir_invoke(
 	fuse_req_t request,
 	fuse_ino_t inode,
 	size_t size,
 	off_t offset,
-	struct fuse_file_info * WF_UNUSED_PARAM(file_info))
+	struct fuse_file_info * file_info,
+	bool plus)
 {
-    struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
-    struct wf_jsonrpc_proxy * rpc = wf_impl_operation_context_get_proxy(user_data);
+	struct fuse_ctx const * fuse_context = (plus) ? fuse_req_ctx(request) : NULL;
+	struct wf_impl_operation_context * user_data = fuse_req_userdata(request);
+	struct wf_impl_dir_snapshot * snapshot = (struct wf_impl_dir_snapshot *) (uintptr_t) file_info->fh;
+	uid_t const uid = (NULL != fuse_context) ? fuse_context->uid : 0;
+	gid_t const gid = (NULL != fuse_context) ? fuse_context->gid : 0;
 
+	// continuation requests are served from the snapshot of the directory handle;
+	// a request at offset 0 starts over (rewinddir), so the listing is fetched again
+	if ((NULL != snapshot) && (0 == offset))
+	{
+		wf_impl_dir_snapshot_reset(snapshot, 0);
+	}
+	else if ((NULL != snapshot) && (wf_impl_dir_snapshot_contains(snapshot, offset)))
+	{
+		wf_impl_operation_readdir_reply(request, snapshot, plus, uid, gid, size, offset);
+		return;
+	}
+
+	struct wf_jsonrpc_proxy * rpc = wf_impl_operation_context_get_proxy(user_data);
 	if (NULL != rpc)
 	{
 		struct wf_impl_operation_readdir_context * readdir_context = malloc(sizeof(struct wf_impl_operation_readdir_context));
 		readdir_context->request = request;
 		readdir_context->size = size;
 		readdir_context->offset = offset;
+		readdir_context->plus = plus;
+		readdir_context->uid = uid;
+		readdir_context->gid = gid;
+		readdir_context->attr_timeout = user_data->attr_timeout;
+		readdir_context->entry_timeout = user_data->entry_timeout;
+		readdir_context->cache = user_data->cache;
+		readdir_context->versions = user_data->versions;
+		readdir_context->snapshot = snapshot;
+		readdir_context->rpc = rpc;
+		readdir_context->name = user_data->name;
+		readdir_context->inode = inode;
+
+		// sequential reads continue with the next page,
+		// other offsets are searched from the first page
+		off_t page_offset = 0;
+		int64_t cursor = 0;
+		if ((NULL == snapshot) || (!wf_impl_dir_snapshot_get_next(snapshot, &page_offset, &cursor)) ||
+			(offset < page_offset))
+		{
+			page_offset = 0;
+			cursor = 0;
+		}
 
-		wf_impl_jsonrpc_proxy_invoke(rpc, &wf_impl_operation_readdir_finished, readdir_context, "readdir", "si", user_data->name, inode);
+		wf_impl_operation_readdir_fetch(readdir_context, page_offset, cursor);
 	}
 	else
 	{
 		fuse_reply_err(request, ENOENT);
 	}	
 }
+
+void wf_impl_operation_readdir (
+	fuse_req_t request,
+	fuse_ino_t inode,
+	size_t size,
+	off_t offset,
+	struct fuse_file_info * file_info)
+{
+	wf_impl_operation_readdir_invoke(request, inode, size, offset, file_info, false);
+}
+
+void wf_impl_operation_readdirplus (
+	fuse_req_t request,
+	fuse_ino_t inode,
+	size_t size,
+	off_t offset,
+	struct fuse_file_info * file_info)
+{
+	wf_impl_operation_readdir_invoke(request, inode, size, offset, file_info, true);
+}
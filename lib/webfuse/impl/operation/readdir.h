@@ -3,19 +3,41 @@
 
 #include "webfuse/impl/fuse_wrapper.h"
 
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#include <sys/types.h>
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
 struct wf_jsonrpc_error;
+struct wf_jsonrpc_proxy;
 struct wf_json;
+struct wf_impl_block_cache;
+struct wf_impl_file_versions;
+struct wf_impl_dir_snapshot;
 
 struct wf_impl_operation_readdir_context
 {
 	fuse_req_t request;
 	size_t size;
 	off_t offset;
+	bool plus;
+	uid_t uid;
+	gid_t gid;
+	double attr_timeout;
+	double entry_timeout;
+	struct wf_impl_block_cache * cache;
+	struct wf_impl_file_versions * versions;
+	struct wf_impl_dir_snapshot * snapshot;
+	struct wf_jsonrpc_proxy * rpc;
+	char const * name;
+	fuse_ino_t inode;
+	off_t page_offset;
 };
 
 extern void wf_impl_operation_readdir (
@@ -30,6 +52,13 @@ extern void wf_impl_operation_readdir_finished(
 	struct wf_json const * result,
 	struct wf_jsonrpc_error const * error);
 
+extern void wf_impl_operation_readdirplus (
+	fuse_req_t request,
+	fuse_ino_t inode,
+	size_t size,
+	off_t offset,
+	struct fuse_file_info *file_info);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,20 @@
+#include "webfuse/impl/operation/releasedir.h"
+#include "webfuse/impl/operation/dir_snapshot.h"
+
+#include "webfuse/impl/util/util.h"
+
+#include <stdint.h>
+
+void wf_impl_operation_releasedir(
+	fuse_req_t request,
+	fuse_ino_t WF_UNUSED_PARAM(inode),
+	struct fuse_file_info * file_info)
+{
+	struct wf_impl_dir_snapshot * snapshot = (struct wf_impl_dir_snapshot *) (uintptr_t) file_info->fh;
+	if (NULL != snapshot)
+	{
+		wf_impl_dir_snapshot_dispose(snapshot);
+	}
+
+	fuse_reply_err(request, 0);
+}
@@ -0,0 +1,20 @@
+#ifndef WF_ADAPTER_IMPL_OPERATION_RELEASEDIR_H
+#define WF_ADAPTER_IMPL_OPERATION_RELEASEDIR_H
+
+#include "webfuse/impl/fuse_wrapper.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+extern void wf_impl_operation_releasedir(
+	fuse_req_t request,
+	fuse_ino_t inode,
+	struct fuse_file_info * file_info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -89,6 +89,9 @@ struct wf_server * wf_impl_server_create(
 	{
 		server = malloc(sizeof(struct wf_server));
 		wf_impl_server_protocol_init(&server->protocol, &config->mountpoint_factory);
+		wf_impl_mountpoint_factory_set_cache_size(&server->protocol.mountpoint_factory, config->cache_size);
+		server->protocol.write_budget = config->write_budget;
+		server->protocol.request_window = config->request_window;
 		wf_impl_server_config_clone(config, &server->config);
 		wf_impl_authenticators_move(&server->config.authenticators, &server->protocol.authenticators);				
 		server->context = wf_impl_server_context_create(server);
@@ -129,3 +132,9 @@ extern int wf_impl_server_get_port(
 {
 	return server->port;
 }
+
+size_t wf_impl_server_get_pending_requests(
+    struct wf_server * server)
+{
+	return wf_impl_session_manager_pending_requests(&server->protocol.session_manager);
+}
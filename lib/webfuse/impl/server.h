@@ -3,6 +3,10 @@
 
 #ifndef __cplusplus
 #include <stdbool.h>
+#include <stddef.h>
+#else
+#include <cstddef>
+using std::size_t;
 #endif
 
 #ifdef __cplusplus
@@ -31,6 +35,9 @@ extern void wf_impl_server_interrupt(
 extern int wf_impl_server_get_port(
     struct wf_server const * server);
 
+extern size_t wf_impl_server_get_pending_requests(
+    struct wf_server * server);
+
 #ifdef __cplusplus
 }
 #endif
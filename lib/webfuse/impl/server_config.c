@@ -46,6 +46,9 @@ void wf_impl_server_config_clone(
 	clone->cert_path = wf_impl_server_config_strdup(config->cert_path);
 	clone->vhost_name = wf_impl_server_config_strdup(config->vhost_name);
 	clone->port = config->port;
+	clone->cache_size = config->cache_size;
+	clone->write_budget = config->write_budget;
+	clone->request_window = config->request_window;
 
     wf_impl_authenticators_clone(&config->authenticators, &clone->authenticators);
     wf_impl_mountpoint_factory_clone(&config->mountpoint_factory, &clone->mountpoint_factory);
@@ -115,6 +118,27 @@ void wf_impl_server_config_set_port(
     config->port = port;
 }
 
+void wf_impl_server_config_set_cache_size(
+    struct wf_server_config * config,
+	size_t size)
+{
+    config->cache_size = size;
+}
+
+void wf_impl_server_config_set_write_budget(
+    struct wf_server_config * config,
+	size_t budget)
+{
+    config->write_budget = budget;
+}
+
+void wf_impl_server_config_set_request_window(
+    struct wf_server_config * config,
+	size_t window)
+{
+    config->request_window = window;
+}
+
 void wf_impl_server_config_add_authenticator(
     struct wf_server_config * config,
     char const * type,
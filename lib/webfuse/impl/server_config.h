@@ -15,6 +15,9 @@ struct wf_server_config
 	char * cert_path;
 	char * vhost_name;
 	int port;
+	size_t cache_size;
+	size_t write_budget;
+	size_t request_window;
 	struct wf_impl_authenticators authenticators;
     struct wf_impl_mountpoint_factory mountpoint_factory;
 };
@@ -59,6 +62,18 @@ extern void wf_impl_server_config_set_port(
     struct wf_server_config * config,
 	int port);
 
+extern void wf_impl_server_config_set_cache_size(
+    struct wf_server_config * config,
+	size_t size);
+
+extern void wf_impl_server_config_set_write_budget(
+    struct wf_server_config * config,
+	size_t budget);
+
+extern void wf_impl_server_config_set_request_window(
+    struct wf_server_config * config,
+	size_t window);
+
 extern void wf_impl_server_config_add_authenticator(
     struct wf_server_config * config,
     char const * type,
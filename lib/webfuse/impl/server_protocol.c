@@ -13,6 +13,7 @@
 
 #include "webfuse/impl/jsonrpc/request.h"
 #include "webfuse/impl/jsonrpc/response_writer.h"
+#include "webfuse/impl/operation/read.h"
 #include "webfuse/impl/json/node.h"
 #include "webfuse/impl/timer/manager.h"
 #include "webfuse/impl/timer/timer.h"
@@ -29,13 +30,16 @@ static int wf_impl_server_protocol_callback(
     if (ws_protocol->callback != &wf_impl_server_protocol_callback) { return 0; }
 
     struct wf_server_protocol * protocol = ws_protocol->user;
-    wf_impl_timer_manager_check(protocol->timer_manager);
     struct wf_impl_session * session = wf_impl_session_manager_get(&protocol->session_manager, wsi);
 
     switch (reason)
     {
         case LWS_CALLBACK_PROTOCOL_INIT:
             protocol->is_operational = true;
+            wf_impl_timer_manager_set_context(protocol->timer_manager, lws_get_context(wsi));
+            break;
+        case LWS_CALLBACK_PROTOCOL_DESTROY:
+            wf_impl_timer_manager_set_context(protocol->timer_manager, NULL);
             break;
 		case LWS_CALLBACK_ESTABLISHED:
             session = wf_impl_session_manager_add(
@@ -48,6 +52,8 @@ static int wf_impl_server_protocol_callback(
 
             if (NULL != session)
             {
+                wf_impl_session_set_write_budget(session, protocol->write_budget);
+                wf_impl_session_set_request_window(session, protocol->request_window);
                 wf_impl_session_authenticate(session, NULL);
             }
     		break;
@@ -63,13 +69,17 @@ static int wf_impl_server_protocol_callback(
         case LWS_CALLBACK_RECEIVE:
             if (NULL != session)
             {
-                wf_impl_session_receive(session, in, len, lws_is_final_fragment(wsi));
+                wf_impl_session_receive(session, in, len,
+                    lws_is_final_fragment(wsi), lws_frame_is_binary(wsi));
             }
             break;
         case LWS_CALLBACK_RAW_RX_FILE:
-            if (NULL != session)
             {
-                wf_impl_session_process_filesystem_request(session, wsi);
+                struct wf_impl_filesystem * filesystem = wf_impl_session_manager_get_filesystem(&protocol->session_manager, wsi);
+                if (NULL != filesystem)
+                {
+                    wf_impl_filesystem_process_request(filesystem);
+                }
             }
             break;
         default:
@@ -165,8 +175,9 @@ static void wf_impl_server_protocol_add_filesystem(
     struct wf_jsonrpc_request * request,
     char const * WF_UNUSED_PARAM(method_name),
     struct wf_json const * params,
-    void * WF_UNUSED_PARAM(user_data))
+    void * user_data)
 {
+    struct wf_server_protocol * protocol = user_data;
     struct wf_impl_session * session = wf_impl_jsonrpc_request_get_userdata(request);
     wf_status status = (session->is_authenticated) ? WF_GOOD : WF_BAD_ACCESS_DENIED;
 
@@ -179,8 +190,12 @@ static void wf_impl_server_protocol_add_filesystem(
             name = wf_impl_json_string_get(name_holder);
             if (wf_impl_server_protocol_check_name(name))
             {
-                bool const success = wf_impl_session_add_filesystem(session, name);
-                if (!success)
+                struct wf_impl_filesystem * filesystem = wf_impl_session_add_filesystem(session, name);
+                if (NULL != filesystem)
+                {
+                    wf_impl_session_manager_add_filesystem(&protocol->session_manager, session, filesystem);
+                }
+                else
                 {
                     status = WF_BAD;
                 }
@@ -201,6 +216,7 @@ static void wf_impl_server_protocol_add_filesystem(
     {
         struct wf_jsonrpc_response_writer * writer = wf_impl_jsonrpc_request_get_response_writer(request);
         wf_impl_jsonrpc_response_add_string(writer, "id", name);
+        wf_impl_jsonrpc_response_add_custom(writer, "formats", &wf_impl_operation_read_write_formats, NULL);
         wf_impl_jsonrpc_respond(request);
     }
     else
@@ -214,6 +230,8 @@ void wf_impl_server_protocol_init(
     struct wf_impl_mountpoint_factory * mountpoint_factory)
 {
     protocol->is_operational = false;
+    protocol->write_budget = 0;
+    protocol->request_window = 0;
 
     wf_impl_mountpoint_factory_clone(mountpoint_factory, &protocol->mountpoint_factory);
 
@@ -9,6 +9,10 @@
 
 #ifndef __cplusplus
 #include <stdbool.h>
+#include <stddef.h>
+#else
+#include <cstddef>
+using std::size_t;
 #endif
 
 #ifdef __cplusplus
@@ -27,6 +31,8 @@ struct wf_server_protocol
     struct wf_jsonrpc_server * server;
     struct wf_timer_manager * timer_manager;
     bool is_operational;
+    size_t write_budget;
+    size_t request_window;
 };
 
 extern void wf_impl_server_protocol_init(
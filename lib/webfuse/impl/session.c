@@ -12,6 +12,7 @@
 #include "webfuse/impl/jsonrpc/request.h"
 #include "webfuse/impl/jsonrpc/response.h"
 #include "webfuse/impl/json/doc.h"
+#include "webfuse/impl/json/node.h"
 
 #include <libwebsockets.h>
 #include <stddef.h>
@@ -19,6 +20,9 @@
 
 #define WF_DEFAULT_TIMEOUT (10 * 1000)
 #define WF_DEFAULT_MESSAGE_SIZE (8 * 1024)
+#define WF_DEFAULT_BATCH_SIZE (64 * 1024)
+#define WF_DEFAULT_REQUEST_WINDOW 256
+#define WF_DEFAULT_ARENA_SIZE (4 * 1024)
 
 static bool wf_impl_session_send(
     struct wf_message * message,
@@ -42,6 +46,23 @@ static bool wf_impl_session_send(
     return result;
 }
 
+static void wf_impl_session_onwindow(
+    void * user_data,
+    bool is_full)
+{
+    struct wf_impl_session * session = user_data;
+    session->is_throttled = is_full;
+
+    // stop reading requests from the kernel until the provider catches up
+    struct wf_slist_item * item = wf_impl_slist_first(&session->filesystems);
+    while (NULL != item)
+    {
+        struct wf_impl_filesystem * filesystem = wf_container_of(item, struct wf_impl_filesystem, item);
+        lws_rx_flow_control(filesystem->wsi, is_full ? 0 : 1);
+        item = item->next;
+    }
+}
+
 struct wf_impl_session * wf_impl_session_create(
     struct lws * wsi,
     struct wf_impl_authenticators * authenticators,
@@ -55,12 +76,19 @@ struct wf_impl_session * wf_impl_session_create(
     
     session->wsi = wsi;
     session->is_authenticated = false;
+    session->use_batch = false;
+    session->write_budget = WF_IMPL_MESSAGE_QUEUE_DEFAULT_WRITE_BUDGET;
     session->authenticators = authenticators;
     session->server = server;
     session->mountpoint_factory = mountpoint_factory;
+    session->is_throttled = false;
+    wf_impl_message_pool_init(&session->message_pool);
     session->rpc = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &wf_impl_session_send, session);
+    wf_impl_jsonrpc_proxy_set_message_pool(session->rpc, &session->message_pool);
+    wf_impl_jsonrpc_proxy_set_window(session->rpc, WF_DEFAULT_REQUEST_WINDOW, &wf_impl_session_onwindow, session);
     wf_impl_slist_init(&session->messages);
     wf_impl_buffer_init(&session->recv_buffer, WF_DEFAULT_MESSAGE_SIZE);
+    wf_impl_arena_init(&session->arena, WF_DEFAULT_ARENA_SIZE);
 
     return session;
 }
@@ -87,6 +115,8 @@ void wf_impl_session_dispose(
 
     wf_impl_session_dispose_filesystems(&session->filesystems);
     wf_impl_buffer_cleanup(&session->recv_buffer);
+    wf_impl_arena_cleanup(&session->arena);
+    wf_impl_message_pool_cleanup(&session->message_pool);
     free(session);
 } 
 
@@ -99,22 +129,26 @@ bool wf_impl_session_authenticate(
     return session->is_authenticated;
 }
 
-bool wf_impl_session_add_filesystem(
+struct wf_impl_filesystem * wf_impl_session_add_filesystem(
     struct wf_impl_session * session,
     char const * name)
 {
-    bool result;
+    struct wf_impl_filesystem * filesystem = NULL;
 
     struct wf_mountpoint * mountpoint = wf_impl_mountpoint_factory_create_mountpoint(session->mountpoint_factory, name);
-    result = (NULL != mountpoint);
+    bool result = (NULL != mountpoint);
  
     if (result)
     {
-        struct wf_impl_filesystem * filesystem = wf_impl_filesystem_create(session->wsi, session->rpc, name, mountpoint);
+        filesystem = wf_impl_filesystem_create(session->wsi, session->rpc, name, mountpoint);
         result = (NULL != filesystem);
         if (result)
         {
             wf_impl_slist_append(&session->filesystems, &filesystem->item);
+            if (session->is_throttled)
+            {
+                lws_rx_flow_control(filesystem->wsi, 0);
+            }
         }
     }
     
@@ -127,67 +161,110 @@ bool wf_impl_session_add_filesystem(
         }
     }
 
-    return result;
+    return filesystem;
+}
+
+
+void wf_impl_session_set_write_budget(
+    struct wf_impl_session * session,
+    size_t write_budget)
+{
+    session->write_budget = (0 < write_budget) ? write_budget : WF_IMPL_MESSAGE_QUEUE_DEFAULT_WRITE_BUDGET;
+}
+
+void wf_impl_session_set_request_window(
+    struct wf_impl_session * session,
+    size_t request_window)
+{
+    size_t const window = (0 < request_window) ? request_window : WF_DEFAULT_REQUEST_WINDOW;
+    wf_impl_jsonrpc_proxy_set_window(session->rpc, window, &wf_impl_session_onwindow, session);
 }
 
+size_t wf_impl_session_pending_requests(
+    struct wf_impl_session * session)
+{
+    return wf_impl_jsonrpc_proxy_pending_requests(session->rpc);
+}
 
 void wf_impl_session_onwritable(
     struct wf_impl_session * session)
 {
-    if (!wf_impl_slist_empty(&session->messages))
-    {
-        struct wf_slist_item * item = wf_impl_slist_remove_first(&session->messages);                
-        struct wf_message * message = wf_container_of(item, struct wf_message, item);
-        lws_write(session->wsi, (unsigned char*) message->data, message->length, LWS_WRITE_TEXT);
-        wf_impl_message_dispose(message);
+    size_t const batch_size = (session->use_batch) ? WF_DEFAULT_BATCH_SIZE : 0;
+    wf_impl_message_queue_write(&session->messages, session->wsi, batch_size, session->write_budget);
+}
 
-        if (!wf_impl_slist_empty(&session->messages))
-        {
-            lws_callback_on_writable(session->wsi);
-        }
+static void wf_impl_session_dispatch(
+    struct wf_impl_session * session,
+    struct wf_json const * message)
+{
+    if (wf_impl_jsonrpc_is_response(message))
+    {
+        wf_impl_jsonrpc_proxy_onresult(session->rpc, message);
+    }
+    else if (wf_impl_jsonrpc_is_request(message))
+    {
+        wf_impl_jsonrpc_server_process(session->server, message, &wf_impl_session_send, session);
     }
 }
 
 static void wf_impl_session_process(
     struct wf_impl_session * session,
     char * data,
-    size_t length)
+    size_t length,
+    bool is_binary)
 {
-    struct wf_json_doc * doc = wf_impl_json_doc_loadb(data, length);
+    if (is_binary)
+    {
+        wf_impl_jsonrpc_proxy_onbinary(session->rpc, data, length);
+        return;
+    }
+
+    struct wf_json_doc * doc = wf_impl_json_doc_loadb_arena(data, length, &session->arena);
     if (NULL != doc)
     {
         struct wf_json const * message = wf_impl_json_doc_root(doc);
-        if (wf_impl_jsonrpc_is_response(message))
+        if (wf_impl_json_is_array(message))
         {
-            wf_impl_jsonrpc_proxy_onresult(session->rpc, message);
+            // providers sending batches accept batches in return
+            session->use_batch = true;
+
+            size_t const count = wf_impl_json_array_size(message);
+            for(size_t i = 0; i < count; i++)
+            {
+                wf_impl_session_dispatch(session, wf_impl_json_array_get(message, i));
+            }
         }
-        else if (wf_impl_jsonrpc_is_request(message))
+        else
         {
-            wf_impl_jsonrpc_server_process(session->server, message, &wf_impl_session_send, session);
+            wf_impl_session_dispatch(session, message);
         }
 
         wf_impl_json_doc_dispose(doc);
     }
+
+    wf_impl_arena_reset(&session->arena);
 }
 
 void wf_impl_session_receive(
     struct wf_impl_session * session,
     char * data,
     size_t length,
-    bool is_final_fragment)
+    bool is_final_fragment,
+    bool is_binary)
 {
     if (is_final_fragment)
     {
         if (wf_impl_buffer_is_empty(&session->recv_buffer))
         {
-            wf_impl_session_process(session, data, length);
+            wf_impl_session_process(session, data, length, is_binary);
         }
         else
         {
             wf_impl_buffer_append(&session->recv_buffer, data, length);
             wf_impl_session_process(session,
                 wf_impl_buffer_data(&session->recv_buffer),
-                wf_impl_buffer_size(&session->recv_buffer));
+                wf_impl_buffer_size(&session->recv_buffer),
+                is_binary);
             wf_impl_buffer_clear(&session->recv_buffer);
         }        
     }
@@ -196,47 +273,3 @@ void wf_impl_session_receive(
         wf_impl_buffer_append(&session->recv_buffer, data, length);
     }
 }
-
-static struct wf_impl_filesystem * wf_impl_session_get_filesystem(
-    struct wf_impl_session * session,
-    struct lws * wsi)
-{
-    struct wf_impl_filesystem * result = NULL;
-
-    struct wf_slist_item * item = wf_impl_slist_first(&session->filesystems);
-    while (NULL != item)
-    {
-        struct wf_slist_item * next = item->next;
-        struct wf_impl_filesystem * filesystem = wf_container_of(item, struct wf_impl_filesystem, item);
-        if (wsi == filesystem->wsi)
-        {
-            result = filesystem;
-            break;
-        }
-
-        item = next;
-    }
-
-    return result;
-}
-
-
-bool wf_impl_session_contains_wsi(
-    struct wf_impl_session * session,
-    struct lws * wsi)
-{
-    bool const result = (NULL != wsi) && ((wsi == session->wsi) || (NULL != wf_impl_session_get_filesystem(session, wsi)));
-    return result;
-}
-
-
-void wf_impl_session_process_filesystem_request(
-    struct wf_impl_session * session, 
-    struct lws * wsi)
-{
-    struct wf_impl_filesystem * filesystem = wf_impl_session_get_filesystem(session, wsi);
-    if (NULL != filesystem)
-    {
-        wf_impl_filesystem_process_request(filesystem);
-    }
-}
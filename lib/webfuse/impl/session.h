@@ -10,9 +10,11 @@ using std::size_t;
 #endif
 
 #include "webfuse/impl/message_queue.h"
+#include "webfuse/impl/message_pool.h"
 #include "webfuse/impl/filesystem.h"
 #include "webfuse/impl/util/slist.h"
 #include "webfuse/impl/util/buffer.h"
+#include "webfuse/impl/util/arena.h"
 
 #include "webfuse/impl/jsonrpc/proxy.h"
 #include "webfuse/impl/jsonrpc/server.h"
@@ -33,6 +35,9 @@ struct wf_impl_session
     struct wf_slist_item item;
     struct lws * wsi;
     bool is_authenticated;
+    bool use_batch;
+    bool is_throttled;
+    size_t write_budget;
     struct wf_slist messages;
     struct wf_impl_authenticators * authenticators;
     struct wf_impl_mountpoint_factory * mountpoint_factory;
@@ -40,6 +45,8 @@ struct wf_impl_session
     struct wf_jsonrpc_proxy * rpc;
     struct wf_slist filesystems;
     struct wf_buffer recv_buffer; 
+    struct wf_arena arena;
+    struct wf_message_pool message_pool;
 };
 
 extern struct wf_impl_session * wf_impl_session_create(
@@ -56,7 +63,7 @@ extern bool wf_impl_session_authenticate(
     struct wf_impl_session * session,
     struct wf_credentials * creds);
 
-extern bool wf_impl_session_add_filesystem(
+extern struct wf_impl_filesystem * wf_impl_session_add_filesystem(
     struct wf_impl_session * session,
     char const * name);
 
@@ -64,18 +71,22 @@ extern void wf_impl_session_receive(
     struct wf_impl_session * session,
     char * data,
     size_t length,
-    bool is_final_fragment);
+    bool is_final_fragment,
+    bool is_binary);
 
-extern void wf_impl_session_onwritable(
-    struct wf_impl_session * session);
+extern void wf_impl_session_set_write_budget(
+    struct wf_impl_session * session,
+    size_t write_budget);
 
-extern bool wf_impl_session_contains_wsi(
+extern void wf_impl_session_set_request_window(
     struct wf_impl_session * session,
-    struct lws * wsi);
+    size_t request_window);
 
-extern void wf_impl_session_process_filesystem_request(
-    struct wf_impl_session * session, 
-    struct lws * wsi);
+extern size_t wf_impl_session_pending_requests(
+    struct wf_impl_session * session);
+
+extern void wf_impl_session_onwritable(
+    struct wf_impl_session * session);
 
 
 #ifdef __cplusplus
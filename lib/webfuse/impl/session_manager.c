@@ -2,11 +2,77 @@
 #include "webfuse/impl/util/util.h"
 #include "webfuse/impl/util/container_of.h"
 #include <stddef.h>
+#include <stdlib.h>
+
+// Each wsi of a session (the websocket and the raw fds of its filesystems)
+// is routed by a hash of the wsi pointer, so lws callbacks find their
+// session in O(1) regardless of the number of sessions.
+struct wf_impl_session_manager_route
+{
+    struct wf_hashmap_item item;
+    struct wf_impl_session * session;
+    struct wf_impl_filesystem * filesystem;
+};
+
+static uint64_t wf_impl_session_manager_key(
+    struct lws * wsi)
+{
+    return (uint64_t) ((uintptr_t) wsi);
+}
+
+static void wf_impl_session_manager_add_route(
+    struct wf_impl_session_manager * manager,
+    struct lws * wsi,
+    struct wf_impl_session * session,
+    struct wf_impl_filesystem * filesystem)
+{
+    struct wf_impl_session_manager_route * route = malloc(sizeof(struct wf_impl_session_manager_route));
+    route->session = session;
+    route->filesystem = filesystem;
+
+    wf_impl_hashmap_add(&manager->routes, &route->item, wf_impl_session_manager_key(wsi));
+}
+
+static struct wf_impl_session_manager_route * wf_impl_session_manager_get_route(
+    struct wf_impl_session_manager * manager,
+    struct lws * wsi)
+{
+    struct wf_hashmap_item * item = wf_impl_hashmap_get(&manager->routes, wf_impl_session_manager_key(wsi));
+    return (NULL != item) ? wf_container_of(item, struct wf_impl_session_manager_route, item) : NULL;
+}
+
+static void wf_impl_session_manager_remove_route(
+    struct wf_impl_session_manager * manager,
+    struct lws * wsi)
+{
+    struct wf_hashmap_item * item = wf_impl_hashmap_remove(&manager->routes, wf_impl_session_manager_key(wsi));
+    if (NULL != item)
+    {
+        free(wf_container_of(item, struct wf_impl_session_manager_route, item));
+    }
+}
+
+static void wf_impl_session_manager_remove_routes(
+    struct wf_impl_session_manager * manager,
+    struct wf_impl_session * session)
+{
+    struct wf_slist_item * item = wf_impl_slist_first(&session->filesystems);
+    while (NULL != item)
+    {
+        struct wf_impl_filesystem * filesystem = wf_container_of(item, struct wf_impl_filesystem, item);
+        wf_impl_session_manager_remove_route(manager, filesystem->wsi);
+
+        item = item->next;
+    }
+
+    wf_impl_session_manager_remove_route(manager, session->wsi);
+}
 
 void wf_impl_session_manager_init(
     struct wf_impl_session_manager * manager)
 {
     wf_impl_slist_init(&manager->sessions);
+    wf_impl_hashmap_init(&manager->routes);
 }
 
 void wf_impl_session_manager_cleanup(
@@ -17,10 +83,13 @@ void wf_impl_session_manager_cleanup(
     {
         struct wf_slist_item * next = item->next;
         struct wf_impl_session * session = wf_container_of(item, struct wf_impl_session, item);
+        wf_impl_session_manager_remove_routes(manager, session);
         wf_impl_session_dispose(session);
 
         item = next;
     }
+
+    wf_impl_hashmap_cleanup(&manager->routes);
 }
 
 struct wf_impl_session * wf_impl_session_manager_add(
@@ -34,6 +103,7 @@ struct wf_impl_session * wf_impl_session_manager_add(
     struct wf_impl_session * session = wf_impl_session_create(
         wsi, authenticators, timer_manager, server, mountpoint_factory); 
     wf_impl_slist_append(&manager->sessions, &session->item);
+    wf_impl_session_manager_add_route(manager, wsi, session, NULL);
 
     return session;
 }
@@ -42,35 +112,40 @@ struct wf_impl_session * wf_impl_session_manager_get(
     struct wf_impl_session_manager * manager,
     struct lws * wsi)
 {
-    struct wf_impl_session * session = NULL;
-
-    struct wf_slist_item * item = wf_impl_slist_first(&manager->sessions);
-    while (NULL != item)
-    {
-        struct wf_slist_item * next = item->next;
-        struct wf_impl_session * current = wf_container_of(item, struct wf_impl_session, item);
-
-        if (wf_impl_session_contains_wsi(current, wsi)) {
-            session = current;
-            break;
-        }
+    struct wf_impl_session_manager_route * route = wf_impl_session_manager_get_route(manager, wsi);
+    return (NULL != route) ? route->session : NULL;
+}
 
-        item = next;
-    }
+void wf_impl_session_manager_add_filesystem(
+    struct wf_impl_session_manager * manager,
+    struct wf_impl_session * session,
+    struct wf_impl_filesystem * filesystem)
+{
+    wf_impl_session_manager_add_route(manager, filesystem->wsi, session, filesystem);
+}
 
-    return session;
+struct wf_impl_filesystem * wf_impl_session_manager_get_filesystem(
+    struct wf_impl_session_manager * manager,
+    struct lws * wsi)
+{
+    struct wf_impl_session_manager_route * route = wf_impl_session_manager_get_route(manager, wsi);
+    return (NULL != route) ? route->filesystem : NULL;
 }
 
 void wf_impl_session_manager_remove(
     struct wf_impl_session_manager * manager,
     struct lws * wsi)
 {
+    struct wf_impl_session_manager_route * route = wf_impl_session_manager_get_route(manager, wsi);
+    if ((NULL == route) || (NULL != route->filesystem)) { return; }
+
+    struct wf_impl_session * session = route->session;
+    wf_impl_session_manager_remove_routes(manager, session);
+
     struct wf_slist_item * prev = &manager->sessions.head;
     while (NULL != prev->next)
     {
-        struct wf_slist_item * item = prev->next;
-        struct wf_impl_session * session = wf_container_of(item, struct wf_impl_session, item);
-        if (wsi == session->wsi)
+        if (&session->item == prev->next)
         {
             wf_impl_slist_remove_after(&manager->sessions, prev);
             wf_impl_session_dispose(session);
@@ -80,3 +155,20 @@ void wf_impl_session_manager_remove(
         prev = prev->next;
     }
 }
+
+size_t wf_impl_session_manager_pending_requests(
+    struct wf_impl_session_manager * manager)
+{
+    size_t result = 0;
+
+    struct wf_slist_item * item = wf_impl_slist_first(&manager->sessions);
+    while (NULL != item)
+    {
+        struct wf_impl_session * session = wf_container_of(item, struct wf_impl_session, item);
+        result += wf_impl_session_pending_requests(session);
+
+        item = item->next;
+    }
+
+    return result;
+}
@@ -8,6 +8,7 @@
 #include "webfuse/impl/session.h"
 #include "webfuse/impl/fuse_wrapper.h"
 #include "webfuse/impl/util/slist.h"
+#include "webfuse/impl/util/hashmap.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -21,6 +22,7 @@ struct wf_jsonrpc_server;
 struct wf_impl_session_manager
 {
     struct wf_slist sessions;
+    struct wf_hashmap routes;
 };
 
 extern void wf_impl_session_manager_init(
@@ -41,10 +43,22 @@ extern struct wf_impl_session * wf_impl_session_manager_get(
     struct wf_impl_session_manager * manager,
     struct lws * wsi);
 
+extern void wf_impl_session_manager_add_filesystem(
+    struct wf_impl_session_manager * manager,
+    struct wf_impl_session * session,
+    struct wf_impl_filesystem * filesystem);
+
+extern struct wf_impl_filesystem * wf_impl_session_manager_get_filesystem(
+    struct wf_impl_session_manager * manager,
+    struct lws * wsi);
+
 extern void wf_impl_session_manager_remove(
     struct wf_impl_session_manager * manager,
     struct lws * wsi);
 
+extern size_t wf_impl_session_manager_pending_requests(
+    struct wf_impl_session_manager * manager);
+
 #ifdef __cplusplus
 }
 #endif
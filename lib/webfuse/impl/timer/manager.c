@@ -1,20 +1,134 @@
 #include "webfuse/impl/timer/manager_intern.h"
 #include "webfuse/impl/timer/timer_intern.h"
 #include "webfuse/impl/timer/timepoint.h"
+#include "webfuse/impl/util/container_of.h"
 
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
+#include <libwebsockets.h>
 
+#define WF_TIMER_MANAGER_INITIAL_CAPACITY 16
+
+// Armed timers are kept in a binary min-heap ordered by timeout,
+// so the next timeout is always found at index 0.
 struct wf_timer_manager
 {
-    struct wf_timer * timers;
+    struct wf_timer * * timers;
+    size_t size;
+    size_t capacity;
+    struct lws_context * context;
+    lws_sorted_usec_list_t sul;
 };
 
+static bool
+wf_impl_timer_manager_is_before(
+    struct wf_timer const * timer,
+    struct wf_timer const * other)
+{
+    return (0 > ((wf_timer_timediff) (timer->timeout - other->timeout)));
+}
+
+static void
+wf_impl_timer_manager_set(
+    struct wf_timer_manager * manager,
+    size_t index,
+    struct wf_timer * timer)
+{
+    manager->timers[index] = timer;
+    timer->index = index;
+}
+
+static void
+wf_impl_timer_manager_sift_up(
+    struct wf_timer_manager * manager,
+    size_t index)
+{
+    struct wf_timer * timer = manager->timers[index];
+    while (0 < index)
+    {
+        size_t const parent = (index - 1) / 2;
+        if (!wf_impl_timer_manager_is_before(timer, manager->timers[parent]))
+        {
+            break;
+        }
+
+        wf_impl_timer_manager_set(manager, index, manager->timers[parent]);
+        index = parent;
+    }
+
+    wf_impl_timer_manager_set(manager, index, timer);
+}
+
+static void
+wf_impl_timer_manager_sift_down(
+    struct wf_timer_manager * manager,
+    size_t index)
+{
+    struct wf_timer * timer = manager->timers[index];
+    while (true)
+    {
+        size_t child = (2 * index) + 1;
+        if (child >= manager->size)
+        {
+            break;
+        }
+
+        if (((child + 1) < manager->size) &&
+            (wf_impl_timer_manager_is_before(manager->timers[child + 1], manager->timers[child])))
+        {
+            child++;
+        }
+
+        if (!wf_impl_timer_manager_is_before(manager->timers[child], timer))
+        {
+            break;
+        }
+
+        wf_impl_timer_manager_set(manager, index, manager->timers[child]);
+        index = child;
+    }
+
+    wf_impl_timer_manager_set(manager, index, timer);
+}
+
+static void
+wf_impl_timer_manager_on_sul(
+    lws_sorted_usec_list_t * sul)
+{
+    struct wf_timer_manager * manager = wf_container_of(sul, struct wf_timer_manager, sul);
+    wf_impl_timer_manager_check(manager);
+}
+
+// lws wakes the service loop when the next timer is due;
+// there is nothing to schedule without an lws context (e.g. in unit tests)
+static void
+wf_impl_timer_manager_schedule(
+    struct wf_timer_manager * manager,
+    wf_timer_timepoint now)
+{
+    if ((NULL != manager->context) && (0 < manager->size))
+    {
+        wf_timer_timediff delay = (wf_timer_timediff) (manager->timers[0]->timeout - now);
+        if (0 > delay)
+        {
+            delay = 0;
+        }
+
+        lws_sul_schedule(manager->context, 0, &manager->sul,
+            &wf_impl_timer_manager_on_sul, ((lws_usec_t) (delay + 1)) * LWS_US_PER_MS);
+    }
+}
+
 struct wf_timer_manager *
 wf_impl_timer_manager_create(void)
 {
     struct wf_timer_manager * manager = malloc(sizeof(struct wf_timer_manager));
     manager->timers = NULL;
+    manager->size = 0;
+    manager->capacity = 0;
+    manager->context = NULL;
+    memset(&manager->sul, 0, sizeof(manager->sul));
 
     return manager;
 }
@@ -23,71 +137,93 @@ void
 wf_impl_timer_manager_dispose(
     struct wf_timer_manager * manager)
 {
-    struct wf_timer * timer = manager->timers;
-    while (NULL != timer)
-    {
-        struct wf_timer * next = timer->next;
+    wf_impl_timer_manager_set_context(manager, NULL);
 
+    while (0 < manager->size)
+    {
+        struct wf_timer * timer = manager->timers[0];
+        wf_impl_timer_manager_removetimer(manager, timer);
         wf_impl_timer_trigger(timer);
-        timer = next;
     }
 
+    free(manager->timers);
     free(manager);
 }
 
+void
+wf_impl_timer_manager_set_context(
+    struct wf_timer_manager * manager,
+    struct lws_context * context)
+{
+    if (NULL != manager->context)
+    {
+        lws_sul_schedule(manager->context, 0, &manager->sul,
+            &wf_impl_timer_manager_on_sul, LWS_SET_TIMER_USEC_CANCEL);
+    }
+
+    manager->context = context;
+    wf_impl_timer_manager_schedule(manager, wf_impl_timer_timepoint_now());
+}
 
 void wf_impl_timer_manager_check(
     struct wf_timer_manager * manager)
 {
-    struct wf_timer * timer = manager->timers;
-    while (NULL != timer)
-    {
-        struct wf_timer * next = timer->next;
+    if (0 == manager->size) { return; }
 
-        if (wf_impl_timer_is_timeout(timer))
-        {
-            wf_impl_timer_manager_removetimer(manager, timer);
-            wf_impl_timer_trigger(timer);
-        }
+    wf_timer_timepoint const now = wf_impl_timer_timepoint_now();
+    while ((0 < manager->size) && (0 > ((wf_timer_timediff) (manager->timers[0]->timeout - now))))
+    {
+        struct wf_timer * timer = manager->timers[0];
+        wf_impl_timer_manager_removetimer(manager, timer);
+        wf_impl_timer_trigger(timer);
+    }
 
-        timer = next;
-    }    
+    wf_impl_timer_manager_schedule(manager, now);
 }
 
 void wf_impl_timer_manager_addtimer(
     struct wf_timer_manager * manager,
     struct wf_timer * timer)
 {
-    if (NULL != manager->timers)
+    if (WF_IMPL_TIMER_NOT_ARMED != timer->index)
+    {
+        wf_impl_timer_manager_removetimer(manager, timer);
+    }
+
+    if (manager->size >= manager->capacity)
     {
-        manager->timers->prev = timer;
+        manager->capacity = (0 < manager->capacity) ? (manager->capacity * 2) : WF_TIMER_MANAGER_INITIAL_CAPACITY;
+        manager->timers = realloc(manager->timers, manager->capacity * sizeof(struct wf_timer *));
     }
 
-    timer->next = manager->timers;
-    timer->prev = NULL;
-    manager->timers = timer;
+    size_t const index = manager->size;
+    manager->size++;
+    wf_impl_timer_manager_set(manager, index, timer);
+    wf_impl_timer_manager_sift_up(manager, index);
+
+    // a new first timer must be scheduled earlier; otherwise the pending
+    // schedule stays valid
+    if (0 == timer->index)
+    {
+        wf_impl_timer_manager_schedule(manager, wf_impl_timer_timepoint_now());
+    }
 }
 
 void wf_impl_timer_manager_removetimer(
     struct wf_timer_manager * manager,
     struct wf_timer * timer)
 {
-    struct wf_timer * prev = timer->prev;
-    struct wf_timer * next = timer->next;
+    size_t const index = timer->index;
+    if (WF_IMPL_TIMER_NOT_ARMED == index) { return; }
 
-    if (NULL != prev)
-    {
-        prev->next = next;
-    }
+    timer->index = WF_IMPL_TIMER_NOT_ARMED;
+    manager->size--;
 
-    if (NULL != next)
+    if (index < manager->size)
     {
-        next->prev = prev;
-    }
-
-    if (manager->timers == timer)
-    {
-        manager->timers = next;
+        struct wf_timer * last = manager->timers[manager->size];
+        wf_impl_timer_manager_set(manager, index, last);
+        wf_impl_timer_manager_sift_up(manager, index);
+        wf_impl_timer_manager_sift_down(manager, last->index);
     }
 }
-
@@ -7,6 +7,7 @@ extern "C"
 #endif
 
 struct wf_timer_manager;
+struct lws_context;
 
 extern struct wf_timer_manager * 
 wf_impl_timer_manager_create(void);
@@ -19,6 +20,11 @@ extern void
 wf_impl_timer_manager_check(
     struct wf_timer_manager * manager);
 
+extern void
+wf_impl_timer_manager_set_context(
+    struct wf_timer_manager * manager,
+    struct lws_context * context);
+
 #ifdef __cplusplus
 }
 #endif
@@ -17,8 +17,7 @@ wf_impl_timer_create(
     timer->timeout = 0;
     timer->on_timer = on_timer;
     timer->user_data = user_data;
-    timer->prev = NULL;
-    timer->next = NULL;
+    timer->index = WF_IMPL_TIMER_NOT_ARMED;
 
     return timer;
 }
@@ -59,9 +58,6 @@ void wf_impl_timer_trigger(
 {
     if (0 != timer->on_timer)
     {
-        timer->prev = NULL;
-        timer->next = NULL;
-
         timer->on_timer(timer, timer->user_data);
     }
 }
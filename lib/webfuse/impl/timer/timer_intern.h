@@ -7,6 +7,10 @@
 
 #ifndef __cplusplus
 #include <stdbool.h>
+#include <stddef.h>
+#else
+#include <cstddef>
+using std::size_t;
 #endif
 
 #ifdef __cplusplus
@@ -14,14 +18,15 @@ extern "C"
 {
 #endif
 
+#define WF_IMPL_TIMER_NOT_ARMED ((size_t) -1)
+
 struct wf_timer
 {
     struct wf_timer_manager * manager;
     wf_timer_timepoint timeout;
     wf_timer_on_timer_fn * on_timer;
     void * user_data;
-    struct wf_timer * next;
-    struct wf_timer * prev;
+    size_t index;
 };
 
 extern bool wf_impl_timer_is_timeout(
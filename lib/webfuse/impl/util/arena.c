@@ -0,0 +1,166 @@
+#include "webfuse/impl/util/arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define WF_ARENA_ALIGNMENT ((size_t) 16)
+#define WF_ARENA_ALIGN(size) (((size) + (WF_ARENA_ALIGNMENT - 1)) & ~(WF_ARENA_ALIGNMENT - 1))
+#define WF_ARENA_HEADER_SIZE WF_ARENA_ALIGN(sizeof(struct wf_arena_block))
+
+struct wf_arena_block
+{
+    struct wf_arena_block * prev;
+    size_t size;
+};
+
+static char * wf_impl_arena_block_data(
+    struct wf_arena_block * block)
+{
+    return ((char *) block) + WF_ARENA_HEADER_SIZE;
+}
+
+static void wf_impl_arena_free_blocks(
+    struct wf_arena * arena)
+{
+    struct wf_arena_block * block = arena->block;
+    while (NULL != block)
+    {
+        struct wf_arena_block * prev = block->prev;
+        free(block);
+        block = prev;
+    }
+
+    arena->block = NULL;
+}
+
+static void wf_impl_arena_add_block(
+    struct wf_arena * arena,
+    size_t size)
+{
+    struct wf_arena_block * block = malloc(WF_ARENA_HEADER_SIZE + size);
+    block->prev = arena->block;
+    block->size = size;
+
+    arena->block = block;
+    arena->offset = 0;
+}
+
+void wf_impl_arena_init(
+    struct wf_arena * arena,
+    size_t initial_size)
+{
+    arena->block = NULL;
+    arena->offset = 0;
+    arena->last = NULL;
+    arena->used = 0;
+    arena->high_water = 0;
+    arena->initial_size = WF_ARENA_ALIGN(initial_size);
+}
+
+void wf_impl_arena_cleanup(
+    struct wf_arena * arena)
+{
+    wf_impl_arena_free_blocks(arena);
+    arena->offset = 0;
+    arena->last = NULL;
+    arena->used = 0;
+}
+
+void * wf_impl_arena_alloc(
+    struct wf_arena * arena,
+    size_t size)
+{
+    size = WF_ARENA_ALIGN(size);
+
+    if ((NULL == arena->block) || ((arena->block->size - arena->offset) < size))
+    {
+        size_t block_size = (NULL != arena->block) ? (2 * arena->block->size) : arena->initial_size;
+        if (block_size < size)
+        {
+            block_size = size;
+        }
+
+        wf_impl_arena_add_block(arena, block_size);
+    }
+
+    void * result = wf_impl_arena_block_data(arena->block) + arena->offset;
+    arena->offset += size;
+    arena->used += size;
+    arena->last = result;
+
+    return result;
+}
+
+void * wf_impl_arena_realloc(
+    struct wf_arena * arena,
+    void * data,
+    size_t old_size,
+    size_t new_size)
+{
+    old_size = WF_ARENA_ALIGN(old_size);
+    new_size = WF_ARENA_ALIGN(new_size);
+    if ((NULL != data) && (new_size <= old_size))
+    {
+        return data;
+    }
+
+    // the most recent allocation can grow in place
+    if ((NULL != data) && (data == arena->last) &&
+        ((arena->block->size - arena->offset) >= (new_size - old_size)))
+    {
+        arena->offset += new_size - old_size;
+        arena->used += new_size - old_size;
+        return data;
+    }
+
+    void * result = wf_impl_arena_alloc(arena, new_size);
+    if (NULL != data)
+    {
+        memcpy(result, data, old_size);
+    }
+
+    return result;
+}
+
+// The high-water mark halves on each reset, unless it is renewed by the
+// memory used since the last reset. A block much larger than the mark is
+// shrunk, so that a single large message does not keep its memory for
+// the lifetime of the arena.
+void wf_impl_arena_reset(
+    struct wf_arena * arena)
+{
+    size_t const decayed = arena->high_water / 2;
+    arena->high_water = (arena->used > decayed) ? arena->used : decayed;
+
+    size_t block_size = WF_ARENA_ALIGN(arena->high_water);
+    if (block_size < arena->initial_size)
+    {
+        block_size = arena->initial_size;
+    }
+
+    if ((NULL != arena->block) &&
+        ((NULL != arena->block->prev) || ((2 * block_size) < arena->block->size)))
+    {
+        wf_impl_arena_free_blocks(arena);
+        wf_impl_arena_add_block(arena, block_size);
+    }
+
+    arena->offset = 0;
+    arena->last = NULL;
+    arena->used = 0;
+}
+
+size_t wf_impl_arena_capacity(
+    struct wf_arena * arena)
+{
+    size_t result = 0;
+
+    struct wf_arena_block * block = arena->block;
+    while (NULL != block)
+    {
+        result += block->size;
+        block = block->prev;
+    }
+
+    return result;
+}
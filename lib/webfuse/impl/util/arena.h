@@ -0,0 +1,62 @@
+#ifndef WF_IMPL_UTIL_ARENA_H
+#define WF_IMPL_UTIL_ARENA_H
+
+#ifndef __cplusplus
+#include <stddef.h>
+#else
+#include <cstddef>
+using std::size_t;
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{ 
+#endif
+
+struct wf_arena_block;
+
+// Bump allocator for short lived data, such as parsed messages.
+//
+// Memory is released all at once by wf_impl_arena_reset. When an arena
+// needed more than one block since the last reset, the blocks are
+// replaced by a single block sized to the high-water mark, so an arena
+// in steady state does not call malloc at all. The high-water mark
+// decays over resets, so memory of rare large messages is given back.
+struct wf_arena
+{
+    struct wf_arena_block * block;
+    size_t offset;
+    void * last;
+    size_t used;
+    size_t high_water;
+    size_t initial_size;
+};
+
+extern void wf_impl_arena_init(
+    struct wf_arena * arena,
+    size_t initial_size);
+
+extern void wf_impl_arena_cleanup(
+    struct wf_arena * arena);
+
+extern void * wf_impl_arena_alloc(
+    struct wf_arena * arena,
+    size_t size);
+
+extern void * wf_impl_arena_realloc(
+    struct wf_arena * arena,
+    void * data,
+    size_t old_size,
+    size_t new_size);
+
+extern void wf_impl_arena_reset(
+    struct wf_arena * arena);
+
+extern size_t wf_impl_arena_capacity(
+    struct wf_arena * arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,11 +1,13 @@
 #include "webfuse/impl/util/base64.h"
+#include "webfuse/impl/util/base64_simd.h"
+#include "webfuse/impl/util/cpu.h"
 
 static const uint8_t wf_impl_base64_decode_table[256] = {
     // 0     1     2     3     4     5     6     7     8      9    A     B     C     D     E     F  
     0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // 0
     0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // 1
     0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,   62, 0x80, 0x80, 0x80,   63, // 2
-      52,   53,   54,   55,   56,   57,   58,   59,   60,   61, 0x80, 0x80, 0x80,    0, 0x80, 0x80, // 3
+      52,   53,   54,   55,   56,   57,   58,   59,   60,   61, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, // 3
     0x80,    0,    1,    2,    3,    4,    5,    6,    7,    8,    9,   10,   11,   12,   13,   14, // 4
       15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25, 0x80, 0x80, 0x80, 0x80, 0x80, // 5
     0x80,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40, // 6
@@ -98,7 +100,67 @@ size_t wf_impl_base64_decoded_size(char const * data, size_t length)
     return result;
 }
 
-size_t wf_impl_base64_decode(
+struct wf_impl_base64_variant_info
+{
+    char const * name;
+    enum wf_impl_cpu_feature feature;
+    wf_impl_base64_decode_kernel_fn * decode;
+    wf_impl_base64_validate_kernel_fn * validate;
+};
+
+static struct wf_impl_base64_variant_info const wf_impl_base64_variants[] =
+{
+    [WF_IMPL_BASE64_SCALAR] = {"scalar", WF_IMPL_CPU_BASELINE, NULL, NULL},
+#if defined(WF_IMPL_BASE64_HAVE_X86)
+    [WF_IMPL_BASE64_SSSE3] = {"ssse3", WF_IMPL_CPU_SSSE3, &wf_impl_base64_decode_ssse3, &wf_impl_base64_validate_ssse3},
+    [WF_IMPL_BASE64_AVX2] = {"avx2", WF_IMPL_CPU_AVX2, &wf_impl_base64_decode_avx2, &wf_impl_base64_validate_avx2},
+#else
+    [WF_IMPL_BASE64_SSSE3] = {"ssse3", WF_IMPL_CPU_SSSE3, NULL, NULL},
+    [WF_IMPL_BASE64_AVX2] = {"avx2", WF_IMPL_CPU_AVX2, NULL, NULL},
+#endif
+#if defined(WF_IMPL_BASE64_HAVE_NEON)
+    [WF_IMPL_BASE64_NEON] = {"neon", WF_IMPL_CPU_NEON, &wf_impl_base64_decode_neon, &wf_impl_base64_validate_neon}
+#else
+    [WF_IMPL_BASE64_NEON] = {"neon", WF_IMPL_CPU_NEON, NULL, NULL}
+#endif
+};
+
+static int wf_impl_base64_best_variant = -1;
+
+bool wf_impl_base64_variant_supported(
+    enum wf_impl_base64_variant variant)
+{
+    struct wf_impl_base64_variant_info const * info = &wf_impl_base64_variants[variant];
+    return ((WF_IMPL_BASE64_SCALAR == variant) || (NULL != info->decode)) && (wf_impl_cpu_supports(info->feature));
+}
+
+static bool wf_impl_base64_is_supported(
+    int variant)
+{
+    return wf_impl_base64_variant_supported((enum wf_impl_base64_variant) variant);
+}
+
+char const * wf_impl_base64_variant_name(
+    enum wf_impl_base64_variant variant)
+{
+    return wf_impl_base64_variants[variant].name;
+}
+
+enum wf_impl_base64_variant wf_impl_base64_get_variant(void)
+{
+    static int const candidates[] =
+    {
+        WF_IMPL_BASE64_AVX2,
+        WF_IMPL_BASE64_NEON,
+        WF_IMPL_BASE64_SSSE3
+    };
+
+    return (enum wf_impl_base64_variant) wf_impl_cpu_select_variant(&wf_impl_base64_best_variant,
+        candidates, sizeof(candidates) / sizeof(candidates[0]), &wf_impl_base64_is_supported, WF_IMPL_BASE64_SCALAR);
+}
+
+size_t wf_impl_base64_decode_variant(
+    enum wf_impl_base64_variant variant,
     char const * data,
     size_t length,
     uint8_t * buffer,
@@ -111,14 +173,23 @@ size_t wf_impl_base64_decode(
         return 0;
     }
 
-    size_t out_pos = 0;
+    bool is_valid = true;
     size_t pos = 0;
-    for(; pos < length - 4; pos += 4)
+    wf_impl_base64_decode_kernel_fn * decode = wf_impl_base64_variants[variant].decode;
+    if (NULL != decode)
+    {
+        pos = decode(data, length, buffer, &is_valid);
+    }
+
+    size_t out_pos = (pos / 4) * 3;
+    uint8_t error = 0;
+    for(; (is_valid) && (pos < length - 4); pos += 4)
     {
         uint8_t a = table[ (unsigned char) data[pos    ] ];
         uint8_t b = table[ (unsigned char) data[pos + 1] ];
         uint8_t c = table[ (unsigned char) data[pos + 2] ];
         uint8_t d = table[ (unsigned char) data[pos + 3] ];
+        error |= a | b | c | d;
 
         buffer[out_pos++] = (a << 2) | (b >> 4);
         buffer[out_pos++] = (b << 4) | (c >> 2);
@@ -126,27 +197,47 @@ size_t wf_impl_base64_decode(
     }
 
     // decode last block
+    if (is_valid)
     {
+        bool const has_c = ('=' != data[pos + 2]);
+        bool const has_d = ('=' != data[pos + 3]);
         uint8_t a = table[ (unsigned char) data[pos    ] ];
         uint8_t b = table[ (unsigned char) data[pos + 1] ];
-        uint8_t c = table[ (unsigned char) data[pos + 2] ];
-        uint8_t d = table[ (unsigned char) data[pos + 3] ];
+        uint8_t c = (has_c) ? table[ (unsigned char) data[pos + 2] ] : 0;
+        uint8_t d = (has_d) ? table[ (unsigned char) data[pos + 3] ] : 0;
+        error |= a | b | c | d;
 
         buffer[out_pos++] = (a << 2) | (b >> 4);
-        if ('=' != data[pos + 2])
+        if (has_c)
         {
             buffer[out_pos++] = (b << 4) | (c >> 2);
-            if ('=' != data[pos + 3])
+            if (has_d)
             {
                 buffer[out_pos++] = (c << 6) | d;
             }
         }
+        else if (has_d)
+        {
+            is_valid = false;
+        }
     }
 
-    return out_pos;
+    return ((is_valid) && (0 == (error & 0x80))) ? out_pos : 0;
 }
 
-extern bool wf_impl_base64_isvalid(char const * data, size_t length)
+size_t wf_impl_base64_decode(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    size_t buffer_size)
+{
+    return wf_impl_base64_decode_variant(wf_impl_base64_get_variant(), data, length, buffer, buffer_size);
+}
+
+bool wf_impl_base64_isvalid_variant(
+    enum wf_impl_base64_variant variant,
+    char const * data,
+    size_t length)
 {
     uint8_t const * table = wf_impl_base64_decode_table;
 
@@ -155,11 +246,22 @@ extern bool wf_impl_base64_isvalid(char const * data, size_t length)
         return false;
     }
 
+    bool is_valid = true;
     size_t pos = 0;
+    wf_impl_base64_validate_kernel_fn * validate = wf_impl_base64_variants[variant].validate;
+    if (NULL != validate)
+    {
+        pos = validate(data, length, &is_valid);
+        if (!is_valid)
+        {
+            return false;
+        }
+    }
+
     for(; pos < (length - 2); pos++)
     {
         unsigned char c = (unsigned char) data[pos];
-        if (('=' == c) || (0x80 == table[c]))
+        if (0x80 == table[c])
         {
             return false;
         }
@@ -172,8 +274,8 @@ extern bool wf_impl_base64_isvalid(char const * data, size_t length)
 
     for(;pos < length; pos++)
     {
-        char c = data[pos];
-        if (0x80 == table[ (unsigned char) c])
+        unsigned char c = (unsigned char) data[pos];
+        if (('=' != c) && (0x80 == table[c]))
         {
             return false;
         }
@@ -181,3 +283,8 @@ extern bool wf_impl_base64_isvalid(char const * data, size_t length)
 
     return true;
 }
+
+bool wf_impl_base64_isvalid(char const * data, size_t length)
+{
+    return wf_impl_base64_isvalid_variant(wf_impl_base64_get_variant(), data, length);
+}
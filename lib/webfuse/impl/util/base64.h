@@ -15,6 +15,16 @@ extern "C"
 {
 #endif
 
+enum wf_impl_base64_variant
+{
+    WF_IMPL_BASE64_SCALAR,
+    WF_IMPL_BASE64_SSSE3,
+    WF_IMPL_BASE64_AVX2,
+    WF_IMPL_BASE64_NEON
+};
+
+#define WF_IMPL_BASE64_VARIANT_COUNT 4
+
 extern size_t wf_impl_base64_encoded_size(size_t length);
 
 extern size_t wf_impl_base64_encode(
@@ -33,6 +43,29 @@ extern size_t wf_impl_base64_decode(
 
 extern bool wf_impl_base64_isvalid(char const * data, size_t length);
 
+// Decoding and validation use the fastest variant supported by the CPU.
+// The variant specific functions are used by tests and benchmarks.
+
+extern enum wf_impl_base64_variant wf_impl_base64_get_variant(void);
+
+extern bool wf_impl_base64_variant_supported(
+    enum wf_impl_base64_variant variant);
+
+extern char const * wf_impl_base64_variant_name(
+    enum wf_impl_base64_variant variant);
+
+extern size_t wf_impl_base64_decode_variant(
+    enum wf_impl_base64_variant variant,
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    size_t buffer_size);
+
+extern bool wf_impl_base64_isvalid_variant(
+    enum wf_impl_base64_variant variant,
+    char const * data,
+    size_t length);
+
 #ifdef __cplusplus
 }
 #endif
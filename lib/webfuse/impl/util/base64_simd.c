@@ -0,0 +1,320 @@
+#include "webfuse/impl/util/base64_simd.h"
+
+#if defined(WF_IMPL_BASE64_HAVE_X86)
+
+#include <immintrin.h>
+
+// Characters are translated using their nibbles (see
+// http://0x80.pl/notesen/2016-01-17-sse-base64-decoding.html):
+// - lut_lo and lut_hi map low and high nibble to a bit set;
+//   a character is invalid, if both sets share a bit
+// - lut_roll maps the high nibble to the offset, which is added to
+//   the character to get its 6 bit value; '/' is handled separately
+
+#define WF_IMPL_BASE64_LUT_LO \
+    0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, \
+    0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+
+#define WF_IMPL_BASE64_LUT_HI \
+    0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, \
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+
+#define WF_IMPL_BASE64_LUT_ROLL \
+    0, 16, 19, 4, -65, -65, -71, -71, \
+    0, 0, 0, 0, 0, 0, 0, 0
+
+// 4 x 6 bit values per 32 bit lane are packed into 3 bytes (big endian)
+#define WF_IMPL_BASE64_PACK \
+    2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+
+__attribute__((target("ssse3")))
+static inline bool
+wf_impl_base64_translate_ssse3(
+    __m128i * values)
+{
+    __m128i const lut_lo = _mm_setr_epi8(WF_IMPL_BASE64_LUT_LO);
+    __m128i const lut_hi = _mm_setr_epi8(WF_IMPL_BASE64_LUT_HI);
+    __m128i const lut_roll = _mm_setr_epi8(WF_IMPL_BASE64_LUT_ROLL);
+    __m128i const mask_0f = _mm_set1_epi8(0x0f);
+    __m128i const mask_2f = _mm_set1_epi8(0x2f);
+
+    __m128i const str = *values;
+    __m128i const hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_0f);
+    __m128i const lo_nibbles = _mm_and_si128(str, mask_0f);
+    __m128i const hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    __m128i const lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+
+    __m128i const invalid = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128());
+    if (0xffff != _mm_movemask_epi8(invalid))
+    {
+        return false;
+    }
+
+    __m128i const eq_2f = _mm_cmpeq_epi8(str, mask_2f);
+    __m128i const roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+    *values = _mm_add_epi8(str, roll);
+
+    return true;
+}
+
+__attribute__((target("ssse3")))
+size_t
+wf_impl_base64_decode_ssse3(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    bool * is_valid)
+{
+    __m128i const pack = _mm_setr_epi8(WF_IMPL_BASE64_PACK);
+
+    size_t pos = 0;
+    size_t out_pos = 0;
+    while ((length - pos) >= 24)
+    {
+        __m128i values = _mm_loadu_si128((__m128i const *) &data[pos]);
+        if (!wf_impl_base64_translate_ssse3(&values))
+        {
+            *is_valid = false;
+            break;
+        }
+
+        values = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        values = _mm_madd_epi16(values, _mm_set1_epi32(0x00011000));
+        values = _mm_shuffle_epi8(values, pack);
+        _mm_storeu_si128((__m128i *) &buffer[out_pos], values);
+
+        pos += 16;
+        out_pos += 12;
+    }
+
+    return pos;
+}
+
+__attribute__((target("ssse3")))
+size_t
+wf_impl_base64_validate_ssse3(
+    char const * data,
+    size_t length,
+    bool * is_valid)
+{
+    size_t pos = 0;
+    while ((length - pos) >= 20)
+    {
+        __m128i values = _mm_loadu_si128((__m128i const *) &data[pos]);
+        if (!wf_impl_base64_translate_ssse3(&values))
+        {
+            *is_valid = false;
+            break;
+        }
+
+        pos += 16;
+    }
+
+    return pos;
+}
+
+__attribute__((target("avx2")))
+static inline bool
+wf_impl_base64_translate_avx2(
+    __m256i * values)
+{
+    __m256i const lut_lo = _mm256_setr_epi8(WF_IMPL_BASE64_LUT_LO, WF_IMPL_BASE64_LUT_LO);
+    __m256i const lut_hi = _mm256_setr_epi8(WF_IMPL_BASE64_LUT_HI, WF_IMPL_BASE64_LUT_HI);
+    __m256i const lut_roll = _mm256_setr_epi8(WF_IMPL_BASE64_LUT_ROLL, WF_IMPL_BASE64_LUT_ROLL);
+    __m256i const mask_0f = _mm256_set1_epi8(0x0f);
+    __m256i const mask_2f = _mm256_set1_epi8(0x2f);
+
+    __m256i const str = *values;
+    __m256i const hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_0f);
+    __m256i const lo_nibbles = _mm256_and_si256(str, mask_0f);
+    __m256i const hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+    __m256i const lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+
+    if (!_mm256_testz_si256(lo, hi))
+    {
+        return false;
+    }
+
+    __m256i const eq_2f = _mm256_cmpeq_epi8(str, mask_2f);
+    __m256i const roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+    *values = _mm256_add_epi8(str, roll);
+
+    return true;
+}
+
+__attribute__((target("avx2")))
+size_t
+wf_impl_base64_decode_avx2(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    bool * is_valid)
+{
+    __m256i const pack = _mm256_setr_epi8(WF_IMPL_BASE64_PACK, WF_IMPL_BASE64_PACK);
+    __m256i const join = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+    size_t pos = 0;
+    size_t out_pos = 0;
+    while ((length - pos) >= 48)
+    {
+        __m256i values = _mm256_loadu_si256((__m256i const *) &data[pos]);
+        if (!wf_impl_base64_translate_avx2(&values))
+        {
+            *is_valid = false;
+            break;
+        }
+
+        values = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        values = _mm256_madd_epi16(values, _mm256_set1_epi32(0x00011000));
+        values = _mm256_shuffle_epi8(values, pack);
+        values = _mm256_permutevar8x32_epi32(values, join);
+        _mm256_storeu_si256((__m256i *) &buffer[out_pos], values);
+
+        pos += 32;
+        out_pos += 24;
+    }
+
+    return pos;
+}
+
+__attribute__((target("avx2")))
+size_t
+wf_impl_base64_validate_avx2(
+    char const * data,
+    size_t length,
+    bool * is_valid)
+{
+    size_t pos = 0;
+    while ((length - pos) >= 36)
+    {
+        __m256i values = _mm256_loadu_si256((__m256i const *) &data[pos]);
+        if (!wf_impl_base64_translate_avx2(&values))
+        {
+            *is_valid = false;
+            break;
+        }
+
+        pos += 32;
+    }
+
+    return pos;
+}
+
+#endif
+
+#if defined(WF_IMPL_BASE64_HAVE_NEON)
+
+#include <arm_neon.h>
+
+// 6 bit values of characters 0..63 and 64..127; 0xff marks invalid characters
+static uint8_t const wf_impl_base64_neon_lut_lo[64] =
+{
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,   62, 0xff, 0xff, 0xff,   63,
+      52,   53,   54,   55,   56,   57,   58,   59,   60,   61, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+static uint8_t const wf_impl_base64_neon_lut_hi[64] =
+{
+    0xff,    0,    1,    2,    3,    4,    5,    6,    7,    8,    9,   10,   11,   12,   13,   14,
+      15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+      41,   42,   43,   44,   45,   46,   47,   48,   49,   50,   51, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+static inline uint8x16x4_t
+wf_impl_base64_neon_load_lut(
+    uint8_t const * lut)
+{
+    uint8x16x4_t result;
+    result.val[0] = vld1q_u8(&lut[ 0]);
+    result.val[1] = vld1q_u8(&lut[16]);
+    result.val[2] = vld1q_u8(&lut[32]);
+    result.val[3] = vld1q_u8(&lut[48]);
+
+    return result;
+}
+
+// characters 0..63 are looked up in lut_lo, 64..127 in lut_hi;
+// characters above 127 keep their high bit set and are invalid
+static inline uint8x16_t
+wf_impl_base64_neon_translate(
+    uint8x16x4_t const * lut_lo,
+    uint8x16x4_t const * lut_hi,
+    uint8x16_t str,
+    uint8x16_t * error)
+{
+    uint8x16_t result = vqtbl4q_u8(*lut_lo, str);
+    result = vqtbx4q_u8(result, *lut_hi, vsubq_u8(str, vdupq_n_u8(64)));
+    *error = vorrq_u8(*error, vorrq_u8(result, str));
+
+    return result;
+}
+
+size_t
+wf_impl_base64_decode_neon(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    bool * is_valid)
+{
+    uint8x16x4_t const lut_lo = wf_impl_base64_neon_load_lut(wf_impl_base64_neon_lut_lo);
+    uint8x16x4_t const lut_hi = wf_impl_base64_neon_load_lut(wf_impl_base64_neon_lut_hi);
+
+    size_t pos = 0;
+    size_t out_pos = 0;
+    while ((length - pos) >= 68)
+    {
+        uint8x16x4_t str = vld4q_u8((uint8_t const *) &data[pos]);
+        uint8x16_t error = vdupq_n_u8(0);
+        uint8x16_t const a = wf_impl_base64_neon_translate(&lut_lo, &lut_hi, str.val[0], &error);
+        uint8x16_t const b = wf_impl_base64_neon_translate(&lut_lo, &lut_hi, str.val[1], &error);
+        uint8x16_t const c = wf_impl_base64_neon_translate(&lut_lo, &lut_hi, str.val[2], &error);
+        uint8x16_t const d = wf_impl_base64_neon_translate(&lut_lo, &lut_hi, str.val[3], &error);
+        if (0 != (vmaxvq_u8(error) & 0x80))
+        {
+            *is_valid = false;
+            break;
+        }
+
+        uint8x16x3_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+        vst3q_u8(&buffer[out_pos], out);
+
+        pos += 64;
+        out_pos += 48;
+    }
+
+    return pos;
+}
+
+size_t
+wf_impl_base64_validate_neon(
+    char const * data,
+    size_t length,
+    bool * is_valid)
+{
+    uint8x16x4_t const lut_lo = wf_impl_base64_neon_load_lut(wf_impl_base64_neon_lut_lo);
+    uint8x16x4_t const lut_hi = wf_impl_base64_neon_load_lut(wf_impl_base64_neon_lut_hi);
+
+    size_t pos = 0;
+    while ((length - pos) >= 20)
+    {
+        uint8x16_t error = vdupq_n_u8(0);
+        wf_impl_base64_neon_translate(&lut_lo, &lut_hi, vld1q_u8((uint8_t const *) &data[pos]), &error);
+        if (0 != (vmaxvq_u8(error) & 0x80))
+        {
+            *is_valid = false;
+            break;
+        }
+
+        pos += 16;
+    }
+
+    return pos;
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef WF_IMPL_UTIL_BASE64_SIMD_H
+#define WF_IMPL_UTIL_BASE64_SIMD_H
+
+#ifndef __cplusplus
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdbool.h>
+#else
+#include <cinttypes>
+#include <cstddef>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Vectorized kernels process the bulk of base64 encoded data.
+//
+// Each kernel consumes complete blocks only and leaves at least the last
+// quad (which may contain padding) to the scalar implementation.
+// Kernels return the number of consumed characters, which is always a
+// multiple of 4; the number of written bytes is consumed / 4 * 3.
+// Padding characters are treated as invalid.
+//
+// Decode kernels may write up to 8 bytes beyond the decoded data, but never
+// beyond decoded size of the whole input. Therefore they support in-place
+// decoding (buffer == data).
+
+typedef size_t
+wf_impl_base64_decode_kernel_fn(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    bool * is_valid);
+
+typedef size_t
+wf_impl_base64_validate_kernel_fn(
+    char const * data,
+    size_t length,
+    bool * is_valid);
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#define WF_IMPL_BASE64_HAVE_X86
+
+extern size_t
+wf_impl_base64_decode_ssse3(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    bool * is_valid);
+
+extern size_t
+wf_impl_base64_validate_ssse3(
+    char const * data,
+    size_t length,
+    bool * is_valid);
+
+extern size_t
+wf_impl_base64_decode_avx2(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    bool * is_valid);
+
+extern size_t
+wf_impl_base64_validate_avx2(
+    char const * data,
+    size_t length,
+    bool * is_valid);
+
+#endif
+
+#if defined(__aarch64__)
+
+#define WF_IMPL_BASE64_HAVE_NEON
+
+extern size_t
+wf_impl_base64_decode_neon(
+    char const * data,
+    size_t length,
+    uint8_t * buffer,
+    bool * is_valid);
+
+extern size_t
+wf_impl_base64_validate_neon(
+    char const * data,
+    size_t length,
+    bool * is_valid);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
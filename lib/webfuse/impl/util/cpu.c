@@ -0,0 +1,59 @@
+#include "webfuse/impl/util/cpu.h"
+
+bool
+wf_impl_cpu_supports(
+    enum wf_impl_cpu_feature feature)
+{
+    switch (feature)
+    {
+        case WF_IMPL_CPU_BASELINE:
+            return true;
+#if defined(__x86_64__) || defined(__i386__)
+        case WF_IMPL_CPU_SSE2:
+            __builtin_cpu_init();
+            return (0 != __builtin_cpu_supports("sse2"));
+        case WF_IMPL_CPU_SSSE3:
+            __builtin_cpu_init();
+            return (0 != __builtin_cpu_supports("ssse3"));
+        case WF_IMPL_CPU_AVX2:
+            __builtin_cpu_init();
+            return (0 != __builtin_cpu_supports("avx2"));
+#endif
+#if defined(__aarch64__)
+        // NEON is mandatory on aarch64
+        case WF_IMPL_CPU_NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+// Candidates are ordered by preference. The selected variant is stored by
+// the caller, so that detection runs once; since detection is idempotent,
+// concurrent initialization is harmless.
+int
+wf_impl_cpu_select_variant(
+    int * selected,
+    int const * candidates,
+    size_t count,
+    wf_impl_cpu_variant_supported_fn * is_supported,
+    int fallback)
+{
+    if (0 > *selected)
+    {
+        int best = fallback;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (is_supported(candidates[i]))
+            {
+                best = candidates[i];
+                break;
+            }
+        }
+
+        *selected = best;
+    }
+
+    return *selected;
+}
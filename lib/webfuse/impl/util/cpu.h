@@ -0,0 +1,46 @@
+#ifndef WF_IMPL_UTIL_CPU_H
+#define WF_IMPL_UTIL_CPU_H
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <stdbool.h>
+#else
+#include <cstddef>
+using std::size_t;
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+enum wf_impl_cpu_feature
+{
+    WF_IMPL_CPU_BASELINE,
+    WF_IMPL_CPU_SSE2,
+    WF_IMPL_CPU_SSSE3,
+    WF_IMPL_CPU_AVX2,
+    WF_IMPL_CPU_NEON
+};
+
+typedef bool
+wf_impl_cpu_variant_supported_fn(
+    int variant);
+
+extern bool
+wf_impl_cpu_supports(
+    enum wf_impl_cpu_feature feature);
+
+extern int
+wf_impl_cpu_select_variant(
+    int * selected,
+    int const * candidates,
+    size_t count,
+    wf_impl_cpu_variant_supported_fn * is_supported,
+    int fallback);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,118 @@
+#include "webfuse/impl/util/hashmap.h"
+#include <stdlib.h>
+
+#define WF_HASHMAP_INITIAL_CAPACITY 16
+
+static size_t wf_impl_hashmap_index(
+    uint64_t key,
+    size_t capacity)
+{
+    // finalizer of splitmix64; spreads sequential keys over all buckets
+    key ^= key >> 30;
+    key *= UINT64_C(0xbf58476d1ce4e5b9);
+    key ^= key >> 27;
+    key *= UINT64_C(0x94d049bb133111eb);
+    key ^= key >> 31;
+
+    return (size_t) (key & (capacity - 1));
+}
+
+static void wf_impl_hashmap_grow(
+    struct wf_hashmap * map)
+{
+    size_t const capacity = map->capacity * 2;
+    struct wf_hashmap_item * * buckets = calloc(capacity, sizeof(struct wf_hashmap_item *));
+
+    for (size_t i = 0; i < map->capacity; i++)
+    {
+        struct wf_hashmap_item * item = map->buckets[i];
+        while (NULL != item)
+        {
+            struct wf_hashmap_item * next = item->next;
+            size_t const index = wf_impl_hashmap_index(item->key, capacity);
+            item->next = buckets[index];
+            buckets[index] = item;
+
+            item = next;
+        }
+    }
+
+    free(map->buckets);
+    map->buckets = buckets;
+    map->capacity = capacity;
+}
+
+void wf_impl_hashmap_init(
+    struct wf_hashmap * map)
+{
+    map->buckets = NULL;
+    map->capacity = 0;
+    map->size = 0;
+}
+
+void wf_impl_hashmap_cleanup(
+    struct wf_hashmap * map)
+{
+    free(map->buckets);
+    wf_impl_hashmap_init(map);
+}
+
+void wf_impl_hashmap_add(
+    struct wf_hashmap * map,
+    struct wf_hashmap_item * item,
+    uint64_t key)
+{
+    if (NULL == map->buckets)
+    {
+        map->capacity = WF_HASHMAP_INITIAL_CAPACITY;
+        map->buckets = calloc(map->capacity, sizeof(struct wf_hashmap_item *));
+    }
+    else if (map->size >= map->capacity)
+    {
+        wf_impl_hashmap_grow(map);
+    }
+
+    size_t const index = wf_impl_hashmap_index(key, map->capacity);
+    item->key = key;
+    item->next = map->buckets[index];
+    map->buckets[index] = item;
+    map->size++;
+}
+
+struct wf_hashmap_item * wf_impl_hashmap_get(
+    struct wf_hashmap * map,
+    uint64_t key)
+{
+    if (0 == map->size) { return NULL; }
+
+    struct wf_hashmap_item * item = map->buckets[wf_impl_hashmap_index(key, map->capacity)];
+    while ((NULL != item) && (key != item->key))
+    {
+        item = item->next;
+    }
+
+    return item;
+}
+
+struct wf_hashmap_item * wf_impl_hashmap_remove(
+    struct wf_hashmap * map,
+    uint64_t key)
+{
+    if (0 == map->size) { return NULL; }
+
+    struct wf_hashmap_item * * link = &map->buckets[wf_impl_hashmap_index(key, map->capacity)];
+    while ((NULL != *link) && (key != (*link)->key))
+    {
+        link = &(*link)->next;
+    }
+
+    struct wf_hashmap_item * item = *link;
+    if (NULL != item)
+    {
+        *link = item->next;
+        item->next = NULL;
+        map->size--;
+    }
+
+    return item;
+}
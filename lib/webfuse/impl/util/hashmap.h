@@ -0,0 +1,53 @@
+#ifndef WF_IMPL_UTIL_HASHMAP_H
+#define WF_IMPL_UTIL_HASHMAP_H
+
+#ifndef __cplusplus
+#include <stddef.h>
+#include <stdint.h>
+#else
+#include <cstddef>
+#include <cstdint>
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{ 
+#endif
+
+struct wf_hashmap_item
+{
+    struct wf_hashmap_item * next;
+    uint64_t key;
+};
+
+struct wf_hashmap
+{
+    struct wf_hashmap_item * * buckets;
+    size_t capacity;
+    size_t size;
+};
+
+extern void wf_impl_hashmap_init(
+    struct wf_hashmap * map);
+
+extern void wf_impl_hashmap_cleanup(
+    struct wf_hashmap * map);
+
+extern void wf_impl_hashmap_add(
+    struct wf_hashmap * map,
+    struct wf_hashmap_item * item,
+    uint64_t key);
+
+extern struct wf_hashmap_item * wf_impl_hashmap_get(
+    struct wf_hashmap * map,
+    uint64_t key);
+
+extern struct wf_hashmap_item * wf_impl_hashmap_remove(
+    struct wf_hashmap * map,
+    uint64_t key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
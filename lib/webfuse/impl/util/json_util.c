@@ -20,6 +20,52 @@ wf_impl_json_get_int(
 	return result;
 }
 
+int64_t
+wf_impl_json_get_int64(
+	struct wf_json const * object,
+	char const * key,
+	int64_t default_value)
+{
+	if (NULL == object) { return default_value; }
+	int64_t result = default_value;
+
+	struct wf_json const * holder = wf_impl_json_object_get(object, key);
+	if (wf_impl_json_is_int(holder))
+	{
+		result = wf_impl_json_int64_get(holder);
+	}
+
+	return result;
+}
+
+bool
+wf_impl_json_get_bool(
+	struct wf_json const * object,
+	char const * key,
+	bool default_value)
+{
+	if (NULL == object) { return default_value; }
+	bool result = default_value;
+
+	struct wf_json const * holder = wf_impl_json_object_get(object, key);
+	if (wf_impl_json_is_bool(holder))
+	{
+		result = wf_impl_json_bool_get(holder);
+	}
+
+	return result;
+}
+
+double
+wf_impl_json_get_timeout(
+	struct wf_json const * object,
+	char const * key,
+	double default_value)
+{
+	int64_t const value = wf_impl_json_get_int64(object, key, -1);
+	return (0 <= value) ? (double) value : default_value;
+}
+
 wf_status 
 wf_impl_jsonrpc_get_status(
 	struct wf_jsonrpc_error const * error)
@@ -3,6 +3,13 @@
 
 #include "webfuse/status.h"
 
+#ifndef __cplusplus
+#include <stdbool.h>
+#include <stdint.h>
+#else
+#include <cstdint>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -17,6 +24,25 @@ wf_impl_json_get_int(
     char const * key,
     int default_value);
 
+extern int64_t
+wf_impl_json_get_int64(
+    struct wf_json const * object,
+    char const * key,
+    int64_t default_value);
+
+extern bool
+wf_impl_json_get_bool(
+    struct wf_json const * object,
+    char const * key,
+    bool default_value);
+
+// Returns a timeout in seconds, which is specified as non-negative integer.
+extern double
+wf_impl_json_get_timeout(
+    struct wf_json const * object,
+    char const * key,
+    double default_value);
+
 extern wf_status 
 wf_impl_jsonrpc_get_status(
     struct wf_jsonrpc_error const * error);
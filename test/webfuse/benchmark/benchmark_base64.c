@@ -0,0 +1,84 @@
+/* Measures throughput of the base64 decoder variants.
+ *
+ *   Usage: benchmark_base64 [size in KiB] [iterations]
+ *
+ *   Each supported variant decodes the same data. Throughput is reported
+ *   in GB/s of decoded data.
+ */
+
+#include "webfuse/impl/util/base64.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return ((double) time.tv_sec) + (((double) time.tv_nsec) / 1e9);
+}
+
+int main(int argc, char * argv[])
+{
+    size_t const size = ((1 < argc) ? (size_t) atol(argv[1]) : 1024) * 1024;
+    int const iterations = (2 < argc) ? atoi(argv[2]) : 1000;
+
+    uint8_t * data = malloc(size);
+    for (size_t i = 0; i < size; i++)
+    {
+        data[i] = (uint8_t) rand();
+    }
+
+    size_t const encoded_size = wf_impl_base64_encoded_size(size);
+    char * encoded = malloc(encoded_size + 1);
+    wf_impl_base64_encode(data, size, encoded, encoded_size + 1);
+    uint8_t * buffer = malloc(size);
+
+    printf("default: %s\n", wf_impl_base64_variant_name(wf_impl_base64_get_variant()));
+    for (int variant = 0; variant < WF_IMPL_BASE64_VARIANT_COUNT; variant++)
+    {
+        char const * name = wf_impl_base64_variant_name(variant);
+        if (!wf_impl_base64_variant_supported(variant))
+        {
+            printf("%-8s: not supported\n", name);
+            continue;
+        }
+
+        size_t length = 0;
+        double start = now();
+        for (int i = 0; i < iterations; i++)
+        {
+            length = wf_impl_base64_decode_variant(variant, encoded, encoded_size, buffer, size);
+        }
+        double const decode_time = now() - start;
+
+        if ((length != size) || (0 != memcmp(data, buffer, size)))
+        {
+            printf("%-8s: failed to decode\n", name);
+            return EXIT_FAILURE;
+        }
+
+        start = now();
+        for (int i = 0; i < iterations; i++)
+        {
+            if (!wf_impl_base64_isvalid_variant(variant, encoded, encoded_size))
+            {
+                printf("%-8s: failed to validate\n", name);
+                return EXIT_FAILURE;
+            }
+        }
+        double const validate_time = now() - start;
+
+        double const total = ((double) size) * iterations / 1e9;
+        printf("%-8s: decode %6.2f GB/s, validate %6.2f GB/s\n", name, total / decode_time, total / validate_time);
+    }
+
+    free(buffer);
+    free(encoded);
+    free(data);
+
+    return EXIT_SUCCESS;
+}
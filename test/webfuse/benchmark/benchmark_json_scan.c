@@ -0,0 +1,81 @@
+/* Measures throughput of the JSON scanner variants.
+ *
+ *   Usage: benchmark_json_scan [size in KiB] [iterations]
+ *
+ *   Each supported variant scans a long string (as found in base64 encoded
+ *   read results) and a long run of whitespace. Throughput is reported
+ *   in GB/s.
+ */
+
+#include "webfuse/impl/json/scan.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return ((double) time.tv_sec) + (((double) time.tv_nsec) / 1e9);
+}
+
+int main(int argc, char * argv[])
+{
+    size_t const size = ((1 < argc) ? (size_t) atol(argv[1]) : 1024) * 1024;
+    int const iterations = (2 < argc) ? atoi(argv[2]) : 1000;
+
+    static char const alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    char * text = malloc(size + 1);
+    for (size_t i = 0; i < size; i++)
+    {
+        text[i] = alphabet[((size_t) rand()) % 64];
+    }
+    text[size] = '\"';
+
+    char * whitespace = malloc(size + 1);
+    memset(whitespace, ' ', size);
+    whitespace[size] = '}';
+
+    printf("default: %s\n", wf_impl_json_scan_variant_name(wf_impl_json_scan_get_variant()));
+    for (int variant = 0; variant < WF_IMPL_JSON_SCAN_VARIANT_COUNT; variant++)
+    {
+        char const * name = wf_impl_json_scan_variant_name(variant);
+        if (!wf_impl_json_scan_variant_supported(variant))
+        {
+            printf("%-8s: not supported\n", name);
+            continue;
+        }
+
+        size_t length = 0;
+        double start = now();
+        for (int i = 0; i < iterations; i++)
+        {
+            length += wf_impl_json_scan_string_variant(variant, text, size + 1);
+        }
+        double const string_time = now() - start;
+
+        start = now();
+        for (int i = 0; i < iterations; i++)
+        {
+            length += wf_impl_json_scan_whitespace_variant(variant, whitespace, size + 1);
+        }
+        double const whitespace_time = now() - start;
+
+        if (length != (2 * size * ((size_t) iterations)))
+        {
+            printf("%-8s: failed to scan\n", name);
+            return EXIT_FAILURE;
+        }
+
+        double const total = ((double) size) * iterations / 1e9;
+        printf("%-8s: string %6.2f GB/s, whitespace %6.2f GB/s\n", name, total / string_time, total / whitespace_time);
+    }
+
+    free(whitespace);
+    free(text);
+
+    return EXIT_SUCCESS;
+}
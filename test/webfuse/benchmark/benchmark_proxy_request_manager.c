@@ -0,0 +1,97 @@
+/* Measures response dispatch of the JSON-RPC proxy request manager.
+ *
+ *   Usage: benchmark_proxy_request_manager [outstanding requests] [iterations]
+ *
+ *   Each iteration adds the given number of requests and finishes them
+ *   in random order. The average time to add and to finish a request is
+ *   reported in ns.
+ */
+
+#include "webfuse/impl/jsonrpc/proxy_request_manager.h"
+#include "webfuse/impl/jsonrpc/response_intern.h"
+#include "webfuse/impl/timer/manager.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define WF_BENCHMARK_TIMEOUT (10 * 1000)
+
+static double now(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return ((double) time.tv_sec) + (((double) time.tv_nsec) / 1e9);
+}
+
+static void on_finished(
+    void * user_data,
+    struct wf_json const * result,
+    struct wf_jsonrpc_error const * error)
+{
+    (void) result;
+    (void) error;
+
+    size_t * finished = user_data;
+    (*finished)++;
+}
+
+int main(int argc, char * argv[])
+{
+    size_t const count = (1 < argc) ? (size_t) atol(argv[1]) : 10000;
+    int const iterations = (2 < argc) ? atoi(argv[2]) : 100;
+
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+    struct wf_jsonrpc_proxy_request_manager * manager =
+        wf_impl_jsonrpc_proxy_request_manager_create(timer_manager, WF_BENCHMARK_TIMEOUT);
+
+    int * ids = malloc(count * sizeof(int));
+    size_t finished = 0;
+    double add_time = 0.0;
+    double finish_time = 0.0;
+
+    for (int iteration = 0; iteration < iterations; iteration++)
+    {
+        double start = now();
+        for (size_t i = 0; i < count; i++)
+        {
+            ids[i] = wf_impl_jsonrpc_proxy_request_manager_add_request(manager, &on_finished, &finished);
+        }
+        add_time += now() - start;
+
+        // providers answer out of order
+        for (size_t i = count - 1; 0 < i; i--)
+        {
+            size_t const j = ((size_t) rand()) % (i + 1);
+            int const id = ids[i];
+            ids[i] = ids[j];
+            ids[j] = id;
+        }
+
+        start = now();
+        for (size_t i = 0; i < count; i++)
+        {
+            struct wf_jsonrpc_response response = { NULL, NULL, ids[i] };
+            wf_impl_jsonrpc_proxy_request_manager_finish_request(manager, &response);
+        }
+        finish_time += now() - start;
+    }
+
+    size_t const total = count * ((size_t) iterations);
+    if ((finished != total) || (0 != wf_impl_jsonrpc_proxy_request_manager_count(manager)))
+    {
+        printf("failed to finish requests: %zu of %zu\n", finished, total);
+        return EXIT_FAILURE;
+    }
+
+    printf("outstanding: %zu\n", count);
+    printf("add        : %8.1f ns/request\n", add_time * 1e9 / ((double) total));
+    printf("finish     : %8.1f ns/request\n", finish_time * 1e9 / ((double) total));
+
+    free(ids);
+    wf_impl_jsonrpc_proxy_request_manager_dispose(manager);
+    wf_impl_timer_manager_dispose(timer_manager);
+
+    return EXIT_SUCCESS;
+}
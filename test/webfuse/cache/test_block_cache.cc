@@ -0,0 +1,229 @@
+#include "webfuse/impl/cache/block_cache.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+namespace
+{
+
+std::string get(wf_impl_block_cache * cache, fuse_ino_t inode, off_t offset, size_t size, bool * is_cached = nullptr)
+{
+    std::string buffer(size, '\0');
+    size_t length;
+    bool const result = wf_impl_block_cache_get(cache, inode, offset, size, &buffer[0], &length);
+    if (nullptr != is_cached) { *is_cached = result; }
+
+    return result ? buffer.substr(0, length) : "";
+}
+
+void put(wf_impl_block_cache * cache, fuse_ino_t inode, off_t offset, size_t size, std::string const & data)
+{
+    wf_impl_block_cache_put(cache, wf_impl_block_cache_get_generation(cache), inode, offset, size, data.c_str(), data.size());
+}
+
+}
+
+TEST(block_cache, create_dispose)
+{
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(1024 * 1024);
+    ASSERT_EQ(0, wf_impl_block_cache_size(cache));
+    wf_impl_block_cache_dispose(cache);
+}
+
+TEST(block_cache, miss_unknown_file)
+{
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(1024 * 1024);
+
+    bool is_cached = true;
+    get(cache, 2, 0, 10, &is_cached);
+    ASSERT_FALSE(is_cached);
+
+    wf_impl_block_cache_dispose(cache);
+}
+
+TEST(block_cache, do_not_cache_files_without_attributes)
+{
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(1024 * 1024);
+
+    put(cache, 2, 0, WF_BLOCK_CACHE_BLOCK_SIZE, std::string(WF_BLOCK_CACHE_BLOCK_SIZE, 'x'));
+    ASSERT_EQ(0, wf_impl_block_cache_size(cache));
+
+    wf_impl_block_cache_dispose(cache);
+}
+
+TEST(block_cache, get_cached_blocks)
+{
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(1024 * 1024);
+    wf_impl_block_cache_update(cache, 2, 3 * WF_BLOCK_CACHE_BLOCK_SIZE, 42);
+
+    std::string data = std::string(WF_BLOCK_CACHE_BLOCK_SIZE, 'a') + std::string(WF_BLOCK_CACHE_BLOCK_SIZE, 'b');
+    put(cache, 2, 0, data.size(), data);
+
+    bool is_cached = false;
+    ASSERT_EQ(data, get(cache, 2, 0, data.size(), &is_cached));
+    ASSERT_TRUE(is_cached);
+    ASSERT_EQ("ab", get(cache, 2, WF_BLOCK_CACHE_BLOCK_SIZE - 1, 2, &is_cached));
+    ASSERT_TRUE(is_cached);
+
+    get(cache, 2, WF_BLOCK_CACHE_BLOCK_SIZE, 2 * WF_BLOCK_CACHE_BLOCK_SIZE, &is_cached);
+    ASSERT_FALSE(is_cached);
+
+    wf_impl_block_cache_dispose(cache);
+}
+
+TEST(block_cache, skip_partial_blocks)
+{
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(1024 * 1024);
+    wf_impl_block_cache_update(cache, 2, 3 * WF_BLOCK_CACHE_BLOCK_SIZE, 42);
+    size_t const empty_size = wf_impl_block_cache_size(cache);
+
+    put(cache, 2, 1, WF_BLOCK_CACHE_BLOCK_SIZE, std::string(WF_BLOCK_CACHE_BLOCK_SIZE, 'a'));
+    ASSERT_EQ(empty_size, wf_impl_block_cache_size(cache));
+
+    wf_impl_block_cache_dispose(cache);
+}
+
+TEST(block_cache, get_end_of_file)
+{
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(1024 * 1024);
+    wf_impl_block_cache_update(cache, 2, 5, 42);
+
+    put(cache, 2, 0, WF_BLOCK_CACHE_BLOCK_SIZE, "Hello");
+
+    bool is_cached = false;
+    ASSERT_EQ("Hello", get(cache, 2, 0, WF_BLOCK_CACHE_BLOCK_SIZE, &is_cached));
+    ASSERT_TRUE(is_cached);
+    ASSERT_EQ("", get(cache, 2, 5, 10, &is_cached));
+    ASSERT_TRUE(is_cached);
+
+    wf_impl_block_cache_dispose(cache);
+}
+
+TEST(block_cache, contains_reports_length_of_cached_range)
+{
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(1024 * 1024);
+    wf_impl_block_cache_update(cache, 2, WF_BLOCK_CACHE_BLOCK_SIZE + 5, 42);
+
+    put(cache, 2, 0, 2 * WF_BLOCK_CACHE_BLOCK_SIZE, std::string(WF_BLOCK_CACHE_BLOCK_SIZE, 'a') + "Hello");
+
+    size_t length = 0;
+    ASSERT_TRUE(wf_impl_block_cache_contains(cache, 2, 0, 3 * WF_BLOCK_CACHE_BLOCK_SIZE, &length));
+    ASSERT_EQ(WF_BLOCK_CACHE_BLOCK_SIZE + 5, length);
+    ASSERT_TRUE(wf_impl_block_cache_contains(cache, 2, 1, 2, &length));
+    ASSERT_EQ(2, length);
+    ASSERT_FALSE(wf_impl_block_cache_contains(cache, 3, 0, 2, &length));
+    ASSERT_EQ(0, length);
+
+    wf_impl_block_cache_dispose(cache);
+}
+
+TEST(block_cache, invalidate_on_changed_attributes)
+{
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(1024 * 1024);
+    wf_impl_block_cache_update(cache, 2, 5, 42);
+    size_t const empty_size = wf_impl_block_cache_size(cache);
+    put(cache, 2, 0, WF_BLOCK_CACHE_BLOCK_SIZE, "Hello");
+
+    bool is_cached = false;
+    wf_impl_block_cache_update(cache, 2, 5, 42);
+    get(cache, 2, 0, 5, &is_cached);
+    ASSERT_TRUE(is_cached);
+
+    wf_impl_block_cache_update(cache, 2, 5, 43);
+    get(cache, 2, 0, 5, &is_cached);
+    ASSERT_FALSE(is_cached);
+
+    put(cache, 2, 0, WF_BLOCK_CACHE_BLOCK_SIZE, "Hello");
+    wf_impl_block_cache_update(cache, 2, 6, 43);
+    get(cache, 2, 0, 5, &is_cached);
+    ASSERT_FALSE(is_cached);
+    ASSERT_EQ(empty_size, wf_impl_block_cache_size(cache));
+
+    wf_impl_block_cache_dispose(cache);
+}
+
+TEST(block_cache, discard_data_requested_before_change)
+{
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(1024 * 1024);
+    wf_impl_block_cache_update(cache, 2, 5, 42);
+    size_t const empty_size = wf_impl_block_cache_size(cache);
+
+    uint64_t generation = wf_impl_block_cache_get_generation(cache);
+    wf_impl_block_cache_update(cache, 2, 5, 43);
+    wf_impl_block_cache_put(cache, generation, 2, 0, WF_BLOCK_CACHE_BLOCK_SIZE, "Hello", 5);
+    ASSERT_EQ(empty_size, wf_impl_block_cache_size(cache));
+
+    wf_impl_block_cache_dispose(cache);
+}
+
+TEST(block_cache, invalidate)
+{
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(1024 * 1024);
+    wf_impl_block_cache_update(cache, 2, 5, 42);
+    put(cache, 2, 0, WF_BLOCK_CACHE_BLOCK_SIZE, "Hello");
+
+    wf_impl_block_cache_invalidate(cache, 2);
+
+    bool is_cached = true;
+    get(cache, 2, 0, 5, &is_cached);
+    ASSERT_FALSE(is_cached);
+    ASSERT_EQ(0, wf_impl_block_cache_size(cache));
+
+    wf_impl_block_cache_dispose(cache);
+}
+
+TEST(block_cache, evict_least_recently_used_blocks)
+{
+    // room for 3 blocks and the bookkeeping of a single file
+    size_t const max_size = 3 * (WF_BLOCK_CACHE_BLOCK_SIZE + 128) + 1024;
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(max_size);
+    wf_impl_block_cache_update(cache, 2, 10 * WF_BLOCK_CACHE_BLOCK_SIZE, 42);
+
+    put(cache, 2, 0 * WF_BLOCK_CACHE_BLOCK_SIZE, WF_BLOCK_CACHE_BLOCK_SIZE, std::string(WF_BLOCK_CACHE_BLOCK_SIZE, '0'));
+    put(cache, 2, 1 * WF_BLOCK_CACHE_BLOCK_SIZE, WF_BLOCK_CACHE_BLOCK_SIZE, std::string(WF_BLOCK_CACHE_BLOCK_SIZE, '1'));
+    put(cache, 2, 2 * WF_BLOCK_CACHE_BLOCK_SIZE, WF_BLOCK_CACHE_BLOCK_SIZE, std::string(WF_BLOCK_CACHE_BLOCK_SIZE, '2'));
+
+    bool is_cached = false;
+    get(cache, 2, 0, 1, &is_cached);
+    ASSERT_TRUE(is_cached);
+
+    put(cache, 2, 3 * WF_BLOCK_CACHE_BLOCK_SIZE, WF_BLOCK_CACHE_BLOCK_SIZE, std::string(WF_BLOCK_CACHE_BLOCK_SIZE, '3'));
+    ASSERT_GE(max_size, wf_impl_block_cache_size(cache));
+
+    get(cache, 2, 0, 1, &is_cached);
+    ASSERT_TRUE(is_cached);
+    get(cache, 2, 1 * WF_BLOCK_CACHE_BLOCK_SIZE, 1, &is_cached);
+    ASSERT_FALSE(is_cached);
+    get(cache, 2, 3 * WF_BLOCK_CACHE_BLOCK_SIZE, 1, &is_cached);
+    ASSERT_TRUE(is_cached);
+
+    wf_impl_block_cache_dispose(cache);
+}
+
+TEST(block_cache, account_file_bookkeeping)
+{
+    size_t const max_size = 2 * WF_BLOCK_CACHE_BLOCK_SIZE;
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(max_size);
+
+    wf_impl_block_cache_update(cache, 1, 5, 42);
+    ASSERT_LT(0, wf_impl_block_cache_size(cache));
+
+    for (fuse_ino_t inode = 2; inode < 1000; inode++)
+    {
+        wf_impl_block_cache_update(cache, inode, 5, 42);
+        ASSERT_GE(max_size, wf_impl_block_cache_size(cache));
+    }
+
+    // least recently used files are dropped to stay within budget
+    put(cache, 1, 0, WF_BLOCK_CACHE_BLOCK_SIZE, "Hello");
+    bool is_cached = true;
+    get(cache, 1, 0, 5, &is_cached);
+    ASSERT_FALSE(is_cached);
+
+    put(cache, 999, 0, WF_BLOCK_CACHE_BLOCK_SIZE, "Hello");
+    ASSERT_EQ("Hello", get(cache, 999, 0, 5, &is_cached));
+    ASSERT_TRUE(is_cached);
+    ASSERT_GE(max_size, wf_impl_block_cache_size(cache));
+
+    wf_impl_block_cache_dispose(cache);
+}
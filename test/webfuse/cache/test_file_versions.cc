@@ -0,0 +1,101 @@
+#include "webfuse/impl/cache/file_versions.h"
+
+#include <gtest/gtest.h>
+
+TEST(file_versions, create_dispose)
+{
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+    ASSERT_EQ(0, wf_impl_file_versions_size(versions));
+    wf_impl_file_versions_dispose(versions);
+}
+
+TEST(file_versions, unknown_file_is_not_unchanged)
+{
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+
+    ASSERT_FALSE(wf_impl_file_versions_open(versions, 2));
+    ASSERT_FALSE(wf_impl_file_versions_open(versions, 2));
+
+    wf_impl_file_versions_dispose(versions);
+}
+
+TEST(file_versions, first_open_is_not_unchanged)
+{
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+
+    wf_impl_file_versions_update(versions, 2, 42, 1000);
+    ASSERT_FALSE(wf_impl_file_versions_open(versions, 2));
+
+    wf_impl_file_versions_dispose(versions);
+}
+
+TEST(file_versions, reopen_unchanged_file)
+{
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+
+    wf_impl_file_versions_update(versions, 2, 42, 1000);
+    ASSERT_FALSE(wf_impl_file_versions_open(versions, 2));
+
+    wf_impl_file_versions_update(versions, 2, 42, 1000);
+    ASSERT_TRUE(wf_impl_file_versions_open(versions, 2));
+    ASSERT_TRUE(wf_impl_file_versions_open(versions, 2));
+
+    wf_impl_file_versions_dispose(versions);
+}
+
+TEST(file_versions, reopen_file_with_changed_size)
+{
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+
+    wf_impl_file_versions_update(versions, 2, 42, 1000);
+    wf_impl_file_versions_open(versions, 2);
+
+    wf_impl_file_versions_update(versions, 2, 43, 1000);
+    ASSERT_FALSE(wf_impl_file_versions_open(versions, 2));
+    ASSERT_TRUE(wf_impl_file_versions_open(versions, 2));
+
+    wf_impl_file_versions_dispose(versions);
+}
+
+TEST(file_versions, reopen_file_with_changed_mtime)
+{
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+
+    wf_impl_file_versions_update(versions, 2, 42, 1000);
+    wf_impl_file_versions_open(versions, 2);
+
+    wf_impl_file_versions_update(versions, 2, 42, 1001);
+    ASSERT_FALSE(wf_impl_file_versions_open(versions, 2));
+
+    wf_impl_file_versions_dispose(versions);
+}
+
+TEST(file_versions, files_are_tracked_separately)
+{
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+
+    wf_impl_file_versions_update(versions, 2, 42, 1000);
+    wf_impl_file_versions_update(versions, 3, 42, 1000);
+    wf_impl_file_versions_open(versions, 2);
+    wf_impl_file_versions_open(versions, 3);
+
+    wf_impl_file_versions_update(versions, 3, 0, 1000);
+    ASSERT_TRUE(wf_impl_file_versions_open(versions, 2));
+    ASSERT_FALSE(wf_impl_file_versions_open(versions, 3));
+    ASSERT_EQ(2, wf_impl_file_versions_size(versions));
+
+    wf_impl_file_versions_dispose(versions);
+}
+
+TEST(file_versions, limit_number_of_files)
+{
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+
+    for (fuse_ino_t inode = 1; inode <= 10000; inode++)
+    {
+        wf_impl_file_versions_update(versions, inode, 42, 1000);
+    }
+    ASSERT_GT(10000, wf_impl_file_versions_size(versions));
+
+    wf_impl_file_versions_dispose(versions);
+}
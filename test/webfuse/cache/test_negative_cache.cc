@@ -0,0 +1,77 @@
+#include "webfuse/impl/cache/negative_cache.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+wf_timer_timepoint in_one_minute()
+{
+    return wf_impl_timer_timepoint_in_msec(60 * 1000);
+}
+
+}
+
+TEST(negative_cache, create_dispose)
+{
+    wf_impl_negative_cache * cache = wf_impl_negative_cache_create();
+    ASSERT_EQ(0, wf_impl_negative_cache_size(cache));
+    wf_impl_negative_cache_dispose(cache);
+}
+
+TEST(negative_cache, miss_unknown_name)
+{
+    wf_impl_negative_cache * cache = wf_impl_negative_cache_create();
+
+    ASSERT_FALSE(wf_impl_negative_cache_contains(cache, 1, "missing"));
+
+    wf_impl_negative_cache_dispose(cache);
+}
+
+TEST(negative_cache, contains_added_name)
+{
+    wf_impl_negative_cache * cache = wf_impl_negative_cache_create();
+
+    wf_impl_negative_cache_add(cache, 1, "missing", in_one_minute());
+    ASSERT_TRUE(wf_impl_negative_cache_contains(cache, 1, "missing"));
+    ASSERT_FALSE(wf_impl_negative_cache_contains(cache, 2, "missing"));
+    ASSERT_FALSE(wf_impl_negative_cache_contains(cache, 1, "missing2"));
+
+    wf_impl_negative_cache_dispose(cache);
+}
+
+TEST(negative_cache, drop_expired_entries)
+{
+    wf_impl_negative_cache * cache = wf_impl_negative_cache_create();
+
+    wf_impl_negative_cache_add(cache, 1, "missing", wf_impl_timer_timepoint_in_msec(-1000));
+    ASSERT_FALSE(wf_impl_negative_cache_contains(cache, 1, "missing"));
+    ASSERT_EQ(0, wf_impl_negative_cache_size(cache));
+
+    wf_impl_negative_cache_dispose(cache);
+}
+
+TEST(negative_cache, refresh_entry)
+{
+    wf_impl_negative_cache * cache = wf_impl_negative_cache_create();
+
+    wf_impl_negative_cache_add(cache, 1, "missing", wf_impl_timer_timepoint_in_msec(-1000));
+    wf_impl_negative_cache_add(cache, 1, "missing", in_one_minute());
+    ASSERT_TRUE(wf_impl_negative_cache_contains(cache, 1, "missing"));
+    ASSERT_EQ(1, wf_impl_negative_cache_size(cache));
+
+    wf_impl_negative_cache_dispose(cache);
+}
+
+TEST(negative_cache, limit_number_of_entries)
+{
+    wf_impl_negative_cache * cache = wf_impl_negative_cache_create();
+
+    for (int i = 0; i < 10000; i++)
+    {
+        wf_impl_negative_cache_add(cache, 1, std::to_string(i).c_str(), in_one_minute());
+    }
+    ASSERT_GT(10000, wf_impl_negative_cache_size(cache));
+
+    wf_impl_negative_cache_dispose(cache);
+}
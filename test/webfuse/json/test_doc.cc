@@ -1,6 +1,8 @@
 #include "webfuse/impl/json/doc.h"
 #include "webfuse/impl/json/node.h"
+#include "webfuse/impl/util/arena.h"
 #include <gtest/gtest.h>
+#include <cstring>
 
 TEST(json_doc, loadb)
 {
@@ -20,4 +22,37 @@ TEST(json_doc, loadb_fail_invalid_json)
     char text[] = "true";
     wf_json_doc * doc = wf_impl_json_doc_loadb(text, 3);
     ASSERT_EQ(nullptr, doc);
-}
\ No newline at end of file
+}
+
+TEST(json_doc, loadb_arena)
+{
+    struct wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
+
+    char text[] = "{\"items\": [1, 2, 3, 4, 5, 6, 7, 8, 9], \"name\": \"test\"}";
+    wf_json_doc * doc = wf_impl_json_doc_loadb_arena(text, strlen(text), &arena);
+    ASSERT_NE(nullptr, doc);
+
+    wf_json const * root = wf_impl_json_doc_root(doc);
+    wf_json const * items = wf_impl_json_object_get(root, "items");
+    ASSERT_EQ(9, wf_impl_json_array_size(items));
+    ASSERT_EQ(9, wf_impl_json_int_get(wf_impl_json_array_get(items, 8)));
+    ASSERT_STREQ("test", wf_impl_json_string_get(wf_impl_json_object_get(root, "name")));
+
+    wf_impl_json_doc_dispose(doc);
+    wf_impl_arena_reset(&arena);
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(json_doc, loadb_arena_fail_invalid_json)
+{
+    struct wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
+
+    char text[] = "[1, 2, {\"a\": [true, fals]}]";
+    wf_json_doc * doc = wf_impl_json_doc_loadb_arena(text, strlen(text), &arena);
+    ASSERT_EQ(nullptr, doc);
+
+    wf_impl_arena_reset(&arena);
+    wf_impl_arena_cleanup(&arena);
+}
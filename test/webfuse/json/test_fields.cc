@@ -0,0 +1,84 @@
+#include "webfuse/impl/json/fields.h"
+#include "webfuse/test_util/json_doc.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+using webfuse_test::JsonDoc;
+
+namespace
+{
+
+struct Target
+{
+    int64_t number;
+    bool flag;
+    wf_json_field_string text;
+    wf_json const * list;
+};
+
+wf_json_field const fields[] =
+{
+    WF_JSON_FIELD("number", WF_JSON_TYPE_INT, Target, number),
+    WF_JSON_FIELD("flag", WF_JSON_TYPE_BOOL, Target, flag),
+    WF_JSON_FIELD("text", WF_JSON_TYPE_STRING, Target, text),
+    WF_JSON_FIELD("list", WF_JSON_TYPE_ARRAY, Target, list)
+};
+
+uint32_t decode(JsonDoc & doc, Target & target)
+{
+    target = {0, false, {nullptr, 0}, nullptr};
+    return wf_impl_json_fields_decode(doc.root(), fields, 4, &target);
+}
+
+}
+
+TEST(json_fields, decode_all)
+{
+    JsonDoc doc("{\"list\": [1, 2], \"text\": \"hello\", \"flag\": true, \"number\": 42}");
+    Target target;
+
+    ASSERT_EQ(0xfu, decode(doc, target));
+    ASSERT_EQ(42, target.number);
+    ASSERT_TRUE(target.flag);
+    ASSERT_EQ("hello", std::string(target.text.data, target.text.size));
+    ASSERT_EQ(WF_JSON_TYPE_ARRAY, wf_impl_json_type(target.list));
+    ASSERT_EQ(2, wf_impl_json_array_size(target.list));
+}
+
+TEST(json_fields, skip_unknown_members)
+{
+    JsonDoc doc("{\"numbers\": 1, \"n\": 2, \"unknown\": {\"number\": 3}, \"number\": 4}");
+    Target target;
+
+    ASSERT_EQ(0x1u, decode(doc, target));
+    ASSERT_EQ(4, target.number);
+}
+
+TEST(json_fields, ignore_members_of_other_type)
+{
+    JsonDoc doc("{\"number\": \"42\", \"flag\": 1}");
+    Target target;
+
+    ASSERT_EQ(0u, decode(doc, target));
+    ASSERT_EQ(0, target.number);
+    ASSERT_FALSE(target.flag);
+}
+
+TEST(json_fields, first_member_wins)
+{
+    JsonDoc doc("{\"number\": 1, \"number\": 2}");
+    Target target;
+
+    ASSERT_EQ(0x1u, decode(doc, target));
+    ASSERT_EQ(1, target.number);
+}
+
+TEST(json_fields, decode_non_object)
+{
+    JsonDoc doc("[42]");
+    Target target;
+
+    ASSERT_EQ(0u, decode(doc, target));
+    ASSERT_EQ(0u, wf_impl_json_fields_decode(nullptr, fields, 4, &target));
+}
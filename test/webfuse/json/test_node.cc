@@ -36,6 +36,13 @@ TEST(json_node, int)
     ASSERT_EQ(42, wf_impl_json_int_get(doc.root()));
 }
 
+TEST(json_node, int64)
+{
+    JsonDoc doc("5000000000");
+    ASSERT_TRUE(wf_impl_json_is_int(doc.root()));
+    ASSERT_EQ(5000000000LL, wf_impl_json_int64_get(doc.root()));
+}
+
 TEST(json_node, string)
 {
     JsonDoc doc("\"brummni\"");
@@ -52,6 +52,11 @@ TEST(json_parser, fail_invalid_int)
     ASSERT_FALSE(try_parse("-"));
 }
 
+TEST(json_parser, fail_int_out_of_range)
+{
+    ASSERT_FALSE(try_parse("9223372036854775808"));
+}
+
 TEST(json_parser, fail_invalid_string)
 {
     ASSERT_FALSE(try_parse("\"invalid"));
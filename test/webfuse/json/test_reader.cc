@@ -1,6 +1,7 @@
 #include "webfuse/impl/json/reader.h"
 #include <gtest/gtest.h>
 #include <climits>
+#include <string>
 
 TEST(json_reader, skip_whitespace)
 {
@@ -21,6 +22,16 @@ TEST(json_reader, skip_whitespace_eof)
     ASSERT_EQ('\0', c);
 }
 
+TEST(json_reader, skip_long_whitespace)
+{
+    std::string text = std::string(100, ' ') + "\n\t\r" + std::string(50, ' ') + "*";
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+    char c = wf_impl_json_reader_skip_whitespace(&reader);
+    ASSERT_EQ('*', c);
+    ASSERT_EQ(text.size() - 1, reader.pos);
+}
+
 TEST(json_reader, peek)
 {
     char text[] = "*";
@@ -134,6 +145,58 @@ TEST(json_reader, read_int_min)
     ASSERT_EQ(INT_MIN, value);
 }
 
+TEST(json_reader, read_int_fail_out_of_range)
+{
+    std::string text = "2147483648";
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    int value;
+    ASSERT_FALSE(wf_impl_json_reader_read_int(&reader, &value));
+}
+
+TEST(json_reader, read_int64_max)
+{
+    std::string text = std::to_string(INT64_MAX);
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    int64_t value;
+    ASSERT_TRUE(wf_impl_json_reader_read_int64(&reader, &value));
+    ASSERT_EQ(INT64_MAX, value);
+}
+
+TEST(json_reader, read_int64_min)
+{
+    std::string text = std::to_string(INT64_MIN);
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    int64_t value;
+    ASSERT_TRUE(wf_impl_json_reader_read_int64(&reader, &value));
+    ASSERT_EQ(INT64_MIN, value);
+}
+
+TEST(json_reader, read_int64_fail_overflow)
+{
+    std::string text = "9223372036854775808";
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    int64_t value;
+    ASSERT_FALSE(wf_impl_json_reader_read_int64(&reader, &value));
+}
+
+TEST(json_reader, read_int64_fail_underflow)
+{
+    std::string text = "-9223372036854775809";
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    int64_t value;
+    ASSERT_FALSE(wf_impl_json_reader_read_int64(&reader, &value));
+}
+
 TEST(json_reader, read_int_fail_invalid)
 {
     std::string text = "brummni";
@@ -180,6 +243,66 @@ TEST(json_reader, read_string_escaped)
     ASSERT_EQ(17, size);
 }
 
+TEST(json_reader, read_long_string)
+{
+    std::string const contents = "SGVsbG8gV29ybGQsIHRoaXMgaXMgYSBsb25nIHN0cmluZw==";
+    std::string text = "\"" + contents + "\", 42";
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    char * value;
+    size_t size;
+    ASSERT_TRUE(wf_impl_json_reader_read_string(&reader, &value, &size));
+    ASSERT_EQ(contents, std::string(value, size));
+    ASSERT_EQ(',', wf_impl_json_reader_peek(&reader));
+}
+
+TEST(json_reader, read_long_string_escaped)
+{
+    std::string text = "\"0123456789abcdef\\n0123456789abcdef\\/\"";
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    char * value;
+    size_t size;
+    ASSERT_TRUE(wf_impl_json_reader_read_string(&reader, &value, &size));
+    ASSERT_STREQ("0123456789abcdef\n0123456789abcdef/", value);
+    ASSERT_EQ(34, size);
+}
+
+TEST(json_reader, read_long_string_with_many_escapes)
+{
+    std::string text = "\"";
+    std::string expected;
+    for (int i = 0; i < 20; i++)
+    {
+        std::string const plain(i * 3, 'a' + (i % 26));
+        text += plain + "\\\"";
+        expected += plain + "\"";
+    }
+    text += "\"";
+
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    char * value;
+    size_t size;
+    ASSERT_TRUE(wf_impl_json_reader_read_string(&reader, &value, &size));
+    ASSERT_EQ(expected, std::string(value, size));
+    ASSERT_EQ(text.size(), reader.pos);
+}
+
+TEST(json_reader, read_string_fail_embedded_zero)
+{
+    std::string text("\"0123456789\0abcdef\"", 19);
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    char * value;
+    size_t size;
+    ASSERT_FALSE(wf_impl_json_reader_read_string(&reader, &value, &size));
+}
+
 TEST(json_reader, read_string_fail_missig_start_quot)
 {
     std::string text = "brummni\"";
@@ -202,6 +325,17 @@ TEST(json_reader, read_string_fail_missig_end_quot)
     ASSERT_FALSE(wf_impl_json_reader_read_string(&reader, &value, &size));
 }
 
+TEST(json_reader, read_long_string_fail_missig_end_quot)
+{
+    std::string text = "\"0123456789abcdef0123456789abcdef";
+    wf_json_reader reader;
+    wf_impl_json_reader_init(&reader, const_cast<char*>(text.data()), text.size());
+
+    char * value;
+    size_t size;
+    ASSERT_FALSE(wf_impl_json_reader_read_string(&reader, &value, &size));
+}
+
 TEST(json_reader, read_string_fail_invalid_escape_seq)
 {
     std::string text = "\"\\i\"";
@@ -0,0 +1,84 @@
+#include "webfuse/impl/json/scan.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+namespace
+{
+
+class JsonScanVariant: public ::testing::TestWithParam<wf_impl_json_scan_variant>
+{
+protected:
+    void SetUp() override
+    {
+        if (!wf_impl_json_scan_variant_supported(GetParam()))
+        {
+            GTEST_SKIP();
+        }
+    }
+};
+
+}
+
+TEST_P(JsonScanVariant, ScanString)
+{
+    char const specials[] = { '\"', '\\', '\0' };
+    for (char special: specials)
+    {
+        for (size_t size = 0; size < 100; size++)
+        {
+            std::string data(size, 'a');
+            data.append(1, special);
+            data.append(40, 'b');
+
+            ASSERT_EQ(size, wf_impl_json_scan_string_variant(GetParam(), data.data(), data.size())) << "size=" << size;
+        }
+    }
+}
+
+TEST_P(JsonScanVariant, ScanStringWithoutEnd)
+{
+    for (size_t size = 0; size < 100; size++)
+    {
+        std::string const data(size, 'a');
+        ASSERT_EQ(size, wf_impl_json_scan_string_variant(GetParam(), data.data(), data.size()));
+    }
+}
+
+TEST_P(JsonScanVariant, ScanStringWithHighCharacters)
+{
+    std::string data(70, '\xff');
+    data.append("\"");
+    ASSERT_EQ(70, wf_impl_json_scan_string_variant(GetParam(), data.data(), data.size()));
+}
+
+TEST_P(JsonScanVariant, ScanWhitespace)
+{
+    char const whitespace[] = " \t\n\r";
+    for (size_t size = 0; size < 100; size++)
+    {
+        std::string data;
+        for (size_t i = 0; i < size; i++)
+        {
+            data.append(1, whitespace[i % 4]);
+        }
+        data.append("{ }                                ");
+
+        ASSERT_EQ(size, wf_impl_json_scan_whitespace_variant(GetParam(), data.data(), data.size())) << "size=" << size;
+    }
+}
+
+TEST_P(JsonScanVariant, ScanWhitespaceWithoutEnd)
+{
+    for (size_t size = 0; size < 100; size++)
+    {
+        std::string const data(size, ' ');
+        ASSERT_EQ(size, wf_impl_json_scan_whitespace_variant(GetParam(), data.data(), data.size()));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(JsonScan, JsonScanVariant, ::testing::Values(
+    WF_IMPL_JSON_SCAN_SCALAR,
+    WF_IMPL_JSON_SCAN_SSE2,
+    WF_IMPL_JSON_SCAN_AVX2,
+    WF_IMPL_JSON_SCAN_NEON));
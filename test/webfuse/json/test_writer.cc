@@ -97,6 +97,34 @@ TEST(json_writer, int_min)
     ASSERT_EQ(int_min, writer.take());
 }
 
+TEST(json_writer, int64_max)
+{
+    writer writer;
+    std::string int64_max = std::to_string(INT64_MAX);
+
+    wf_impl_json_write_int64(writer, INT64_MAX);
+    ASSERT_EQ(int64_max, writer.take());
+}
+
+TEST(json_writer, int64_min)
+{
+    writer writer;
+    std::string int64_min = std::to_string(INT64_MIN);
+
+    wf_impl_json_write_int64(writer, INT64_MIN);
+    ASSERT_EQ(int64_min, writer.take());
+}
+
+TEST(json_writer, write_object_int64)
+{
+    writer writer;
+    wf_impl_json_write_object_begin(writer);
+    wf_impl_json_write_object_int64(writer, "size", 5000000000LL);
+    wf_impl_json_write_object_end(writer);
+
+    ASSERT_EQ("{\"size\":5000000000}", writer.take());
+}
+
 TEST(json_writer, write_string)
 {
     writer writer;
@@ -263,6 +291,19 @@ TEST(json_writer, realloc_buffer)
     ASSERT_EQ("\"very large contents\"", writer.take());
 }
 
+TEST(json_writer, attach_buffer)
+{
+    writer writer;
+    wf_impl_json_write_array_begin(writer);
+
+    wf_impl_json_writer_attach(writer, static_cast<char*>(malloc(4)), 4);
+    wf_impl_json_write_string(writer, "attached");
+    ASSERT_EQ(16, wf_impl_json_writer_capacity(writer));
+
+    ASSERT_EQ("\"attached\"", writer.take());
+    ASSERT_EQ(16, wf_impl_json_writer_capacity(writer));
+}
+
 TEST(json_writer, unexpected_end)
 {
     writer writer;
@@ -3,6 +3,7 @@
 #include "webfuse/impl/jsonrpc/error.h"
 #include "webfuse/impl/json/node.h"
 #include "webfuse/impl/message.h"
+#include "webfuse/impl/message_pool.h"
 #include "webfuse/status.h"
 #include "webfuse/impl/timer/manager.h"
 
@@ -85,6 +86,33 @@ namespace
                 wf_impl_jsonrpc_error_message(error));
         }
     }
+
+    struct WindowContext
+    {
+        int full_count;
+        int open_count;
+
+        WindowContext()
+        : full_count(0)
+        , open_count(0)
+        {
+        }
+    };
+
+    void jsonrpc_window(
+        void * user_data,
+        bool is_full)
+    {
+        WindowContext * context = reinterpret_cast<WindowContext*>(user_data);
+        if (is_full)
+        {
+            context->full_count++;
+        }
+        else
+        {
+            context->open_count++;
+        }
+    }
 }
 
 TEST(wf_jsonrpc_proxy, init)
@@ -140,6 +168,30 @@ TEST(wf_jsonrpc_proxy, invoke)
     ASSERT_FALSE(nullptr == finished_context.error);
 }
 
+TEST(wf_jsonrpc_proxy, invoke_int64_param)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+
+    FinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, finished_data, "foo", "Ii", static_cast<int64_t>(5000000000LL), 42);
+
+    ASSERT_TRUE(send_context.is_called);
+    wf_json const * params = wf_impl_json_object_get(send_context.response, "params");
+    ASSERT_TRUE(wf_impl_json_is_array(params));
+    ASSERT_EQ(2, wf_impl_json_array_size(params));
+    ASSERT_TRUE(wf_impl_json_is_int(wf_impl_json_array_get(params, 0)));
+    ASSERT_EQ(5000000000LL, wf_impl_json_int64_get(wf_impl_json_array_get(params, 0)));
+    ASSERT_EQ(42, wf_impl_json_int_get(wf_impl_json_array_get(params, 1)));
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
 TEST(wf_jsonrpc_proxy, invoke_calls_finish_if_send_fails)
 {
     struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
@@ -311,7 +363,148 @@ TEST(wf_jsonrpc_proxy, cleanup_pending_request)
     wf_impl_timer_manager_dispose(timer_manager);
 }
 
+namespace
+{
+    struct ReinvokeContext
+    {
+        wf_jsonrpc_proxy * proxy;
+        int count;
+        FinishedContext finished[32];
 
+        ReinvokeContext()
+        : proxy(nullptr)
+        , count(0)
+        {
+        }
+    };
+
+    void jsonrpc_reinvoke(
+        void * user_data,
+        wf_json const *,
+        wf_jsonrpc_error const *)
+    {
+        ReinvokeContext * context = reinterpret_cast<ReinvokeContext*>(user_data);
+        if (0 == context->count)
+        {
+            // enough requests to grow the map of pending requests
+            for (auto & finished: context->finished)
+            {
+                wf_impl_jsonrpc_proxy_invoke(context->proxy, &jsonrpc_finished, &finished, "foo", "");
+            }
+        }
+        context->count++;
+    }
+}
+
+TEST(wf_jsonrpc_proxy, cleanup_requests_invoked_during_cleanup)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, 10, &jsonrpc_send, send_data);
+
+    ReinvokeContext context;
+    context.proxy = proxy;
+    for (int i = 0; i < 16; i++)
+    {
+        wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_reinvoke, &context, "foo", "");
+    }
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+
+    ASSERT_EQ(16, context.count);
+    for (auto & finished: context.finished)
+    {
+        ASSERT_TRUE(finished.is_called);
+        ASSERT_NE(nullptr, finished.error);
+    }
+
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, count_pending_requests)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+    ASSERT_EQ(0, wf_impl_jsonrpc_proxy_pending_requests(proxy));
+
+    FinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, finished_data, "foo", "");
+    ASSERT_EQ(1, wf_impl_jsonrpc_proxy_pending_requests(proxy));
+
+    wf_json const * id = wf_impl_json_object_get(send_context.response, "id");
+    JsonDoc response("{\"result\": \"okay\", \"id\": " + std::to_string(wf_impl_json_int_get(id)) + "}");
+    wf_impl_jsonrpc_proxy_onresult(proxy, response.root());
+    ASSERT_EQ(0, wf_impl_jsonrpc_proxy_pending_requests(proxy));
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, window_full_and_reopened_by_result)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+
+    WindowContext window_context;
+    wf_impl_jsonrpc_proxy_set_window(proxy, 2, &jsonrpc_window, reinterpret_cast<void*>(&window_context));
+
+    FinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, finished_data, "foo", "");
+    ASSERT_EQ(0, window_context.full_count);
+
+    FinishedContext finished_context2;
+    void * finished_data2 = reinterpret_cast<void*>(&finished_context2);
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, finished_data2, "foo", "");
+    ASSERT_EQ(1, window_context.full_count);
+    ASSERT_EQ(0, window_context.open_count);
+
+    wf_json const * id = wf_impl_json_object_get(send_context.response, "id");
+    JsonDoc response("{\"result\": \"okay\", \"id\": " + std::to_string(wf_impl_json_int_get(id)) + "}");
+    wf_impl_jsonrpc_proxy_onresult(proxy, response.root());
+    ASSERT_TRUE(finished_context2.is_called);
+    ASSERT_EQ(1, window_context.full_count);
+    ASSERT_EQ(1, window_context.open_count);
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, window_reopened_by_timeout)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, 0, &jsonrpc_send, send_data);
+
+    WindowContext window_context;
+    wf_impl_jsonrpc_proxy_set_window(proxy, 1, &jsonrpc_window, reinterpret_cast<void*>(&window_context));
+
+    FinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_finished, finished_data, "foo", "");
+    ASSERT_EQ(1, window_context.full_count);
+
+    std::this_thread::sleep_for(10ms);
+    wf_impl_timer_manager_check(timer_manager);
+
+    ASSERT_TRUE(finished_context.is_called);
+    ASSERT_EQ(1, window_context.open_count);
+    ASSERT_EQ(0, wf_impl_jsonrpc_proxy_pending_requests(proxy));
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
 
 TEST(wf_jsonrpc_proxy, notify)
 {
@@ -376,3 +569,219 @@ TEST(wf_jsonrpc_proxy, on_result_swallow_if_no_request_pending)
     wf_impl_timer_manager_dispose(timer_manager);
 }
 
+
+namespace
+{
+    struct BinaryFinishedContext
+    {
+        bool is_called;
+        bool is_error;
+        std::string data;
+        std::string format;
+        int count;
+
+        BinaryFinishedContext()
+        : is_called(false)
+        , is_error(false)
+        , count(-1)
+        {
+
+        }
+    };
+
+    void jsonrpc_binary_finished(
+        void * user_data,
+        wf_json const * result,
+        wf_jsonrpc_error const * error)
+    {
+        BinaryFinishedContext * context = reinterpret_cast<BinaryFinishedContext*>(user_data);
+        context->is_called = true;
+        context->is_error = (nullptr != error);
+
+        if (nullptr != result)
+        {
+            wf_json const * data = wf_impl_json_object_get(result, "data");
+            wf_json const * format = wf_impl_json_object_get(result, "format");
+            wf_json const * count = wf_impl_json_object_get(result, "count");
+
+            context->data = std::string(wf_impl_json_string_get(data), wf_impl_json_string_size(data));
+            context->format = wf_impl_json_string_get(format);
+            context->count = wf_impl_json_int_get(count);
+        }
+    }
+
+    std::string create_binary_result(int id, int count, char format, std::string const & payload)
+    {
+        std::string message;
+        message.push_back((char) ((id >> 24) & 0xff));
+        message.push_back((char) ((id >> 16) & 0xff));
+        message.push_back((char) ((id >>  8) & 0xff));
+        message.push_back((char) ( id        & 0xff));
+        message.push_back((char) ((count >> 24) & 0xff));
+        message.push_back((char) ((count >> 16) & 0xff));
+        message.push_back((char) ((count >>  8) & 0xff));
+        message.push_back((char) ( count        & 0xff));
+        message.push_back(format);
+        message.append(payload);
+
+        return message;
+    }
+}
+
+TEST(wf_jsonrpc_proxy, on_binary)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+
+    BinaryFinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke_binary(proxy, &jsonrpc_binary_finished, finished_data, "read", "si", "bar", 42);
+
+    wf_json const * id = wf_impl_json_object_get(send_context.response, "id");
+    ASSERT_TRUE(wf_impl_json_is_int(id));
+
+    std::string message = create_binary_result(wf_impl_json_int_get(id), 5, '\0', std::string("he\0lo", 5));
+    wf_impl_jsonrpc_proxy_onbinary(proxy, &message[0], message.size());
+
+    ASSERT_TRUE(finished_context.is_called);
+    ASSERT_FALSE(finished_context.is_error);
+    ASSERT_EQ(std::string("he\0lo", 5), finished_context.data);
+    ASSERT_EQ("identity", finished_context.format);
+    ASSERT_EQ(5, finished_context.count);
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, on_binary_deflate)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+
+    BinaryFinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke_binary(proxy, &jsonrpc_binary_finished, finished_data, "read", "si", "bar", 42);
+
+    wf_json const * id = wf_impl_json_object_get(send_context.response, "id");
+    ASSERT_TRUE(wf_impl_json_is_int(id));
+
+    std::string message = create_binary_result(wf_impl_json_int_get(id), 42, '\x01', "compressed");
+    wf_impl_jsonrpc_proxy_onbinary(proxy, &message[0], message.size());
+
+    ASSERT_TRUE(finished_context.is_called);
+    ASSERT_FALSE(finished_context.is_error);
+    ASSERT_EQ("compressed", finished_context.data);
+    ASSERT_EQ("deflate", finished_context.format);
+    ASSERT_EQ(42, finished_context.count);
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, on_binary_fail_unknown_format)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+
+    BinaryFinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke_binary(proxy, &jsonrpc_binary_finished, finished_data, "read", "si", "bar", 42);
+
+    wf_json const * id = wf_impl_json_object_get(send_context.response, "id");
+    ASSERT_TRUE(wf_impl_json_is_int(id));
+
+    std::string message = create_binary_result(wf_impl_json_int_get(id), 5, '\x7f', "hello");
+    wf_impl_jsonrpc_proxy_onbinary(proxy, &message[0], message.size());
+
+    ASSERT_TRUE(finished_context.is_called);
+    ASSERT_TRUE(finished_context.is_error);
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, on_binary_fail_request_not_accepting_binary)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+
+    BinaryFinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke(proxy, &jsonrpc_binary_finished, finished_data, "read", "si", "bar", 42);
+
+    wf_json const * id = wf_impl_json_object_get(send_context.response, "id");
+    ASSERT_TRUE(wf_impl_json_is_int(id));
+
+    std::string message = create_binary_result(wf_impl_json_int_get(id), 5, '\0', "hello");
+    wf_impl_jsonrpc_proxy_onbinary(proxy, &message[0], message.size());
+
+    ASSERT_TRUE(finished_context.is_called);
+    ASSERT_TRUE(finished_context.is_error);
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, on_binary_ignore_incomplete_header)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+
+    BinaryFinishedContext finished_context;
+    void * finished_data = reinterpret_cast<void*>(&finished_context);
+    wf_impl_jsonrpc_proxy_invoke_binary(proxy, &jsonrpc_binary_finished, finished_data, "read", "si", "bar", 42);
+
+    wf_json const * id = wf_impl_json_object_get(send_context.response, "id");
+    ASSERT_TRUE(wf_impl_json_is_int(id));
+
+    std::string message = create_binary_result(wf_impl_json_int_get(id), 0, '\0', "").substr(0, 8);
+    wf_impl_jsonrpc_proxy_onbinary(proxy, &message[0], message.size());
+
+    ASSERT_FALSE(finished_context.is_called);
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy, invoke_with_message_pool)
+{
+    struct wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+    wf_message_pool pool;
+    wf_impl_message_pool_init(&pool);
+
+    SendContext send_context;
+    void * send_data = reinterpret_cast<void*>(&send_context);
+    struct wf_jsonrpc_proxy * proxy = wf_impl_jsonrpc_proxy_create(timer_manager, WF_DEFAULT_TIMEOUT, &jsonrpc_send, send_data);
+    wf_impl_jsonrpc_proxy_set_message_pool(proxy, &pool);
+
+    wf_impl_jsonrpc_proxy_notify(proxy, "foo", "s", "bar");
+    ASSERT_TRUE(send_context.is_called);
+    ASSERT_EQ(1, pool.free_count[1]);
+
+    // buffer grown by the writer is returned to its size class
+    std::string const contents(3000, 'x');
+    wf_impl_jsonrpc_proxy_notify(proxy, "foo", "s", contents.c_str());
+    wf_json const * params = wf_impl_json_object_get(send_context.response, "params");
+    ASSERT_EQ(contents, wf_impl_json_string_get(wf_impl_json_array_get(params, 0)));
+    ASSERT_EQ(0, pool.free_count[1]);
+    ASSERT_EQ(1, pool.free_count[3]);
+
+    wf_impl_jsonrpc_proxy_dispose(proxy);
+    wf_impl_timer_manager_dispose(timer_manager);
+    wf_impl_message_pool_cleanup(&pool);
+}
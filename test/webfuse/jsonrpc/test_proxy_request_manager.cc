@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include "webfuse/impl/jsonrpc/proxy_request_manager.h"
+#include "webfuse/impl/jsonrpc/response_intern.h"
+#include "webfuse/impl/timer/manager.h"
+#include "webfuse/status.h"
+
+#include <set>
+#include <vector>
+
+#define WF_DEFAULT_TIMEOUT (10 * 1000)
+
+namespace
+{
+    struct FinishedContext
+    {
+        int call_count;
+        bool is_error;
+
+        FinishedContext()
+        : call_count(0)
+        , is_error(false)
+        {
+        }
+    };
+
+    void on_finished(
+        void * user_data,
+        wf_json const *,
+        wf_jsonrpc_error const * error)
+    {
+        FinishedContext * context = reinterpret_cast<FinishedContext*>(user_data);
+        context->call_count++;
+        context->is_error = (nullptr != error);
+    }
+
+    void finish(wf_jsonrpc_proxy_request_manager * manager, int id)
+    {
+        wf_jsonrpc_response response = { nullptr, nullptr, id };
+        wf_impl_jsonrpc_proxy_request_manager_finish_request(manager, &response);
+    }
+}
+
+TEST(wf_jsonrpc_proxy_request_manager, finish_out_of_order)
+{
+    wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+    wf_jsonrpc_proxy_request_manager * manager =
+        wf_impl_jsonrpc_proxy_request_manager_create(timer_manager, WF_DEFAULT_TIMEOUT);
+
+    FinishedContext finished[3];
+    int ids[3];
+    for (int i = 0; i < 3; i++)
+    {
+        ids[i] = wf_impl_jsonrpc_proxy_request_manager_add_request(manager, &on_finished, &finished[i]);
+    }
+    ASSERT_EQ(3, wf_impl_jsonrpc_proxy_request_manager_count(manager));
+
+    finish(manager, ids[1]);
+    ASSERT_EQ(0, finished[0].call_count);
+    ASSERT_EQ(1, finished[1].call_count);
+    ASSERT_EQ(0, finished[2].call_count);
+
+    finish(manager, ids[2]);
+    finish(manager, ids[0]);
+    for (auto const & context: finished)
+    {
+        ASSERT_EQ(1, context.call_count);
+        ASSERT_FALSE(context.is_error);
+    }
+    ASSERT_EQ(0, wf_impl_jsonrpc_proxy_request_manager_count(manager));
+
+    wf_impl_jsonrpc_proxy_request_manager_dispose(manager);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy_request_manager, cancel_unknown_id)
+{
+    wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+    wf_jsonrpc_proxy_request_manager * manager =
+        wf_impl_jsonrpc_proxy_request_manager_create(timer_manager, WF_DEFAULT_TIMEOUT);
+
+    FinishedContext finished;
+    int id = wf_impl_jsonrpc_proxy_request_manager_add_request(manager, &on_finished, &finished);
+
+    wf_impl_jsonrpc_proxy_request_manager_cancel_request(manager, id + 1, WF_BAD, "cancelled");
+    ASSERT_EQ(0, finished.call_count);
+    ASSERT_EQ(1, wf_impl_jsonrpc_proxy_request_manager_count(manager));
+
+    wf_impl_jsonrpc_proxy_request_manager_cancel_request(manager, id, WF_BAD, "cancelled");
+    ASSERT_EQ(1, finished.call_count);
+    ASSERT_TRUE(finished.is_error);
+    ASSERT_EQ(0, wf_impl_jsonrpc_proxy_request_manager_count(manager));
+
+    wf_impl_jsonrpc_proxy_request_manager_dispose(manager);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy_request_manager, cancel_finished_request)
+{
+    wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+    wf_jsonrpc_proxy_request_manager * manager =
+        wf_impl_jsonrpc_proxy_request_manager_create(timer_manager, WF_DEFAULT_TIMEOUT);
+
+    FinishedContext finished;
+    int id = wf_impl_jsonrpc_proxy_request_manager_add_request(manager, &on_finished, &finished);
+    finish(manager, id);
+
+    wf_impl_jsonrpc_proxy_request_manager_cancel_request(manager, id, WF_BAD, "cancelled");
+    finish(manager, id);
+    ASSERT_EQ(1, finished.call_count);
+    ASSERT_FALSE(finished.is_error);
+
+    wf_impl_jsonrpc_proxy_request_manager_dispose(manager);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
+
+TEST(wf_jsonrpc_proxy_request_manager, grow_with_many_outstanding_requests)
+{
+    wf_timer_manager * timer_manager = wf_impl_timer_manager_create();
+    wf_jsonrpc_proxy_request_manager * manager =
+        wf_impl_jsonrpc_proxy_request_manager_create(timer_manager, WF_DEFAULT_TIMEOUT);
+
+    size_t const count = 1000;
+    std::vector<FinishedContext> finished(count);
+    std::vector<int> ids;
+    for (auto & context: finished)
+    {
+        ids.push_back(wf_impl_jsonrpc_proxy_request_manager_add_request(manager, &on_finished, &context));
+    }
+    ASSERT_EQ(count, wf_impl_jsonrpc_proxy_request_manager_count(manager));
+    ASSERT_EQ(count, std::set<int>(ids.begin(), ids.end()).size());
+
+    // finish every other request first, then the rest in reverse order
+    for (size_t i = 0; i < count; i += 2)
+    {
+        finish(manager, ids[i]);
+    }
+    ASSERT_EQ(count / 2, wf_impl_jsonrpc_proxy_request_manager_count(manager));
+    for (size_t i = count - 1; i < count; i -= 2)
+    {
+        finish(manager, ids[i]);
+    }
+
+    for (auto const & context: finished)
+    {
+        ASSERT_EQ(1, context.call_count);
+    }
+    ASSERT_EQ(0, wf_impl_jsonrpc_proxy_request_manager_count(manager));
+
+    wf_impl_jsonrpc_proxy_request_manager_dispose(manager);
+    wf_impl_timer_manager_dispose(timer_manager);
+}
@@ -12,6 +12,13 @@ WF_WRAP_VFUNC5(webfuse_test_MockJsonRpcProxy, void, wf_impl_jsonrpc_proxy_vinvok
 	char const *,
 	char const *);
 
+WF_WRAP_VFUNC5(webfuse_test_MockJsonRpcProxy, void, wf_impl_jsonrpc_proxy_vinvoke_binary,
+	struct wf_jsonrpc_proxy *,
+	wf_jsonrpc_proxy_finished_fn *,
+	void *,
+	char const *,
+	char const *);
+
 WF_WRAP_VFUNC3(webfuse_test_MockJsonRpcProxy, void, wf_impl_jsonrpc_proxy_vnotify,
 	struct wf_jsonrpc_proxy *,
 	char const *,
@@ -18,6 +18,12 @@ public:
         void * user_data,
         char const * method_name,
         char const * param_info));
+    MOCK_METHOD5(wf_impl_jsonrpc_proxy_vinvoke_binary, void (
+        struct wf_jsonrpc_proxy * proxy,
+        wf_jsonrpc_proxy_finished_fn * finished,
+        void * user_data,
+        char const * method_name,
+        char const * param_info));
     MOCK_METHOD3(wf_impl_jsonrpc_proxy_vnotify, void (
         struct wf_jsonrpc_proxy * proxy,
         char const * method_name,
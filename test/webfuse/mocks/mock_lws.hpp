@@ -0,0 +1,27 @@
+#ifndef MOCK_LWS_HPP
+#define MOCK_LWS_HPP
+
+#include <libwebsockets.h>
+#include <gmock/gmock.h>
+
+namespace webfuse_test
+{
+
+typedef void lws_sul_cb_fn(lws_sorted_usec_list_t * sul);
+
+class LwsMock
+{
+public:
+    LwsMock();
+    virtual ~LwsMock();
+
+    MOCK_METHOD4(lws_write, int (struct lws * wsi, unsigned char * buf, size_t len, enum lws_write_protocol protocol));
+    MOCK_METHOD1(lws_send_pipe_choked, int (struct lws * wsi));
+    MOCK_METHOD1(lws_callback_on_writable, int (struct lws * wsi));
+    MOCK_METHOD5(lws_sul_schedule, void (struct lws_context * context, int tsi,
+        lws_sorted_usec_list_t * sul, lws_sul_cb_fn * cb, lws_usec_t us));
+};
+
+}
+
+#endif
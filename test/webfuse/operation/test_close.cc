@@ -17,7 +17,7 @@ using testing::StrEq;
 TEST(wf_impl_operation_close, notify_proxy)
 {
     MockJsonRpcProxy proxy;
-    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vnotify(_,StrEq("close"),StrEq("siii"))).Times(1);
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vnotify(_,StrEq("close"),StrEq("sIIi"))).Times(1);
 
     MockOperationContext context;
     EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
@@ -25,6 +25,7 @@ TEST(wf_impl_operation_close, notify_proxy)
 
     wf_impl_operation_context op_context;
     op_context.name = nullptr;
+    op_context.readahead = nullptr;
     FuseMock fuse;
     EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
     EXPECT_CALL(fuse, fuse_reply_err(_, 0)).Times(1).WillOnce(Return(0));
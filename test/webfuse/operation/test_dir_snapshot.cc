@@ -0,0 +1,111 @@
+#include "webfuse/impl/operation/dir_snapshot.h"
+
+#include <gtest/gtest.h>
+#include <cstring>
+
+namespace
+{
+
+void add_entry(wf_impl_dir_snapshot * snapshot, char const * name, fuse_ino_t inode, bool has_attr = false)
+{
+    struct stat attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.st_ino = inode;
+    attr.st_mode = S_IFREG | 0444;
+    wf_impl_dir_snapshot_add(snapshot, name, &attr, has_attr, 1.0, 1.0);
+}
+
+}
+
+TEST(dir_snapshot, create_dispose)
+{
+    wf_impl_dir_snapshot * snapshot = wf_impl_dir_snapshot_create();
+    ASSERT_EQ(0, wf_impl_dir_snapshot_size(snapshot));
+    ASSERT_FALSE(wf_impl_dir_snapshot_contains(snapshot, 0));
+    wf_impl_dir_snapshot_dispose(snapshot);
+}
+
+TEST(dir_snapshot, add_many_entries)
+{
+    wf_impl_dir_snapshot * snapshot = wf_impl_dir_snapshot_create();
+    for(int i = 0; i < 100; i++)
+    {
+        std::string name = "file_" + std::to_string(i);
+        add_entry(snapshot, name.c_str(), i + 1);
+    }
+    wf_impl_dir_snapshot_set_loaded(snapshot, false, 0);
+
+    ASSERT_EQ(100, wf_impl_dir_snapshot_size(snapshot));
+    ASSERT_TRUE(wf_impl_dir_snapshot_contains(snapshot, 0));
+    ASSERT_TRUE(wf_impl_dir_snapshot_contains(snapshot, 100));
+    wf_impl_dir_snapshot_dispose(snapshot);
+}
+
+TEST(dir_snapshot, reset)
+{
+    wf_impl_dir_snapshot * snapshot = wf_impl_dir_snapshot_create();
+    add_entry(snapshot, "a.file", 42);
+    wf_impl_dir_snapshot_set_loaded(snapshot, false, 0);
+
+    wf_impl_dir_snapshot_reset(snapshot, 0);
+    ASSERT_EQ(0, wf_impl_dir_snapshot_size(snapshot));
+    ASSERT_FALSE(wf_impl_dir_snapshot_contains(snapshot, 0));
+    wf_impl_dir_snapshot_dispose(snapshot);
+}
+
+TEST(dir_snapshot, page)
+{
+    wf_impl_dir_snapshot * snapshot = wf_impl_dir_snapshot_create();
+    wf_impl_dir_snapshot_reset(snapshot, 10);
+    add_entry(snapshot, "a.file", 42);
+    add_entry(snapshot, "b.file", 43);
+    wf_impl_dir_snapshot_set_loaded(snapshot, true, 4711);
+
+    ASSERT_FALSE(wf_impl_dir_snapshot_contains(snapshot, 9));
+    ASSERT_TRUE(wf_impl_dir_snapshot_contains(snapshot, 10));
+    ASSERT_TRUE(wf_impl_dir_snapshot_contains(snapshot, 11));
+    ASSERT_FALSE(wf_impl_dir_snapshot_contains(snapshot, 12));
+
+    off_t offset;
+    int64_t cursor;
+    ASSERT_TRUE(wf_impl_dir_snapshot_get_next(snapshot, &offset, &cursor));
+    ASSERT_EQ(12, offset);
+    ASSERT_EQ(4711, cursor);
+
+    size_t const entry_size = fuse_add_direntry(nullptr, nullptr, 0, "b.file", nullptr, 0);
+    char buffer[1024];
+    ASSERT_EQ(entry_size, wf_impl_dir_snapshot_fill(snapshot, nullptr, 11, buffer, sizeof(buffer)));
+
+    wf_impl_dir_snapshot_dispose(snapshot);
+}
+
+TEST(dir_snapshot, fill_entries_that_fit)
+{
+    wf_impl_dir_snapshot * snapshot = wf_impl_dir_snapshot_create();
+    add_entry(snapshot, "a.file", 42);
+    add_entry(snapshot, "b.file", 43);
+    add_entry(snapshot, "c.file", 44);
+
+    size_t const entry_size = fuse_add_direntry(nullptr, nullptr, 0, "a.file", nullptr, 0);
+    char buffer[1024];
+    ASSERT_EQ(2 * entry_size, wf_impl_dir_snapshot_fill(snapshot, nullptr, 0, buffer, 2 * entry_size + 1));
+    ASSERT_EQ(entry_size, wf_impl_dir_snapshot_fill(snapshot, nullptr, 2, buffer, sizeof(buffer)));
+    ASSERT_EQ(0, wf_impl_dir_snapshot_fill(snapshot, nullptr, 3, buffer, sizeof(buffer)));
+    ASSERT_EQ(0, wf_impl_dir_snapshot_fill(snapshot, nullptr, 0, buffer, entry_size - 1));
+
+    wf_impl_dir_snapshot_dispose(snapshot);
+}
+
+TEST(dir_snapshot, fill_plus)
+{
+    wf_impl_dir_snapshot * snapshot = wf_impl_dir_snapshot_create();
+    add_entry(snapshot, "a.file", 42, true);
+    add_entry(snapshot, "b.file", 43, false);
+
+    size_t const entry_size = fuse_add_direntry_plus(nullptr, nullptr, 0, "a.file", nullptr, 0);
+    char buffer[1024];
+    ASSERT_EQ(2 * entry_size, wf_impl_dir_snapshot_fill_plus(snapshot, nullptr, 0, 0, 0, buffer, sizeof(buffer)));
+    ASSERT_EQ(entry_size, wf_impl_dir_snapshot_fill_plus(snapshot, nullptr, 0, 0, 1, buffer, sizeof(buffer)));
+
+    wf_impl_dir_snapshot_dispose(snapshot);
+}
@@ -1,5 +1,6 @@
 #include "webfuse/impl/operation/getattr.h"
 #include "webfuse/impl/jsonrpc/error.h"
+#include "webfuse/impl/cache/file_versions.h"
 
 #include "webfuse/status.h"
 
@@ -37,7 +38,7 @@ void free_context(
 TEST(wf_impl_operation_getattr, invoke_proxy)
 {
     MockJsonRpcProxy proxy;
-    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("getattr"),StrEq("si"))).Times(1)
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("getattr"),StrEq("sI"))).Times(1)
         .WillOnce(Invoke(free_context));
 
     MockOperationContext context;
@@ -46,6 +47,8 @@ TEST(wf_impl_operation_getattr, invoke_proxy)
 
     wf_impl_operation_context op_context;
     op_context.name = nullptr;
+    op_context.cache = nullptr;
+    op_context.versions = nullptr;
     fuse_ctx fuse_context;
     fuse_context.gid = 0;
     fuse_context.uid = 0;
@@ -88,6 +91,66 @@ TEST(wf_impl_operation_getattr, finished_file)
     context->inode = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    wf_impl_operation_getattr_finished(context, result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_getattr, finished_large_file)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_attr(_,_,_)).Times(1).WillOnce(Invoke(
+        [](fuse_req_t, struct stat const * attr, double) -> int
+        {
+            EXPECT_EQ(5000000000LL, attr->st_size);
+            return 0;
+        }));
+
+    JsonDoc result("{\"mode\": 493, \"type\": \"file\", \"size\": 5000000000}");
+
+    auto * context = reinterpret_cast<wf_impl_operation_getattr_context*>(malloc(sizeof(wf_impl_operation_getattr_context)));
+    context->inode = 1;
+    context->gid = 0;
+    context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    wf_impl_operation_getattr_finished(context, result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_getattr, finished_file_updates_versions)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_attr(_,_,_)).Times(1).WillOnce(Return(0));
+
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+    JsonDoc result("{\"mode\": 493, \"type\": \"file\", \"size\": 42, \"mtime\": 1000}");
+
+    auto * context = reinterpret_cast<wf_impl_operation_getattr_context*>(malloc(sizeof(wf_impl_operation_getattr_context)));
+    context->inode = 2;
+    context->gid = 0;
+    context->uid = 0;
+    context->cache = nullptr;
+    context->versions = versions;
+    wf_impl_operation_getattr_finished(context, result.root(), nullptr);
+
+    ASSERT_EQ(1, wf_impl_file_versions_size(versions));
+    wf_impl_file_versions_dispose(versions);
+}
+
+TEST(wf_impl_operation_getattr, finished_use_timeout_of_provider)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_attr(_,_,3600.0)).Times(1).WillOnce(Return(0));
+
+    JsonDoc result("{\"mode\": 493, \"type\": \"file\", \"attr_ttl\": 3600}");
+
+    auto * context = reinterpret_cast<wf_impl_operation_getattr_context*>(malloc(sizeof(wf_impl_operation_getattr_context)));
+    context->inode = 1;
+    context->gid = 0;
+    context->uid = 0;
+    context->timeout = 1.0;
+    context->cache = nullptr;
+    context->versions = nullptr;
     wf_impl_operation_getattr_finished(context, result.root(), nullptr);
 }
 
@@ -102,6 +165,8 @@ TEST(wf_impl_operation_getattr, finished_dir)
     context->inode = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
     wf_impl_operation_getattr_finished(context, result.root(), nullptr);
 }
 
@@ -116,6 +181,8 @@ TEST(wf_impl_operation_getattr, finished_unknown_type)
     context->inode = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
     wf_impl_operation_getattr_finished(context, result.root(), nullptr);
 }
 
@@ -131,6 +198,8 @@ TEST(wf_impl_operation_getattr, finished_fail_missing_mode)
     context->inode = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
     wf_impl_operation_getattr_finished(context, result.root(), nullptr);
 }
 
@@ -146,6 +215,8 @@ TEST(wf_impl_operation_getattr, finished_fail_invalid_mode_type)
     context->inode = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
     wf_impl_operation_getattr_finished(context, result.root(), nullptr);
 }
 
@@ -161,6 +232,8 @@ TEST(wf_impl_operation_getattr, finished_fail_missing_type)
     context->inode = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
     wf_impl_operation_getattr_finished(context, result.root(), nullptr);
 }
 
@@ -176,6 +249,8 @@ TEST(wf_impl_operation_getattr, finished_fail_invalid_type_type)
     context->inode = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
     wf_impl_operation_getattr_finished(context, result.root(), nullptr);
 }
 
@@ -191,6 +266,8 @@ TEST(wf_impl_operation_getattr, finished_error)
     context->inode = 1;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
     wf_impl_operation_getattr_finished(context, nullptr, error);
     wf_impl_jsonrpc_error_dispose(error);
 }
@@ -1,5 +1,6 @@
 #include "webfuse/impl/operation/lookup.h"
 #include "webfuse/impl/jsonrpc/error.h"
+#include "webfuse/impl/cache/negative_cache.h"
 
 #include "webfuse/status.h"
 
@@ -29,7 +30,9 @@ void free_context(
     char const * ,
     char const *)
 {
-    free(user_data);    
+    auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(user_data);
+    free(context->name);
+    free(context);
 }
 
 }
@@ -37,7 +40,7 @@ void free_context(
 TEST(wf_impl_operation_lookup, invoke_proxy)
 {
     MockJsonRpcProxy proxy;
-    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("lookup"),StrEq("sis"))).Times(1)
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("lookup"),StrEq("sIs"))).Times(1)
         .WillOnce(Invoke(free_context));
 
     MockOperationContext context;
@@ -46,6 +49,10 @@ TEST(wf_impl_operation_lookup, invoke_proxy)
 
     wf_impl_operation_context op_context;
     op_context.name = nullptr;
+    op_context.cache = nullptr;
+    op_context.versions = nullptr;
+    op_context.negative_cache = nullptr;
+    op_context.negative_timeout = 0.0;
     fuse_ctx fuse_context;
     fuse_context.gid = 0;
     fuse_context.uid = 0;
@@ -82,9 +89,40 @@ TEST(wf_impl_operation_lookup, finished_file)
 
     JsonDoc result("{\"inode\": 42, \"mode\": 493, \"type\": \"file\"}");
     auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
-    context->timeout = 1.0;
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->name = nullptr;
+    context->negative_timeout = 0.0;
+    context->negative_cache = nullptr;
+    wf_impl_operation_lookup_finished(context, result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_lookup, finished_large_file)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_entry(_,_)).Times(1).WillOnce(Invoke(
+        [](fuse_req_t, struct fuse_entry_param const * entry) -> int
+        {
+            EXPECT_EQ(5000000001ULL, entry->ino);
+            EXPECT_EQ(5000000000LL, entry->attr.st_size);
+            return 0;
+        }));
+
+    JsonDoc result("{\"inode\": 5000000001, \"mode\": 493, \"type\": \"file\", \"size\": 5000000000}");
+    auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
+    context->gid = 0;
+    context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->name = nullptr;
+    context->negative_timeout = 0.0;
+    context->negative_cache = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -95,9 +133,15 @@ TEST(wf_impl_operation_lookup, finished_dir)
 
     JsonDoc result("{\"inode\": 42, \"mode\": 493, \"type\": \"dir\"}");
     auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
-    context->timeout = 1.0;
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->name = nullptr;
+    context->negative_timeout = 0.0;
+    context->negative_cache = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -108,9 +152,15 @@ TEST(wf_impl_operation_lookup, finished_unknown_type)
 
     JsonDoc result("{\"inode\": 42, \"mode\": 493, \"type\": \"unknown\"}");
     auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
-    context->timeout = 1.0;
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->name = nullptr;
+    context->negative_timeout = 0.0;
+    context->negative_cache = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -122,9 +172,15 @@ TEST(wf_impl_operation_lookup, finished_fail_missing_inode)
 
     JsonDoc result("{\"mode\": 493, \"type\": \"file\"}");
     auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
-    context->timeout = 1.0;
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->name = nullptr;
+    context->negative_timeout = 0.0;
+    context->negative_cache = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -136,9 +192,15 @@ TEST(wf_impl_operation_lookup, finished_fail_invalid_inode_type)
 
     JsonDoc result("{\"inode\": \"42\", \"mode\": 493, \"type\": \"file\"}");
     auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
-    context->timeout = 1.0;
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->name = nullptr;
+    context->negative_timeout = 0.0;
+    context->negative_cache = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -150,9 +212,15 @@ TEST(wf_impl_operation_lookup, finished_fail_missing_mode)
 
     JsonDoc result("{\"inode\": 42, \"type\": \"file\"}");
     auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
-    context->timeout = 1.0;
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->name = nullptr;
+    context->negative_timeout = 0.0;
+    context->negative_cache = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -164,9 +232,15 @@ TEST(wf_impl_operation_lookup, finished_fail_invalid_mode_type)
 
     JsonDoc result("{\"inode\": 42, \"mode\": \"0755\", \"type\": \"file\"}");
     auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
-    context->timeout = 1.0;
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->name = nullptr;
+    context->negative_timeout = 0.0;
+    context->negative_cache = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -178,9 +252,15 @@ TEST(wf_impl_operation_lookup, finished_fail_missing_type)
 
     JsonDoc result("{\"inode\": 42, \"mode\": 493}");
     auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
-    context->timeout = 1.0;
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->name = nullptr;
+    context->negative_timeout = 0.0;
+    context->negative_cache = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -192,9 +272,15 @@ TEST(wf_impl_operation_lookup, finished_fail_invalid_type_type)
 
     JsonDoc result("{\"inode\": 42, \"mode\": 493, \"type\": 42}");
     auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
-    context->timeout = 1.0;
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->name = nullptr;
+    context->negative_timeout = 0.0;
+    context->negative_cache = nullptr;
     wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
 
@@ -207,9 +293,156 @@ TEST(wf_impl_operation_lookup, finished_error)
     struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD, "");
 
     auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
-    context->timeout = 1.0;
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
+    context->gid = 0;
+    context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->name = nullptr;
+    context->negative_timeout = 0.0;
+    context->negative_cache = nullptr;
+    wf_impl_operation_lookup_finished(context, nullptr, error);
+    wf_impl_jsonrpc_error_dispose(error);
+}
+
+TEST(wf_impl_operation_lookup, finished_noentry_replies_negative_entry)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_err(_, _)).Times(0);
+    EXPECT_CALL(fuse, fuse_reply_entry(_,_)).Times(1).WillOnce(Invoke(
+        [](fuse_req_t, struct fuse_entry_param const * entry) -> int
+        {
+            EXPECT_EQ(0, entry->ino);
+            EXPECT_EQ(5.0, entry->entry_timeout);
+            return 0;
+        }));
+
+    wf_impl_negative_cache * negative_cache = wf_impl_negative_cache_create();
+    struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD_NOENTRY, "");
+
+    auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
     context->gid = 0;
     context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->parent = 1;
+    context->name = strdup("missing.file");
+    context->negative_timeout = 5.0;
+    context->negative_cache = negative_cache;
     wf_impl_operation_lookup_finished(context, nullptr, error);
     wf_impl_jsonrpc_error_dispose(error);
+
+    ASSERT_TRUE(wf_impl_negative_cache_contains(negative_cache, 1, "missing.file"));
+    wf_impl_negative_cache_dispose(negative_cache);
+}
+
+TEST(wf_impl_operation_lookup, finished_noentry_fails_without_negative_timeout)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_entry(_,_)).Times(0);
+    EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
+
+    struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD_NOENTRY, "");
+
+    auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
+    context->gid = 0;
+    context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->parent = 1;
+    context->name = strdup("missing.file");
+    context->negative_timeout = 0.0;
+    context->negative_cache = nullptr;
+    wf_impl_operation_lookup_finished(context, nullptr, error);
+    wf_impl_jsonrpc_error_dispose(error);
+}
+
+TEST(wf_impl_operation_lookup, answer_from_negative_cache)
+{
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,_,_)).Times(0);
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.cache = nullptr;
+    op_context.versions = nullptr;
+    op_context.negative_cache = wf_impl_negative_cache_create();
+    op_context.negative_timeout = 5.0;
+    wf_impl_negative_cache_add(op_context.negative_cache, 1, "missing.file", wf_impl_timer_timepoint_in_msec(60 * 1000));
+
+    fuse_ctx fuse_context;
+    fuse_context.gid = 0;
+    fuse_context.uid = 0;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_ctx(_)).Times(1).WillOnce(Return(&fuse_context));
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_entry(_,_)).Times(1).WillOnce(Invoke(
+        [](fuse_req_t, struct fuse_entry_param const * entry) -> int
+        {
+            EXPECT_EQ(0, entry->ino);
+            return 0;
+        }));
+
+    wf_impl_operation_lookup(nullptr, 1, "missing.file");
+
+    wf_impl_negative_cache_dispose(op_context.negative_cache);
+}
+
+TEST(wf_impl_operation_lookup, finished_use_timeouts_of_provider)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_entry(_,_)).Times(1).WillOnce(Invoke(
+        [](fuse_req_t, struct fuse_entry_param const * entry) -> int
+        {
+            EXPECT_EQ(3600.0, entry->attr_timeout);
+            EXPECT_EQ(7200.0, entry->entry_timeout);
+            return 0;
+        }));
+
+    JsonDoc result("{\"inode\": 42, \"mode\": 493, \"type\": \"file\", \"attr_ttl\": 3600, \"entry_ttl\": 7200}");
+    auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
+    context->gid = 0;
+    context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->name = nullptr;
+    context->negative_timeout = 0.0;
+    context->negative_cache = nullptr;
+    wf_impl_operation_lookup_finished(context, result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_lookup, finished_use_default_timeouts)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_entry(_,_)).Times(1).WillOnce(Invoke(
+        [](fuse_req_t, struct fuse_entry_param const * entry) -> int
+        {
+            EXPECT_EQ(2.0, entry->attr_timeout);
+            EXPECT_EQ(3.0, entry->entry_timeout);
+            return 0;
+        }));
+
+    JsonDoc result("{\"inode\": 42, \"mode\": 493, \"type\": \"file\"}");
+    auto * context = reinterpret_cast<wf_impl_operation_lookup_context*>(malloc(sizeof(wf_impl_operation_lookup_context)));
+    context->attr_timeout = 2.0;
+    context->entry_timeout = 3.0;
+    context->gid = 0;
+    context->uid = 0;
+    context->cache = nullptr;
+    context->versions = nullptr;
+    context->name = nullptr;
+    context->negative_timeout = 0.0;
+    context->negative_cache = nullptr;
+    wf_impl_operation_lookup_finished(context, result.root(), nullptr);
 }
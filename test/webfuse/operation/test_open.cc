@@ -1,5 +1,6 @@
 #include "webfuse/impl/operation/open.h"
 #include "webfuse/impl/jsonrpc/error.h"
+#include "webfuse/impl/cache/file_versions.h"
 
 #include "webfuse/status.h"
 
@@ -9,6 +10,7 @@
 #include "webfuse/mocks/mock_jsonrpc_proxy.hpp"
 
 #include <gtest/gtest.h>
+#include <cstdlib>
 
 using webfuse_test::JsonDoc;
 using webfuse_test::MockJsonRpcProxy;
@@ -16,12 +18,65 @@ using webfuse_test::MockOperationContext;
 using webfuse_test::FuseMock;
 using testing::_;
 using testing::Return;
+using testing::Invoke;
 using testing::StrEq;
 
+namespace
+{
+
+void free_context(
+    struct wf_jsonrpc_proxy * ,
+    wf_jsonrpc_proxy_finished_fn * ,
+    void * user_data,
+    char const * ,
+    char const *)
+{
+    free(user_data);    
+}
+
+wf_impl_operation_open_context * create_context(wf_impl_file_versions * versions = nullptr, size_t direct_io_threshold = 0)
+{
+    auto * context = reinterpret_cast<wf_impl_operation_open_context*>(malloc(sizeof(wf_impl_operation_open_context)));
+    context->request = nullptr;
+    context->inode = 2;
+    context->versions = versions;
+    context->direct_io_threshold = direct_io_threshold;
+
+    return context;
+}
+
+int expect_keep_cache(fuse_req_t, struct fuse_file_info const * file_info)
+{
+    EXPECT_EQ(1, file_info->keep_cache);
+    return 0;
+}
+
+int expect_no_keep_cache(fuse_req_t, struct fuse_file_info const * file_info)
+{
+    EXPECT_EQ(0, file_info->keep_cache);
+    return 0;
+}
+
+int expect_direct_io(fuse_req_t, struct fuse_file_info const * file_info)
+{
+    EXPECT_EQ(1, file_info->direct_io);
+    EXPECT_EQ(0, file_info->keep_cache);
+    return 0;
+}
+
+int expect_no_direct_io(fuse_req_t, struct fuse_file_info const * file_info)
+{
+    EXPECT_EQ(0, file_info->direct_io);
+    return 0;
+}
+
+}
+
 TEST(wf_impl_operation_open, invoke_proxy)
 {
     MockJsonRpcProxy proxy;
-    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("open"),StrEq("sii"))).Times(1);
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("open"),StrEq("sIi"))).Times(1)
+        .WillOnce(Invoke(free_context));
 
     MockOperationContext context;
     EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
@@ -29,6 +84,8 @@ TEST(wf_impl_operation_open, invoke_proxy)
 
     wf_impl_operation_context op_context;
     op_context.name = nullptr;
+    op_context.versions = nullptr;
+    op_context.direct_io_threshold = 0;
     FuseMock fuse;
     EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
 
@@ -62,7 +119,21 @@ TEST(wf_impl_operation_open, finished)
     EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(1).WillOnce(Return(0));
 
     JsonDoc result("{\"handle\": 42}");
-    wf_impl_operation_open_finished(nullptr, result.root(), nullptr);
+    wf_impl_operation_open_finished(create_context(), result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_open, finished_large_handle)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(1).WillOnce(Invoke(
+        [](fuse_req_t, struct fuse_file_info const * file_info) -> int
+        {
+            EXPECT_EQ(5000000000ULL, file_info->fh);
+            return 0;
+        }));
+
+    JsonDoc result("{\"handle\": 5000000000}");
+    wf_impl_operation_open_finished(create_context(), result.root(), nullptr);
 }
 
 TEST(wf_impl_operation_open, finished_fail_error)
@@ -72,7 +143,7 @@ TEST(wf_impl_operation_open, finished_fail_error)
     EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
 
     struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD, "");
-    wf_impl_operation_open_finished(nullptr, nullptr, error);
+    wf_impl_operation_open_finished(create_context(), nullptr, error);
     wf_impl_jsonrpc_error_dispose(error);
 }
 
@@ -83,7 +154,7 @@ TEST(wf_impl_operation_open, finished_fail_no_handle)
     EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
 
     JsonDoc result("{}");
-    wf_impl_operation_open_finished(nullptr, result.root(), nullptr);
+    wf_impl_operation_open_finished(create_context(), result.root(), nullptr);
 }
 
 TEST(wf_impl_operation_open, finished_fail_invalid_handle_type)
@@ -93,5 +164,113 @@ TEST(wf_impl_operation_open, finished_fail_invalid_handle_type)
     EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
 
     JsonDoc result("{\"handle\": \"42\"}");
-    wf_impl_operation_open_finished(nullptr, result.root(), nullptr);
+    wf_impl_operation_open_finished(create_context(), result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_open, finished_no_keep_cache_by_default)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(1).WillOnce(Invoke(expect_no_keep_cache));
+
+    JsonDoc result("{\"handle\": 42}");
+    wf_impl_operation_open_finished(create_context(), result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_open, finished_keep_cache_if_cacheable)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(1).WillOnce(Invoke(expect_keep_cache));
+
+    JsonDoc result("{\"handle\": 42, \"cacheable\": true}");
+    wf_impl_operation_open_finished(create_context(), result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_open, finished_keep_cache_if_immutable)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(1).WillOnce(Invoke(expect_keep_cache));
+
+    JsonDoc result("{\"handle\": 42, \"immutable\": true}");
+    wf_impl_operation_open_finished(create_context(), result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_open, finished_keep_cache_if_reopened_unchanged)
+{
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+    wf_impl_file_versions_update(versions, 2, 42, 1000);
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(2)
+        .WillOnce(Invoke(expect_no_keep_cache))
+        .WillOnce(Invoke(expect_keep_cache));
+
+    JsonDoc result("{\"handle\": 42}");
+    wf_impl_operation_open_finished(create_context(versions), result.root(), nullptr);
+    wf_impl_file_versions_update(versions, 2, 42, 1000);
+    wf_impl_operation_open_finished(create_context(versions), result.root(), nullptr);
+
+    wf_impl_file_versions_dispose(versions);
+}
+
+TEST(wf_impl_operation_open, finished_no_keep_cache_if_reopened_changed)
+{
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+    wf_impl_file_versions_update(versions, 2, 42, 1000);
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(2)
+        .WillRepeatedly(Invoke(expect_no_keep_cache));
+
+    JsonDoc result("{\"handle\": 42}");
+    wf_impl_operation_open_finished(create_context(versions), result.root(), nullptr);
+    wf_impl_file_versions_update(versions, 2, 42, 1001);
+    wf_impl_operation_open_finished(create_context(versions), result.root(), nullptr);
+
+    wf_impl_file_versions_dispose(versions);
+}
+
+TEST(wf_impl_operation_open, finished_no_direct_io_by_default)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(1).WillOnce(Invoke(expect_no_direct_io));
+
+    JsonDoc result("{\"handle\": 42}");
+    wf_impl_operation_open_finished(create_context(), result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_open, finished_direct_io_if_requested)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(1).WillOnce(Invoke(expect_direct_io));
+
+    JsonDoc result("{\"handle\": 42, \"direct_io\": true, \"immutable\": true}");
+    wf_impl_operation_open_finished(create_context(), result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_open, finished_direct_io_if_file_exceeds_threshold)
+{
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+    wf_impl_file_versions_update(versions, 2, 300 * 1024 * 1024, 1000);
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(1).WillOnce(Invoke(expect_direct_io));
+
+    JsonDoc result("{\"handle\": 42}");
+    wf_impl_operation_open_finished(create_context(versions, 100 * 1024 * 1024), result.root(), nullptr);
+
+    wf_impl_file_versions_dispose(versions);
+}
+
+TEST(wf_impl_operation_open, finished_no_direct_io_if_file_below_threshold)
+{
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+    wf_impl_file_versions_update(versions, 2, 42, 1000);
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(1).WillOnce(Invoke(expect_no_direct_io));
+
+    JsonDoc result("{\"handle\": 42}");
+    wf_impl_operation_open_finished(create_context(versions, 100 * 1024 * 1024), result.root(), nullptr);
+
+    wf_impl_file_versions_dispose(versions);
 }
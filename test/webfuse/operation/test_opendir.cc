@@ -0,0 +1,53 @@
+#include "webfuse/impl/operation/opendir.h"
+#include "webfuse/impl/operation/releasedir.h"
+#include "webfuse/impl/operation/dir_snapshot.h"
+
+#include "webfuse/mocks/mock_fuse.hpp"
+
+#include <gtest/gtest.h>
+
+using webfuse_test::FuseMock;
+using testing::_;
+using testing::Return;
+using testing::Invoke;
+
+TEST(wf_impl_operation_opendir, create_snapshot)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(1).WillOnce(Invoke(
+        [](fuse_req_t, fuse_file_info const * file_info) -> int
+        {
+            EXPECT_NE(0, file_info->fh);
+            return 0;
+        }));
+    EXPECT_CALL(fuse, fuse_reply_err(_, 0)).Times(1).WillOnce(Return(0));
+
+    fuse_file_info file_info;
+    memset(&file_info, 0, sizeof(file_info));
+    wf_impl_operation_opendir(nullptr, 1, &file_info);
+
+    auto * snapshot = reinterpret_cast<wf_impl_dir_snapshot*>(file_info.fh);
+    ASSERT_FALSE(wf_impl_dir_snapshot_contains(snapshot, 0));
+
+    wf_impl_operation_releasedir(nullptr, 1, &file_info);
+}
+
+TEST(wf_impl_operation_opendir, dispose_snapshot_if_reply_fails)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_open(_,_)).Times(1).WillOnce(Return(-ENOENT));
+
+    fuse_file_info file_info;
+    memset(&file_info, 0, sizeof(file_info));
+    wf_impl_operation_opendir(nullptr, 1, &file_info);
+}
+
+TEST(wf_impl_operation_releasedir, ignore_missing_snapshot)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_err(_, 0)).Times(1).WillOnce(Return(0));
+
+    fuse_file_info file_info;
+    memset(&file_info, 0, sizeof(file_info));
+    wf_impl_operation_releasedir(nullptr, 1, &file_info);
+}
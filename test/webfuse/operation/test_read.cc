@@ -1,5 +1,7 @@
 #include "webfuse/impl/operation/read.h"
 #include "webfuse/impl/jsonrpc/error.h"
+#include "webfuse/impl/cache/block_cache.h"
+#include "webfuse/impl/util/base64.h"
 
 #include "webfuse/test_util/json_doc.hpp"
 #include "webfuse/mocks/mock_fuse.hpp"
@@ -7,19 +9,23 @@
 #include "webfuse/mocks/mock_jsonrpc_proxy.hpp"
 
 #include <gtest/gtest.h>
+#include <zlib.h>
+#include <string>
+#include <vector>
 
 using webfuse_test::JsonDoc;
 using webfuse_test::MockJsonRpcProxy;
 using webfuse_test::MockOperationContext;
 using webfuse_test::FuseMock;
 using testing::_;
+using testing::Invoke;
 using testing::Return;
 using testing::StrEq;
 
 TEST(wf_impl_operation_read, invoke_proxy)
 {
     MockJsonRpcProxy proxy;
-    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("read"),StrEq("siiii"))).Times(1);
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_binary(_,_,_,StrEq("read"),StrEq("sIIIi"))).Times(1);
 
     MockOperationContext context;
     EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
@@ -27,6 +33,8 @@ TEST(wf_impl_operation_read, invoke_proxy)
 
     wf_impl_operation_context op_context;
     op_context.name = nullptr;
+    op_context.readahead = nullptr;
+    op_context.cache = nullptr;
     FuseMock fuse;
     EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
 
@@ -39,28 +47,234 @@ TEST(wf_impl_operation_read, invoke_proxy)
     wf_impl_operation_read(request, inode, size, offset, &file_info);
 }
 
-TEST(wf_impl_operation_read, invoke_proxy_limit_size)
+namespace
+{
+
+struct PendingRead
+{
+    wf_jsonrpc_proxy_finished_fn * finished;
+    void * user_data;
+};
+
+void read_split(MockJsonRpcProxy & proxy, std::vector<PendingRead> & pending, size_t size)
+{
+    ON_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_binary(_,_,_,StrEq("read"),StrEq("sIIIi")))
+        .WillByDefault(Invoke([&pending](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn * finished,
+            void * user_data, char const *, char const *)
+        {
+            pending.push_back(PendingRead{finished, user_data});
+        }));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.readahead = nullptr;
+    op_context.cache = nullptr;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+
+    fuse_file_info file_info;
+    file_info.fh = 1;
+    wf_impl_operation_read(nullptr, 1, size, 0, &file_info);
+}
+
+void finish(PendingRead const & read, size_t count)
+{
+    std::string text = std::string("{\"data\": \"") + std::string(count, 'x')
+        + "\", \"format\": \"identity\", \"count\": " + std::to_string(count) + "}";
+    JsonDoc result(text);
+    read.finished(read.user_data, result.root(), nullptr);
+}
+
+void fail(PendingRead const & read)
+{
+    struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD, "");
+    read.finished(read.user_data, nullptr, error);
+    wf_impl_jsonrpc_error_dispose(error);
+}
+
+}
+
+TEST(wf_impl_operation_read, invoke_proxy_split_size)
+{
+    size_t const chunk_size = 1024 * 1024;
+    testing::NiceMock<MockJsonRpcProxy> proxy;
+    std::vector<PendingRead> pending;
+    read_split(proxy, pending, (2 * chunk_size) + 42);
+    ASSERT_EQ(3, pending.size());
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,(2 * chunk_size) + 42)).Times(1).WillOnce(Return(0));
+
+    finish(pending[2], 42);
+    finish(pending[0], chunk_size);
+    finish(pending[1], chunk_size);
+}
+
+TEST(wf_impl_operation_read, split_read_short_read_on_partial_failure)
+{
+    size_t const chunk_size = 1024 * 1024;
+    testing::NiceMock<MockJsonRpcProxy> proxy;
+    std::vector<PendingRead> pending;
+    read_split(proxy, pending, 3 * chunk_size);
+    ASSERT_EQ(3, pending.size());
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,chunk_size)).Times(1).WillOnce(Return(0));
+
+    finish(pending[0], chunk_size);
+    fail(pending[1]);
+    finish(pending[2], chunk_size);
+}
+
+TEST(wf_impl_operation_read, split_read_short_read_at_end_of_file)
+{
+    size_t const chunk_size = 1024 * 1024;
+    testing::NiceMock<MockJsonRpcProxy> proxy;
+    std::vector<PendingRead> pending;
+    read_split(proxy, pending, 3 * chunk_size);
+    ASSERT_EQ(3, pending.size());
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,chunk_size + 42)).Times(1).WillOnce(Return(0));
+
+    finish(pending[0], chunk_size);
+    finish(pending[1], 42);
+    finish(pending[2], 0);
+}
+
+TEST(wf_impl_operation_read, split_read_fail_if_first_chunk_fails)
+{
+    size_t const chunk_size = 1024 * 1024;
+    testing::NiceMock<MockJsonRpcProxy> proxy;
+    std::vector<PendingRead> pending;
+    read_split(proxy, pending, 2 * chunk_size);
+    ASSERT_EQ(2, pending.size());
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(0);
+    EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
+
+    fail(pending[0]);
+    finish(pending[1], chunk_size);
+}
+
+TEST(wf_impl_operation_read, split_read_caches_complete_last_chunk)
+{
+    size_t const chunk_size = 1024 * 1024;
+    size_t const size = chunk_size + (chunk_size / 2);
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(4 * chunk_size);
+    wf_impl_block_cache_update(cache, 1, 10 * chunk_size, 42);
+
+    testing::NiceMock<MockJsonRpcProxy> proxy;
+    std::vector<PendingRead> pending;
+    ON_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_binary(_,_,_,StrEq("read"),StrEq("sIIIi")))
+        .WillByDefault(Invoke([&pending](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn * finished,
+            void * user_data, char const *, char const *)
+        {
+            pending.push_back(PendingRead{finished, user_data});
+        }));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(2)
+        .WillRepeatedly(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.readahead = nullptr;
+    op_context.cache = cache;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(2).WillRepeatedly(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,size)).Times(1).WillOnce(Return(0));
+
+    fuse_file_info file_info;
+    file_info.fh = 1;
+    wf_impl_operation_read(nullptr, 1, size, 0, &file_info);
+    ASSERT_EQ(2, pending.size());
+    finish(pending[0], chunk_size);
+    finish(pending[1], chunk_size / 2);
+
+    // the block following the split read is not cached; the last chunk
+    // was complete, so it does not mark the end of the file
+    off_t const offset = (off_t) (size - WF_BLOCK_CACHE_BLOCK_SIZE);
+    wf_impl_operation_read(nullptr, 1, 2 * WF_BLOCK_CACHE_BLOCK_SIZE, offset, &file_info);
+    ASSERT_EQ(3, pending.size());
+
+    wf_impl_block_cache_dispose(cache);
+}
+
+TEST(wf_impl_operation_read, fail_cached_read_if_reply_exceeds_size)
+{
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(1024 * 1024);
+    wf_impl_block_cache_update(cache, 1, 10 * WF_BLOCK_CACHE_BLOCK_SIZE, 42);
+    size_t const cache_size = wf_impl_block_cache_size(cache);
+
+    testing::NiceMock<MockJsonRpcProxy> proxy;
+    std::vector<PendingRead> pending;
+    ON_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_binary(_,_,_,StrEq("read"),StrEq("sIIIi")))
+        .WillByDefault(Invoke([&pending](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn * finished,
+            void * user_data, char const *, char const *)
+        {
+            pending.push_back(PendingRead{finished, user_data});
+        }));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.readahead = nullptr;
+    op_context.cache = cache;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(0);
+    EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
+
+    fuse_file_info file_info;
+    file_info.fh = 1;
+    wf_impl_operation_read(nullptr, 1, WF_BLOCK_CACHE_BLOCK_SIZE, 0, &file_info);
+    ASSERT_EQ(1, pending.size());
+    finish(pending[0], 2 * WF_BLOCK_CACHE_BLOCK_SIZE);
+
+    ASSERT_EQ(cache_size, wf_impl_block_cache_size(cache));
+
+    wf_impl_block_cache_dispose(cache);
+}
+
+TEST(wf_impl_operation_read, read_from_cache)
 {
     MockJsonRpcProxy proxy;
-    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("read"),StrEq("siiii"))).Times(0);
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_binary(_,_,_,StrEq("read"),StrEq("sIIIi"))).Times(0);
 
     MockOperationContext context;
     EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
         .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
 
+    wf_impl_block_cache * cache = wf_impl_block_cache_create(1024 * 1024);
+    wf_impl_block_cache_update(cache, 1, 5, 42);
+    wf_impl_block_cache_put(cache, wf_impl_block_cache_get_generation(cache), 1, 0, WF_BLOCK_CACHE_BLOCK_SIZE, "Hello", 5);
+
     wf_impl_operation_context op_context;
     op_context.name = nullptr;
+    op_context.readahead = nullptr;
+    op_context.cache = cache;
     FuseMock fuse;
     EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
-    EXPECT_CALL(fuse, fuse_reply_err(_,_)).Times(1);
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,5)).Times(1).WillOnce(Return(0));
 
     fuse_req_t request = nullptr;
     fuse_ino_t inode = 1;
-    size_t size = 100 * 1024 * 1024;
+    size_t size = 42;
     off_t offset = 0;
     fuse_file_info file_info;
     file_info.fh = 1;
     wf_impl_operation_read(request, inode, size, offset, &file_info);
+
+    wf_impl_block_cache_dispose(cache);
 }
 
 TEST(wf_impl_operation_read, fail_rpc_null)
@@ -108,6 +322,110 @@ TEST(wf_impl_operation_read, fill_buffer_base64)
     ASSERT_EQ(0, strncmp("brummni", buffer, 7));
 }
 
+TEST(wf_impl_operation_read, finished_base64_large)
+{
+    std::string const data(4096, 'x');
+    std::string encoded(wf_impl_base64_encoded_size(data.size()) + 1, '\0');
+    encoded.resize(wf_impl_base64_encode(reinterpret_cast<uint8_t const*>(data.data()), data.size(), &encoded[0], encoded.size()));
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,4096)).Times(1).WillOnce(Invoke(
+        [&data](fuse_req_t, char const * buffer, size_t size) -> int
+        {
+            EXPECT_EQ(data, std::string(buffer, size));
+            return 0;
+        }));
+
+    JsonDoc result("{\"data\": \"" + encoded + "\", \"format\": \"base64\", \"count\": 4096}");
+    wf_impl_operation_read_finished(nullptr, result.root(), nullptr);
+}
+
+namespace
+{
+
+std::string compress_data(std::string const & data)
+{
+    uLongf size = compressBound(data.size());
+    std::string compressed(size, '\0');
+    compress(reinterpret_cast<Bytef*>(&compressed[0]), &size, reinterpret_cast<Bytef const*>(data.data()), data.size());
+    compressed.resize(size);
+
+    return compressed;
+}
+
+}
+
+TEST(wf_impl_operation_read, inflate_deflate)
+{
+    std::string const data(4096, 'x');
+    std::string compressed = compress_data(data);
+
+    wf_status status;
+    char * buffer = wf_impl_operation_read_inflate(&compressed[0], compressed.size(), "deflate", data.size(), &status);
+    ASSERT_EQ(WF_GOOD, status);
+    ASSERT_EQ(data, std::string(buffer, data.size()));
+    free(buffer);
+}
+
+TEST(wf_impl_operation_read, inflate_fail_inconsistent_size)
+{
+    std::string compressed = compress_data("brummni");
+
+    wf_status status;
+    char * buffer = wf_impl_operation_read_inflate(&compressed[0], compressed.size(), "deflate", 8, &status);
+    ASSERT_NE(WF_GOOD, status);
+    ASSERT_EQ(nullptr, buffer);
+}
+
+TEST(wf_impl_operation_read, inflate_fail_invalid_data)
+{
+    char text[] = "brummni";
+
+    wf_status status;
+    char * buffer = wf_impl_operation_read_inflate(text, 7, "deflate", 7, &status);
+    ASSERT_NE(WF_GOOD, status);
+    ASSERT_EQ(nullptr, buffer);
+}
+
+TEST(wf_impl_operation_read, inflate_fail_too_large)
+{
+    std::string compressed = compress_data(std::string(2 * 1024 * 1024, 'x'));
+
+    wf_status status;
+    char * buffer = wf_impl_operation_read_inflate(&compressed[0], compressed.size(), "deflate", 2 * 1024 * 1024, &status);
+    ASSERT_NE(WF_GOOD, status);
+    ASSERT_EQ(nullptr, buffer);
+}
+
+TEST(wf_impl_operation_read, finished_deflate_base64)
+{
+    std::string const data(4096, 'x');
+    std::string compressed = compress_data(data);
+    std::string encoded(wf_impl_base64_encoded_size(compressed.size()) + 1, '\0');
+    encoded.resize(wf_impl_base64_encode(reinterpret_cast<uint8_t const*>(compressed.data()), compressed.size(), &encoded[0], encoded.size()));
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,4096)).Times(1).WillOnce(Invoke(
+        [&data](fuse_req_t, char const * buffer, size_t size) -> int
+        {
+            EXPECT_EQ(data, std::string(buffer, size));
+            return 0;
+        }));
+
+    JsonDoc result("{\"data\": \"" + encoded + "\", \"format\": \"deflate+base64\", \"count\": 4096}");
+    wf_impl_operation_read_finished(nullptr, result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_read, finished_fail_invalid_deflate_base64)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(0);
+    EXPECT_CALL(fuse, fuse_reply_err(_, _)).Times(1).WillOnce(Return(0));
+
+    JsonDoc result("{\"data\": \"YnJ1bW1uaQ==\", \"format\": \"deflate+base64\", \"count\": 7}");
+    wf_impl_operation_read_finished(nullptr, result.root(), nullptr);
+}
+
 TEST(wf_impl_operation_read, fill_buffer_base64_fail_invalid_data)
 {
     wf_status status;
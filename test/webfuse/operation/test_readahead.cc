@@ -0,0 +1,222 @@
+#include "webfuse/impl/operation/readahead.h"
+#include "webfuse/impl/jsonrpc/error.h"
+#include "webfuse/impl/util/base64.h"
+#include "webfuse/status.h"
+
+#include "webfuse/test_util/json_doc.hpp"
+#include "webfuse/mocks/mock_fuse.hpp"
+#include "webfuse/mocks/mock_jsonrpc_proxy.hpp"
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+#include <vector>
+
+using webfuse_test::JsonDoc;
+using webfuse_test::MockJsonRpcProxy;
+using webfuse_test::FuseMock;
+using testing::_;
+using testing::Invoke;
+using testing::Return;
+using testing::StrEq;
+
+namespace
+{
+
+struct PendingRead
+{
+    wf_jsonrpc_proxy_finished_fn * finished;
+    void * user_data;
+};
+
+class ReadaheadTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ON_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke_binary(_,_,_,StrEq("read"),StrEq("sIIIi")))
+            .WillByDefault(Invoke([this](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn * finished,
+                void * user_data, char const *, char const *)
+            {
+                pending.push_back(PendingRead{finished, user_data});
+            }));
+        readahead = wf_impl_readahead_create(4 * 16, nullptr);
+    }
+
+    void TearDown() override
+    {
+        wf_impl_readahead_dispose(readahead);
+    }
+
+    void read(fuse_req_t request, size_t size, off_t offset)
+    {
+        wf_impl_readahead_read(readahead, reinterpret_cast<wf_jsonrpc_proxy*>(&proxy), "test",
+            request, 2, 42, size, offset);
+    }
+
+    void finish(size_t index, char const * data)
+    {
+        std::string text = std::string("{\"data\": \"") + data + "\", \"format\": \"identity\", \"count\": "
+            + std::to_string(strlen(data)) + "}";
+        JsonDoc result(text);
+        pending[index].finished(pending[index].user_data, result.root(), nullptr);
+    }
+
+    testing::NiceMock<MockJsonRpcProxy> proxy;
+    FuseMock fuse;
+    wf_impl_readahead * readahead;
+    std::vector<PendingRead> pending;
+};
+
+fuse_req_t to_request(uintptr_t id)
+{
+    return reinterpret_cast<fuse_req_t>(id);
+}
+
+}
+
+TEST_F(ReadaheadTest, no_prefetch_on_first_read)
+{
+    read(to_request(1), 16, 0);
+    ASSERT_EQ(1, pending.size());
+}
+
+TEST_F(ReadaheadTest, prefetch_on_sequential_read)
+{
+    read(to_request(1), 16, 0);
+    read(to_request(2), 16, 16);
+
+    // direct read and one chunk ahead
+    ASSERT_EQ(3, pending.size());
+}
+
+TEST_F(ReadaheadTest, serve_read_from_prefetched_chunk)
+{
+    read(to_request(1), 16, 0);
+    read(to_request(2), 16, 16);
+    ASSERT_EQ(3, pending.size());
+
+    finish(2, "0123456789abcdef");
+
+    EXPECT_CALL(fuse, fuse_reply_buf(to_request(3), _, 16)).Times(1).WillOnce(Return(0));
+    read(to_request(3), 16, 32);
+
+    // window grows to 2 chunks
+    ASSERT_EQ(5, pending.size());
+}
+
+TEST_F(ReadaheadTest, answer_read_when_pending_chunk_finishes)
+{
+    read(to_request(1), 16, 0);
+    read(to_request(2), 16, 16);
+    read(to_request(3), 16, 32);
+
+    EXPECT_CALL(fuse, fuse_reply_buf(to_request(3), _, 16)).Times(1).WillOnce(Return(0));
+    finish(2, "0123456789abcdef");
+}
+
+TEST_F(ReadaheadTest, short_chunk_stops_prefetch)
+{
+    read(to_request(1), 16, 0);
+    read(to_request(2), 16, 16);
+    finish(2, "0123");
+
+    EXPECT_CALL(fuse, fuse_reply_buf(to_request(3), _, 4)).Times(1).WillOnce(Return(0));
+    read(to_request(3), 16, 32);
+    ASSERT_EQ(3, pending.size());
+}
+
+TEST_F(ReadaheadTest, limit_window_size)
+{
+    read(to_request(1), 16, 0);
+    for (int i = 1; i < 10; i++)
+    {
+        read(to_request(1), 16, i * 16);
+    }
+
+    // 2 direct reads, 8 served chunks and 3 chunks ahead
+    ASSERT_EQ(13, pending.size());
+}
+
+TEST_F(ReadaheadTest, random_access_stops_prefetch)
+{
+    read(to_request(1), 16, 0);
+    read(to_request(2), 16, 16);
+    ASSERT_EQ(3, pending.size());
+
+    read(to_request(3), 16, 1024);
+    ASSERT_EQ(4, pending.size());
+}
+
+TEST_F(ReadaheadTest, fail_read_if_chunk_fails)
+{
+    read(to_request(1), 16, 0);
+    read(to_request(2), 16, 16);
+    read(to_request(3), 16, 32);
+
+    EXPECT_CALL(fuse, fuse_reply_err(to_request(3), ENOENT)).Times(1).WillOnce(Return(0));
+    struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD, "");
+    pending[2].finished(pending[2].user_data, nullptr, error);
+    wf_impl_jsonrpc_error_dispose(error);
+}
+
+TEST_F(ReadaheadTest, release_stream_with_pending_chunk)
+{
+    read(to_request(1), 16, 0);
+    read(to_request(2), 16, 16);
+    wf_impl_readahead_release(readahead, 2, 42);
+
+    EXPECT_CALL(fuse, fuse_reply_buf(_, _, _)).Times(0);
+    finish(2, "0123456789abcdef");
+}
+
+TEST_F(ReadaheadTest, serve_read_from_compressed_chunk)
+{
+    read(to_request(1), 16, 0);
+    read(to_request(2), 16, 16);
+    ASSERT_EQ(3, pending.size());
+
+    std::string const data("0123456789abcdef");
+    uLongf size = compressBound(data.size());
+    std::string compressed(size, '\0');
+    compress(reinterpret_cast<Bytef*>(&compressed[0]), &size, reinterpret_cast<Bytef const*>(data.data()), data.size());
+    std::string encoded(wf_impl_base64_encoded_size(size) + 1, '\0');
+    encoded.resize(wf_impl_base64_encode(reinterpret_cast<uint8_t const*>(compressed.data()), size, &encoded[0], encoded.size()));
+
+    JsonDoc result("{\"data\": \"" + encoded + "\", \"format\": \"deflate+base64\", \"count\": 16}");
+    pending[2].finished(pending[2].user_data, result.root(), nullptr);
+
+    EXPECT_CALL(fuse, fuse_reply_buf(to_request(3), _, 16)).Times(1).WillOnce(Invoke(
+        [&data](fuse_req_t, char const * buffer, size_t size) -> int
+        {
+            EXPECT_EQ(data, std::string(buffer, size));
+            return 0;
+        }));
+    read(to_request(3), 16, 32);
+}
+
+TEST_F(ReadaheadTest, prefetch_after_reads_answered_elsewhere)
+{
+    wf_impl_readahead_advance(readahead, 2, 42, 16, 0);
+    wf_impl_readahead_advance(readahead, 2, 42, 16, 16);
+    ASSERT_EQ(0, pending.size());
+
+    read(to_request(1), 16, 32);
+
+    // direct read and one chunk ahead
+    ASSERT_EQ(2, pending.size());
+}
+
+TEST_F(ReadaheadTest, drop_chunks_on_random_read_answered_elsewhere)
+{
+    read(to_request(1), 16, 0);
+    read(to_request(2), 16, 16);
+    ASSERT_EQ(3, pending.size());
+
+    wf_impl_readahead_advance(readahead, 2, 42, 16, 1024);
+
+    EXPECT_CALL(fuse, fuse_reply_buf(_, _, _)).Times(0);
+    finish(2, "0123456789abcdef");
+
+    read(to_request(3), 16, 32);
+    ASSERT_EQ(4, pending.size());
+}
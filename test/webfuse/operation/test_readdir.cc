@@ -1,5 +1,7 @@
 #include "webfuse/impl/operation/readdir.h"
 #include "webfuse/impl/jsonrpc/error.h"
+#include "webfuse/impl/operation/dir_snapshot.h"
+#include "webfuse/impl/cache/file_versions.h"
 
 #include "webfuse/status.h"
 
@@ -33,12 +35,38 @@ void free_context(
     free(user_data);    
 }
 
+wf_impl_operation_readdir_context * create_context(
+    size_t size,
+    off_t offset,
+    bool plus = false,
+    wf_impl_file_versions * versions = nullptr,
+    wf_impl_dir_snapshot * snapshot = nullptr)
+{
+    auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
+    context->request = nullptr;
+    context->size = size;
+    context->offset = offset;
+    context->plus = plus;
+    context->uid = 0;
+    context->gid = 0;
+    context->attr_timeout = 1.0;
+    context->entry_timeout = 1.0;
+    context->cache = nullptr;
+    context->versions = versions;
+    context->snapshot = snapshot;
+    context->rpc = nullptr;
+    context->name = "test";
+    context->inode = 1;
+    context->page_offset = 0;
+    return context;
+}
+
 }
 
 TEST(wf_impl_operation_readdir, invoke_proxy)
 {
     MockJsonRpcProxy proxy;
-    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("readdir"),StrEq("si")))
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("readdir"),StrEq("sIIi")))
         .Times(1).WillOnce(Invoke(free_context));
 
     MockOperationContext context;
@@ -47,6 +75,10 @@ TEST(wf_impl_operation_readdir, invoke_proxy)
 
     wf_impl_operation_context op_context;
     op_context.name = nullptr;
+    op_context.attr_timeout = 1.0;
+    op_context.entry_timeout = 1.0;
+    op_context.cache = nullptr;
+    op_context.versions = nullptr;
     FuseMock fuse;
     EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
 
@@ -57,6 +89,7 @@ TEST(wf_impl_operation_readdir, invoke_proxy)
     size_t offset = 0;
     fuse_file_info file_info;
     file_info.flags = 0;
+    file_info.fh = 0;
     wf_impl_operation_readdir(request, inode, size, offset, &file_info);
 }
 
@@ -76,6 +109,7 @@ TEST(wf_impl_operation_readdir, fail_rpc_null)
     size_t offset = 0;
     fuse_file_info file_info;
     file_info.flags = 0;
+    file_info.fh = 0;
     wf_impl_operation_readdir(request, inode, size, offset, &file_info);
 }
 
@@ -85,10 +119,7 @@ TEST(wf_impl_operation_readdir, finished)
     EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(1).WillOnce(Return(0));
 
     JsonDoc result("[{\"name\": \"a.file\", \"inode\": 42}]");
-    auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
-    context->request = nullptr;
-    context->size = 1;
-    context->offset = 0;
+    auto * context = create_context(1, 0);
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -106,10 +137,7 @@ TEST(wf_impl_operation_readdir, finished_many_items)
     stream << "]";
 
     JsonDoc result(stream.str());
-    auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
-    context->request = nullptr;
-    context->size = 100;
-    context->offset = 0;
+    auto * context = create_context(100, 0);
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -119,10 +147,7 @@ TEST(wf_impl_operation_readdir, finished_read_after_end)
     EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(1).WillOnce(Return(0));
 
     JsonDoc result("[{\"name\": \"a.file\", \"inode\": 42}]");
-    auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
-    context->request = nullptr;
-    context->size = 10;
-    context->offset = 2;
+    auto * context = create_context(10, 2);
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -134,10 +159,7 @@ TEST(wf_impl_operation_readdir, finished_fail_error)
 
     struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD, "");
 
-    auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
-    context->request = nullptr;
-    context->size = 1;
-    context->offset = 0;
+    auto * context = create_context(1, 0);
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), nullptr, error);
     wf_impl_jsonrpc_error_dispose(error);
 }
@@ -149,10 +171,7 @@ TEST(wf_impl_operation_readdir, finished_fail_invalid_result_type)
     EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
 
     JsonDoc result("{}");
-    auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
-    context->request = nullptr;
-    context->size = 1;
-    context->offset = 0;
+    auto * context = create_context(1, 0);
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -163,10 +182,7 @@ TEST(wf_impl_operation_readdir, finished_fail_missing_name)
     EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
 
     JsonDoc result("[{\"inode\": 42}]");
-    auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
-    context->request = nullptr;
-    context->size = 1;
-    context->offset = 0;
+    auto * context = create_context(1, 0);
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -177,10 +193,7 @@ TEST(wf_impl_operation_readdir, finished_fail_invalid_name_type)
     EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
 
     JsonDoc result("[{\"name\": 42, \"inode\": 42}]");
-    auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
-    context->request = nullptr;
-    context->size = 1;
-    context->offset = 0;
+    auto * context = create_context(1, 0);
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -191,10 +204,7 @@ TEST(wf_impl_operation_readdir, finished_fail_missing_inode)
     EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
 
     JsonDoc result("[{\"name\": \"a.file\"}]");
-    auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
-    context->request = nullptr;
-    context->size = 1;
-    context->offset = 0;
+    auto * context = create_context(1, 0);
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -205,10 +215,7 @@ TEST(wf_impl_operation_readdir, finished_fail_invalid_inode_type)
     EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
 
     JsonDoc result("[{\"name\": \"a.file\", \"inode\": \"42\"}]");
-    auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
-    context->request = nullptr;
-    context->size = 1;
-    context->offset = 0;
+    auto * context = create_context(1, 0);
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
 
@@ -219,9 +226,292 @@ TEST(wf_impl_operation_readdir, finished_fail_invalid_item_type)
     EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
 
     JsonDoc result("[\"item\"]");
-    auto * context = reinterpret_cast<wf_impl_operation_readdir_context*>(malloc(sizeof(wf_impl_operation_readdir_context)));
-    context->request = nullptr;
-    context->size = 1;
-    context->offset = 0;
+    auto * context = create_context(1, 0);
+    wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_readdirplus, invoke_proxy)
+{
+    MockJsonRpcProxy proxy;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("readdir"),StrEq("sIIi")))
+        .Times(1).WillOnce(Invoke(free_context));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.attr_timeout = 1.0;
+    op_context.entry_timeout = 1.0;
+    op_context.cache = nullptr;
+    op_context.versions = nullptr;
+    fuse_ctx fuse_context;
+    fuse_context.uid = 0;
+    fuse_context.gid = 0;
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_ctx(_)).Times(1).WillOnce(Return(&fuse_context));
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+
+    fuse_file_info file_info;
+    file_info.flags = 0;
+    file_info.fh = 0;
+    wf_impl_operation_readdirplus(nullptr, 1, 10, 0, &file_info);
+}
+
+TEST(wf_impl_operation_readdirplus, fail_rpc_null)
+{
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
+        .WillOnce(Return(nullptr));
+
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_ctx(_)).Times(1).WillOnce(Return(nullptr));
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(nullptr));
+    EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
+
+    fuse_file_info file_info;
+    file_info.flags = 0;
+    file_info.fh = 0;
+    wf_impl_operation_readdirplus(nullptr, 1, 10, 0, &file_info);
+}
+
+TEST(wf_impl_operation_readdirplus, finished_with_attributes)
+{
+    size_t const entry_size = fuse_add_direntry_plus(nullptr, nullptr, 0, "a.file", nullptr, 0);
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,entry_size)).Times(1).WillOnce(Return(0));
+
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+    JsonDoc result("[{\"name\": \"a.file\", \"inode\": 42, \"mode\": 420, \"type\": \"file\", "
+        "\"size\": 23, \"mtime\": 1, \"attr_ttl\": 5, \"entry_ttl\": 10}]");
+    auto * context = create_context(4096, 0, true, versions);
+    wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+
+    uint64_t size = 0;
+    ASSERT_TRUE(wf_impl_file_versions_get_size(versions, 42, &size));
+    ASSERT_EQ(23, size);
+    wf_impl_file_versions_dispose(versions);
+}
+
+TEST(wf_impl_operation_readdirplus, finished_without_attributes)
+{
+    size_t const entry_size = fuse_add_direntry_plus(nullptr, nullptr, 0, "a.file", nullptr, 0);
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,2 * entry_size)).Times(1).WillOnce(Return(0));
+
+    wf_impl_file_versions * versions = wf_impl_file_versions_create();
+    JsonDoc result("[{\"name\": \"a.file\", \"inode\": 42}, {\"name\": \"b.file\", \"inode\": 43, \"type\": \"file\"}]");
+    auto * context = create_context(4096, 0, true, versions);
+    wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+
+    ASSERT_EQ(0, wf_impl_file_versions_size(versions));
+    wf_impl_file_versions_dispose(versions);
+}
+
+TEST(wf_impl_operation_readdirplus, finished_fail_error)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(0);
+    EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
+
+    struct wf_jsonrpc_error * error = wf_impl_jsonrpc_error(WF_BAD, "");
+    wf_impl_operation_readdir_finished(reinterpret_cast<void*>(create_context(4096, 0, true)), nullptr, error);
+    wf_impl_jsonrpc_error_dispose(error);
+}
+
+TEST(wf_impl_operation_readdirplus, finished_fail_missing_inode)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(0);
+    EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
+
+    JsonDoc result("[{\"name\": \"a.file\", \"mode\": 420, \"type\": \"file\"}]");
+    wf_impl_operation_readdir_finished(reinterpret_cast<void*>(create_context(4096, 0, true)), result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_readdir, finished_paginated)
+{
+    size_t const entry_size = fuse_add_direntry(nullptr, nullptr, 0, "a.file", nullptr, 0);
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,entry_size)).Times(1).WillOnce(Return(0));
+
+    JsonDoc result("[{\"name\": \"a.file\", \"inode\": 42}, {\"name\": \"b.file\", \"inode\": 43}]");
+    auto * context = create_context(entry_size + 1, 0);
+    wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_readdir, fill_snapshot_of_handle)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(1).WillOnce(Return(0));
+
+    wf_impl_dir_snapshot * snapshot = wf_impl_dir_snapshot_create();
+    JsonDoc result("[{\"name\": \"a.file\", \"inode\": 42}, {\"name\": \"b.file\", \"inode\": 43}]");
+    auto * context = create_context(4096, 0, false, nullptr, snapshot);
+    wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+
+    ASSERT_TRUE(wf_impl_dir_snapshot_contains(snapshot, 2));
+    ASSERT_EQ(2, wf_impl_dir_snapshot_size(snapshot));
+    wf_impl_dir_snapshot_dispose(snapshot);
+}
+
+TEST(wf_impl_operation_readdir, serve_continuation_from_snapshot)
+{
+    wf_impl_dir_snapshot * snapshot = wf_impl_dir_snapshot_create();
+    struct stat attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.st_ino = 42;
+    wf_impl_dir_snapshot_add(snapshot, "a.file", &attr, false, 1.0, 1.0);
+    attr.st_ino = 43;
+    wf_impl_dir_snapshot_add(snapshot, "b.file", &attr, false, 1.0, 1.0);
+    wf_impl_dir_snapshot_set_loaded(snapshot, false, 0);
+
+    size_t const entry_size = fuse_add_direntry(nullptr, nullptr, 0, "b.file", nullptr, 0);
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(0);
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).WillRepeatedly(Return(nullptr));
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,entry_size)).Times(1).WillOnce(Return(0));
+
+    fuse_file_info file_info;
+    file_info.flags = 0;
+    file_info.fh = reinterpret_cast<uint64_t>(snapshot);
+    wf_impl_operation_readdir(nullptr, 1, 4096, 1, &file_info);
+
+    wf_impl_dir_snapshot_dispose(snapshot);
+}
+
+TEST(wf_impl_operation_readdir, refetch_snapshot_on_rewind)
+{
+    wf_impl_dir_snapshot * snapshot = wf_impl_dir_snapshot_create();
+    struct stat attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.st_ino = 42;
+    wf_impl_dir_snapshot_add(snapshot, "a.file", &attr, false, 1.0, 1.0);
+    wf_impl_dir_snapshot_set_loaded(snapshot, false, 0);
+
+    MockJsonRpcProxy proxy;
+    wf_jsonrpc_proxy_finished_fn * finished = nullptr;
+    void * finished_data = nullptr;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("readdir"),StrEq("sIIi")))
+        .Times(1).WillOnce(Invoke([&](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn * fn,
+            void * user_data, char const *, char const *)
+        {
+            finished = fn;
+            finished_data = user_data;
+        }));
+
+    MockOperationContext context;
+    EXPECT_CALL(context, wf_impl_operation_context_get_proxy(_)).Times(1)
+        .WillOnce(Return(reinterpret_cast<wf_jsonrpc_proxy*>(&proxy)));
+
+    wf_impl_operation_context op_context;
+    op_context.name = nullptr;
+    op_context.attr_timeout = 1.0;
+    op_context.entry_timeout = 1.0;
+    op_context.cache = nullptr;
+    op_context.versions = nullptr;
+    size_t const entry_size = fuse_add_direntry(nullptr, nullptr, 0, "b.file", nullptr, 0);
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_req_userdata(_)).Times(1).WillOnce(Return(&op_context));
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,2 * entry_size)).Times(1).WillOnce(Return(0));
+
+    fuse_file_info file_info;
+    file_info.flags = 0;
+    file_info.fh = reinterpret_cast<uint64_t>(snapshot);
+    wf_impl_operation_readdir(nullptr, 1, 4096, 0, &file_info);
+
+    ASSERT_NE(nullptr, finished);
+    JsonDoc result("[{\"name\": \"b.file\", \"inode\": 43}, {\"name\": \"c.file\", \"inode\": 44}]");
+    finished(finished_data, result.root(), nullptr);
+    ASSERT_EQ(2, wf_impl_dir_snapshot_size(snapshot));
+
+    wf_impl_dir_snapshot_dispose(snapshot);
+}
+
+TEST(wf_impl_operation_readdir, finished_paged)
+{
+    size_t const entry_size = fuse_add_direntry(nullptr, nullptr, 0, "a.file", nullptr, 0);
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,2 * entry_size)).Times(1).WillOnce(Return(0));
+
+    wf_impl_dir_snapshot * snapshot = wf_impl_dir_snapshot_create();
+    JsonDoc result("{\"entries\": [{\"name\": \"a.file\", \"inode\": 42}, {\"name\": \"b.file\", \"inode\": 43}], \"next\": 2}");
+    auto * context = create_context(4096, 0, false, nullptr, snapshot);
+    wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+
+    ASSERT_TRUE(wf_impl_dir_snapshot_contains(snapshot, 1));
+    ASSERT_FALSE(wf_impl_dir_snapshot_contains(snapshot, 2));
+    off_t page_offset;
+    int64_t cursor;
+    ASSERT_TRUE(wf_impl_dir_snapshot_get_next(snapshot, &page_offset, &cursor));
+    ASSERT_EQ(2, page_offset);
+    ASSERT_EQ(2, cursor);
+    wf_impl_dir_snapshot_dispose(snapshot);
+}
+
+TEST(wf_impl_operation_readdir, finished_last_page)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(1).WillOnce(Return(0));
+
+    wf_impl_dir_snapshot * snapshot = wf_impl_dir_snapshot_create();
+    JsonDoc result("{\"entries\": [{\"name\": \"c.file\", \"inode\": 44}]}");
+    auto * context = create_context(4096, 2, false, nullptr, snapshot);
+    context->page_offset = 2;
+    wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+
+    ASSERT_TRUE(wf_impl_dir_snapshot_contains(snapshot, 2));
+    ASSERT_TRUE(wf_impl_dir_snapshot_contains(snapshot, 3));
+    ASSERT_FALSE(wf_impl_dir_snapshot_contains(snapshot, 1));
+    wf_impl_dir_snapshot_dispose(snapshot);
+}
+
+TEST(wf_impl_operation_readdir, fetch_next_page_if_offset_is_beyond_page)
+{
+    MockJsonRpcProxy proxy;
+    wf_jsonrpc_proxy_finished_fn * finished = nullptr;
+    void * finished_data = nullptr;
+    EXPECT_CALL(proxy, wf_impl_jsonrpc_proxy_vinvoke(_,_,_,StrEq("readdir"),StrEq("sIIi")))
+        .Times(1).WillOnce(Invoke([&](wf_jsonrpc_proxy *, wf_jsonrpc_proxy_finished_fn * fn,
+            void * user_data, char const *, char const *)
+        {
+            finished = fn;
+            finished_data = user_data;
+        }));
+
+    size_t const entry_size = fuse_add_direntry(nullptr, nullptr, 0, "c.file", nullptr, 0);
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,entry_size)).Times(1).WillOnce(Return(0));
+
+    JsonDoc result("{\"entries\": [{\"name\": \"a.file\", \"inode\": 42}, {\"name\": \"b.file\", \"inode\": 43}], \"next\": 2}");
+    auto * context = create_context(4096, 2);
+    context->rpc = reinterpret_cast<wf_jsonrpc_proxy*>(&proxy);
+    wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+
+    ASSERT_NE(nullptr, finished);
+    JsonDoc next_result("{\"entries\": [{\"name\": \"c.file\", \"inode\": 44}]}");
+    finished(finished_data, next_result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_readdir, empty_page_ends_directory)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,0)).Times(1).WillOnce(Return(0));
+
+    JsonDoc result("{\"entries\": [], \"next\": 2}");
+    auto * context = create_context(4096, 0);
+    wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
+}
+
+TEST(wf_impl_operation_readdir, finished_fail_missing_entries)
+{
+    FuseMock fuse;
+    EXPECT_CALL(fuse, fuse_reply_buf(_,_,_)).Times(0);
+    EXPECT_CALL(fuse, fuse_reply_err(_, ENOENT)).Times(1).WillOnce(Return(0));
+
+    JsonDoc result("{\"next\": 2}");
+    auto * context = create_context(4096, 0);
     wf_impl_operation_readdir_finished(reinterpret_cast<void*>(context), result.root(), nullptr);
 }
@@ -0,0 +1,100 @@
+#include "webfuse/impl/message_pool.h"
+#include "webfuse/impl/message.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+class MessagePoolTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        wf_impl_message_pool_init(&pool);
+    }
+
+    void TearDown() override
+    {
+        wf_impl_message_pool_cleanup(&pool);
+    }
+
+    wf_message_pool pool;
+};
+
+}
+
+TEST_F(MessagePoolTest, get_message_of_size_class)
+{
+    wf_message * message = wf_impl_message_pool_get(&pool, 600);
+    ASSERT_NE(nullptr, message);
+    ASSERT_EQ(0, message->length);
+    ASSERT_EQ(1024, message->capacity);
+    ASSERT_EQ(&pool, message->pool);
+
+    wf_impl_message_dispose(message);
+}
+
+TEST_F(MessagePoolTest, reuse_disposed_message)
+{
+    wf_message * message = wf_impl_message_pool_get(&pool, 100);
+    message->length = 42;
+    wf_impl_message_dispose(message);
+
+    wf_message * other = wf_impl_message_pool_get(&pool, 512);
+    ASSERT_EQ(message, other);
+    ASSERT_EQ(0, other->length);
+
+    wf_impl_message_dispose(other);
+}
+
+TEST_F(MessagePoolTest, do_not_reuse_message_of_other_class)
+{
+    wf_message * message = wf_impl_message_pool_get(&pool, 100);
+    wf_impl_message_dispose(message);
+
+    wf_message * other = wf_impl_message_pool_get(&pool, 2048);
+    ASSERT_EQ(2048, other->capacity);
+    ASSERT_EQ(1, pool.free_count[0]);
+
+    wf_impl_message_dispose(other);
+}
+
+TEST_F(MessagePoolTest, do_not_pool_large_messages)
+{
+    size_t const size = 1024 * 1024;
+    wf_message * message = wf_impl_message_pool_get(&pool, size);
+    ASSERT_EQ(size, message->capacity);
+    wf_impl_message_dispose(message);
+
+    for (size_t i = 0; i < WF_IMPL_MESSAGE_POOL_CLASS_COUNT; i++)
+    {
+        ASSERT_EQ(0, pool.free_count[i]);
+    }
+}
+
+TEST_F(MessagePoolTest, limit_free_messages)
+{
+    wf_message * messages[WF_IMPL_MESSAGE_POOL_MAX_FREE + 1];
+    for (auto & message: messages)
+    {
+        message = wf_impl_message_pool_get(&pool, 100);
+    }
+
+    for (auto message: messages)
+    {
+        wf_impl_message_dispose(message);
+    }
+
+    ASSERT_EQ(WF_IMPL_MESSAGE_POOL_MAX_FREE, pool.free_count[0]);
+}
+
+TEST(wf_message_pool, get_without_pool)
+{
+    wf_message * message = wf_impl_message_pool_get(nullptr, 100);
+    ASSERT_NE(nullptr, message);
+    ASSERT_EQ(nullptr, message->pool);
+    ASSERT_EQ(512, message->capacity);
+
+    wf_impl_message_dispose(message);
+}
@@ -1,6 +1,8 @@
 #include "webfuse/impl/message_queue.h"
 #include "webfuse/impl/message.h"
+#include "webfuse/impl/message_pool.h"
 #include "webfuse/impl/util/slist.h"
+#include "webfuse/mocks/mock_lws.hpp"
 
 #include <gtest/gtest.h>
 
@@ -8,6 +10,11 @@
 #include <cstring>
 #include <cstdlib>
 
+using webfuse_test::LwsMock;
+using testing::_;
+using testing::Return;
+using testing::ReturnArg;
+
 namespace
 {
 
@@ -54,4 +61,150 @@ TEST(wf_message_queue, cleanup_multiple_element)
 
     wf_impl_message_queue_cleanup(&queue);
     ASSERT_TRUE(wf_impl_slist_empty(&queue));
-}
\ No newline at end of file
+}
+TEST(wf_message_queue, take_batch_from_empty_list)
+{
+    struct wf_slist queue;
+    wf_impl_slist_init(&queue);
+
+    ASSERT_EQ(nullptr, wf_impl_message_queue_take_batch(&queue, 1024));
+}
+
+TEST(wf_message_queue, take_batch_single_message)
+{
+    struct wf_slist queue;
+    wf_impl_slist_init(&queue);
+
+    wf_impl_slist_append(&queue, create_message("Hello"));
+
+    struct wf_message * message = wf_impl_message_queue_take_batch(&queue, 1024);
+    ASSERT_EQ("{\"content\": \"Hello\"}", std::string(message->data, message->length));
+    ASSERT_TRUE(wf_impl_slist_empty(&queue));
+
+    wf_impl_message_dispose(message);
+}
+
+TEST(wf_message_queue, take_batch_multiple_messages)
+{
+    struct wf_slist queue;
+    wf_impl_slist_init(&queue);
+
+    wf_impl_slist_append(&queue, create_message("Hello"));
+    wf_impl_slist_append(&queue, create_message("World"));
+
+    struct wf_message * message = wf_impl_message_queue_take_batch(&queue, 1024);
+    ASSERT_EQ("[{\"content\": \"Hello\"},{\"content\": \"World\"}]", std::string(message->data, message->length));
+    ASSERT_TRUE(wf_impl_slist_empty(&queue));
+
+    wf_impl_message_dispose(message);
+}
+
+TEST(wf_message_queue, take_batch_from_pool)
+{
+    struct wf_message_pool pool;
+    wf_impl_message_pool_init(&pool);
+
+    struct wf_slist queue;
+    wf_impl_slist_init(&queue);
+
+    struct wf_message * first = wf_impl_message_pool_get(&pool, 10);
+    memcpy(first->data, "42", 2);
+    first->length = 2;
+    wf_impl_slist_append(&queue, &first->item);
+    wf_impl_slist_append(&queue, create_message("Hello"));
+
+    struct wf_message * message = wf_impl_message_queue_take_batch(&queue, 1024);
+    ASSERT_EQ("[42,{\"content\": \"Hello\"}]", std::string(message->data, message->length));
+    ASSERT_EQ(&pool, message->pool);
+
+    wf_impl_message_dispose(message);
+    wf_impl_message_pool_cleanup(&pool);
+}
+
+TEST(wf_message_queue, take_batch_limits_size)
+{
+    struct wf_slist queue;
+    wf_impl_slist_init(&queue);
+
+    wf_impl_slist_append(&queue, create_message("Hello"));
+    wf_impl_slist_append(&queue, create_message("World"));
+    wf_impl_slist_append(&queue, create_message("!"));
+
+    struct wf_message * message = wf_impl_message_queue_take_batch(&queue, 45);
+    ASSERT_EQ("[{\"content\": \"Hello\"},{\"content\": \"World\"}]", std::string(message->data, message->length));
+    ASSERT_FALSE(wf_impl_slist_empty(&queue));
+    wf_impl_message_dispose(message);
+
+    message = wf_impl_message_queue_take_batch(&queue, 45);
+    ASSERT_EQ("{\"content\": \"!\"}", std::string(message->data, message->length));
+    ASSERT_TRUE(wf_impl_slist_empty(&queue));
+    wf_impl_message_dispose(message);
+}
+
+TEST(wf_message_queue, write_all_messages)
+{
+    struct wf_slist queue;
+    wf_impl_slist_init(&queue);
+    wf_impl_slist_append(&queue, create_message("Hello"));
+    wf_impl_slist_append(&queue, create_message("World"));
+    wf_impl_slist_append(&queue, create_message("!"));
+
+    LwsMock lws;
+    EXPECT_CALL(lws, lws_send_pipe_choked(_)).WillRepeatedly(Return(0));
+    EXPECT_CALL(lws, lws_write(_,_,_,LWS_WRITE_TEXT)).Times(3).WillRepeatedly(ReturnArg<2>());
+    EXPECT_CALL(lws, lws_callback_on_writable(_)).Times(0);
+
+    wf_impl_message_queue_write(&queue, nullptr, 0, 1024);
+    ASSERT_TRUE(wf_impl_slist_empty(&queue));
+}
+
+TEST(wf_message_queue, write_batch)
+{
+    struct wf_slist queue;
+    wf_impl_slist_init(&queue);
+    wf_impl_slist_append(&queue, create_message("Hello"));
+    wf_impl_slist_append(&queue, create_message("World"));
+
+    LwsMock lws;
+    EXPECT_CALL(lws, lws_send_pipe_choked(_)).WillRepeatedly(Return(0));
+    EXPECT_CALL(lws, lws_write(_,_,43,LWS_WRITE_TEXT)).Times(1).WillOnce(ReturnArg<2>());
+    EXPECT_CALL(lws, lws_callback_on_writable(_)).Times(0);
+
+    wf_impl_message_queue_write(&queue, nullptr, 1024, 1024);
+    ASSERT_TRUE(wf_impl_slist_empty(&queue));
+}
+
+TEST(wf_message_queue, write_stops_when_budget_is_exhausted)
+{
+    struct wf_slist queue;
+    wf_impl_slist_init(&queue);
+    wf_impl_slist_append(&queue, create_message("Hello"));
+    wf_impl_slist_append(&queue, create_message("World"));
+    wf_impl_slist_append(&queue, create_message("!"));
+
+    LwsMock lws;
+    EXPECT_CALL(lws, lws_send_pipe_choked(_)).WillRepeatedly(Return(0));
+    EXPECT_CALL(lws, lws_write(_,_,_,LWS_WRITE_TEXT)).Times(2).WillRepeatedly(ReturnArg<2>());
+    EXPECT_CALL(lws, lws_callback_on_writable(_)).Times(1).WillOnce(Return(0));
+
+    wf_impl_message_queue_write(&queue, nullptr, 0, 30);
+    ASSERT_FALSE(wf_impl_slist_empty(&queue));
+    wf_impl_message_queue_cleanup(&queue);
+}
+
+TEST(wf_message_queue, write_stops_when_choked)
+{
+    struct wf_slist queue;
+    wf_impl_slist_init(&queue);
+    wf_impl_slist_append(&queue, create_message("Hello"));
+    wf_impl_slist_append(&queue, create_message("World"));
+
+    LwsMock lws;
+    EXPECT_CALL(lws, lws_send_pipe_choked(_)).WillOnce(Return(0)).WillOnce(Return(1));
+    EXPECT_CALL(lws, lws_write(_,_,_,LWS_WRITE_TEXT)).Times(1).WillOnce(ReturnArg<2>());
+    EXPECT_CALL(lws, lws_callback_on_writable(_)).Times(1).WillOnce(Return(0));
+
+    wf_impl_message_queue_write(&queue, nullptr, 0, 1024);
+    ASSERT_FALSE(wf_impl_slist_empty(&queue));
+    wf_impl_message_queue_cleanup(&queue);
+}
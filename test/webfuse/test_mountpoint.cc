@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "webfuse/mountpoint.h"
+#include "webfuse/impl/mountpoint.h"
+#include "webfuse/impl/mountpoint_factory.h"
 
 namespace
 {
@@ -16,6 +18,20 @@ namespace
     {
         global_disposer->dispose(user_data);
     }
+
+    wf_mountpoint * create_mountpoint(
+        char const *,
+        void * user_data)
+    {
+        wf_mountpoint * mountpoint = wf_mountpoint_create("/some/path");
+        size_t const * cache_size = reinterpret_cast<size_t const *>(user_data);
+        if (nullptr != cache_size)
+        {
+            wf_mountpoint_set_cache_size(mountpoint, *cache_size);
+        }
+
+        return mountpoint;
+    }
 }
 
 TEST(mountpoint, get_path)
@@ -44,4 +60,76 @@ TEST(mountpoint, ondispose)
     EXPECT_CALL(disposer, dispose(user_data)).Times(1);
 
     wf_mountpoint_dispose(mountpoint);
-}
\ No newline at end of file
+}
+
+TEST(mountpoint, set_direct_io_threshold)
+{
+    wf_mountpoint * mountpoint = wf_mountpoint_create("/some/path");
+    ASSERT_NE(nullptr, mountpoint);
+
+    ASSERT_EQ(0, wf_impl_mountpoint_get_direct_io_threshold(mountpoint));
+
+    wf_mountpoint_set_direct_io_threshold(mountpoint, 100 * 1024 * 1024);
+    ASSERT_EQ(100 * 1024 * 1024, wf_impl_mountpoint_get_direct_io_threshold(mountpoint));
+
+    wf_mountpoint_dispose(mountpoint);
+}
+
+TEST(mountpoint, set_readahead)
+{
+    wf_mountpoint * mountpoint = wf_mountpoint_create("/some/path");
+    ASSERT_NE(nullptr, mountpoint);
+
+    ASSERT_EQ(0, wf_impl_mountpoint_get_readahead(mountpoint));
+
+    wf_mountpoint_set_readahead(mountpoint, 1024 * 1024);
+    ASSERT_EQ(1024 * 1024, wf_impl_mountpoint_get_readahead(mountpoint));
+
+    wf_mountpoint_dispose(mountpoint);
+}
+
+TEST(mountpoint, inherit_cache_size_if_not_set)
+{
+    wf_impl_mountpoint_factory factory;
+    wf_impl_mountpoint_factory_init(&factory, &create_mountpoint, nullptr);
+    wf_impl_mountpoint_factory_set_cache_size(&factory, 1024 * 1024);
+
+    wf_mountpoint * mountpoint = wf_impl_mountpoint_factory_create_mountpoint(&factory, "test");
+    ASSERT_EQ(1024 * 1024, wf_impl_mountpoint_get_cache_size(mountpoint));
+
+    wf_mountpoint_dispose(mountpoint);
+    wf_impl_mountpoint_factory_cleanup(&factory);
+}
+
+TEST(mountpoint, keep_explicitly_disabled_cache)
+{
+    size_t cache_size = 0;
+    wf_impl_mountpoint_factory factory;
+    wf_impl_mountpoint_factory_init(&factory, &create_mountpoint, &cache_size);
+    wf_impl_mountpoint_factory_set_cache_size(&factory, 1024 * 1024);
+
+    wf_mountpoint * mountpoint = wf_impl_mountpoint_factory_create_mountpoint(&factory, "test");
+    ASSERT_EQ(0, wf_impl_mountpoint_get_cache_size(mountpoint));
+
+    wf_mountpoint_dispose(mountpoint);
+    wf_impl_mountpoint_factory_cleanup(&factory);
+}
+
+TEST(mountpoint, set_timeouts)
+{
+    wf_mountpoint * mountpoint = wf_mountpoint_create("/some/path");
+    ASSERT_NE(nullptr, mountpoint);
+
+    ASSERT_EQ(1.0, wf_impl_mountpoint_get_attr_timeout(mountpoint));
+    ASSERT_EQ(1.0, wf_impl_mountpoint_get_entry_timeout(mountpoint));
+    ASSERT_EQ(0.0, wf_impl_mountpoint_get_negative_timeout(mountpoint));
+
+    wf_mountpoint_set_attr_timeout(mountpoint, 60.0);
+    wf_mountpoint_set_entry_timeout(mountpoint, 120.0);
+    wf_mountpoint_set_negative_timeout(mountpoint, 5.0);
+    ASSERT_EQ(60.0, wf_impl_mountpoint_get_attr_timeout(mountpoint));
+    ASSERT_EQ(120.0, wf_impl_mountpoint_get_entry_timeout(mountpoint));
+    ASSERT_EQ(5.0, wf_impl_mountpoint_get_negative_timeout(mountpoint));
+
+    wf_mountpoint_dispose(mountpoint);
+}
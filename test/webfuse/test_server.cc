@@ -103,6 +103,35 @@ TEST(server, add_filesystem)
     ASSERT_TRUE(disconnected);
 }
 
+TEST(server, add_filesystem_via_batch)
+{
+    Server server;
+    MockInvokationHander handler;
+    EXPECT_CALL(handler, Invoke(StrEq("lookup"), _)).Times(AnyNumber());
+    EXPECT_CALL(handler, Invoke(StrEq("getattr"), GetAttr(1))).Times(AnyNumber())
+        .WillOnce(Return("{\"mode\": 420, \"type\": \"dir\"}"));
+    WsClient client(handler, WF_PROTOCOL_NAME_PROVIDER_CLIENT);
+
+    auto connected = client.Connect(server.GetPort(), WF_PROTOCOL_NAME_ADAPTER_SERVER);
+    ASSERT_TRUE(connected);
+
+    std::string response_text = client.Invoke("[{\"method\": \"add_filesystem\", \"params\": [\"test\"], \"id\": 42}]");
+    JsonDoc doc(response_text);
+    wf_json const * response = doc.root();
+    ASSERT_TRUE(wf_impl_json_is_object(response));
+    wf_json const * result = wf_impl_json_object_get(response, "result");
+    ASSERT_TRUE(wf_impl_json_is_object(result));
+    wf_json const * id = wf_impl_json_object_get(response, "id");
+    ASSERT_EQ(42, wf_impl_json_int_get(id));
+
+    std::string base_dir = server.GetBaseDir();
+    File file(base_dir + "/test");
+    ASSERT_TRUE(file.isDirectory());
+
+    auto disconnected = client.Disconnect();
+    ASSERT_TRUE(disconnected);
+}
+
 TEST(server, add_filesystem_fail_missing_param)
 {
     Server server;
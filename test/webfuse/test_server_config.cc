@@ -120,6 +120,45 @@ TEST(server_config, set_port)
     wf_server_config_dispose(config);
 }
 
+TEST(server_config, set_cache_size)
+{
+    wf_server_config * config = wf_server_config_create();
+    ASSERT_NE(nullptr, config);
+
+    ASSERT_EQ(0, config->cache_size);
+
+    wf_server_config_set_cache_size(config, 1024 * 1024);
+    ASSERT_EQ(1024 * 1024, config->cache_size);
+
+    wf_server_config_dispose(config);
+}
+
+TEST(server_config, set_write_budget)
+{
+    wf_server_config * config = wf_server_config_create();
+    ASSERT_NE(nullptr, config);
+
+    ASSERT_EQ(0, config->write_budget);
+
+    wf_server_config_set_write_budget(config, 4096);
+    ASSERT_EQ(4096, config->write_budget);
+
+    wf_server_config_dispose(config);
+}
+
+TEST(server_config, set_request_window)
+{
+    wf_server_config * config = wf_server_config_create();
+    ASSERT_NE(nullptr, config);
+
+    ASSERT_EQ(0, config->request_window);
+
+    wf_server_config_set_request_window(config, 16);
+    ASSERT_EQ(16, config->request_window);
+
+    wf_server_config_dispose(config);
+}
+
 TEST(server_config, set_mounpoint_factory)
 {
     wf_server_config * config = wf_server_config_create();
@@ -0,0 +1,86 @@
+#include "webfuse/impl/session_manager.h"
+#include "webfuse/impl/timer/manager.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+class SessionManagerTest: public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        timer_manager = wf_impl_timer_manager_create();
+        wf_impl_session_manager_init(&manager);
+    }
+
+    void TearDown() override
+    {
+        wf_impl_session_manager_cleanup(&manager);
+        wf_impl_timer_manager_dispose(timer_manager);
+    }
+
+    wf_impl_session * add(lws * wsi)
+    {
+        return wf_impl_session_manager_add(&manager, wsi, nullptr, nullptr, timer_manager, nullptr);
+    }
+
+    wf_timer_manager * timer_manager;
+    wf_impl_session_manager manager;
+};
+
+lws * to_wsi(uintptr_t id)
+{
+    return reinterpret_cast<lws*>(id);
+}
+
+}
+
+TEST_F(SessionManagerTest, get_session_by_wsi)
+{
+    wf_impl_session * first = add(to_wsi(1));
+    wf_impl_session * second = add(to_wsi(2));
+
+    ASSERT_EQ(first, wf_impl_session_manager_get(&manager, to_wsi(1)));
+    ASSERT_EQ(second, wf_impl_session_manager_get(&manager, to_wsi(2)));
+    ASSERT_EQ(nullptr, wf_impl_session_manager_get(&manager, to_wsi(3)));
+    ASSERT_EQ(nullptr, wf_impl_session_manager_get(&manager, nullptr));
+}
+
+TEST_F(SessionManagerTest, session_wsi_is_no_filesystem)
+{
+    add(to_wsi(1));
+
+    ASSERT_EQ(nullptr, wf_impl_session_manager_get_filesystem(&manager, to_wsi(1)));
+}
+
+TEST_F(SessionManagerTest, remove_session)
+{
+    add(to_wsi(1));
+    wf_impl_session * second = add(to_wsi(2));
+
+    wf_impl_session_manager_remove(&manager, to_wsi(1));
+    ASSERT_EQ(nullptr, wf_impl_session_manager_get(&manager, to_wsi(1)));
+    ASSERT_EQ(second, wf_impl_session_manager_get(&manager, to_wsi(2)));
+
+    // unknown wsi is ignored
+    wf_impl_session_manager_remove(&manager, to_wsi(1));
+    ASSERT_EQ(second, wf_impl_session_manager_get(&manager, to_wsi(2)));
+}
+
+TEST_F(SessionManagerTest, get_many_sessions)
+{
+    size_t const count = 500;
+    for(size_t i = 1; i <= count; i++)
+    {
+        add(to_wsi(i * 64));
+    }
+
+    for(size_t i = 1; i <= count; i++)
+    {
+        wf_impl_session * session = wf_impl_session_manager_get(&manager, to_wsi(i * 64));
+        ASSERT_NE(nullptr, session);
+        ASSERT_EQ(to_wsi(i * 64), session->wsi);
+    }
+}
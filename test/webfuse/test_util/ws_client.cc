@@ -228,33 +228,48 @@ public:
             lock.unlock();
 
             JsonDoc doc(std::string(data, length));
-            wf_json const * request = doc.root();
-            wf_json const * method = wf_impl_json_object_get(request, "method");
-            wf_json const * params = wf_impl_json_object_get(request, "params");
-            wf_json const * id = wf_impl_json_object_get(request, "id");
-
-            std::ostringstream response;
-            response << "{";
-            try
+            wf_json const * message = doc.root();
+            if (wf_impl_json_is_array(message))
             {
-                std::string result_text = handler_.Invoke(wf_impl_json_string_get(method), params);
-                if (result_text.empty()) { throw std::runtime_error("empty"); }
-                response << "\"result\": " << result_text;                    
+                size_t const count = wf_impl_json_array_size(message);
+                for(size_t i = 0; i < count; i++)
+                {
+                    OnRequest(wf_impl_json_array_get(message, i));
+                }
             }
-            catch (...)
+            else
             {
-                response << "\"error\": {\"code\": 1}";
+                OnRequest(message);
             }
 
-            response << ", \"id\": " << wf_impl_json_int_get(id) << "}";
+            lws_cancel_service(context);
+        }
+    }
 
-            lock.lock();
-            send_queue.push(response.str());
-            commands.push(command::send);
-            lock.unlock();
+    void OnRequest(wf_json const * request)
+    {
+        wf_json const * method = wf_impl_json_object_get(request, "method");
+        wf_json const * params = wf_impl_json_object_get(request, "params");
+        wf_json const * id = wf_impl_json_object_get(request, "id");
 
-            lws_cancel_service(context);
+        std::ostringstream response;
+        response << "{";
+        try
+        {
+            std::string result_text = handler_.Invoke(wf_impl_json_string_get(method), params);
+            if (result_text.empty()) { throw std::runtime_error("empty"); }
+            response << "\"result\": " << result_text;                    
         }
+        catch (...)
+        {
+            response << "\"error\": {\"code\": 1}";
+        }
+
+        response << ", \"id\": " << wf_impl_json_int_get(id) << "}";
+
+        std::unique_lock<std::mutex> lock(mutex);
+        send_queue.push(response.str());
+        commands.push(command::send);
     }
 
     int OnWritable(lws * wsi)
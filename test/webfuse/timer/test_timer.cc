@@ -6,9 +6,21 @@
 
 #include "webfuse/impl/timer/timer.h"
 #include "webfuse/impl/timer/manager.h"
+#include "webfuse/mocks/mock_lws.hpp"
+
+#include <vector>
 
 using std::size_t;
 using namespace std::chrono_literals;
+using webfuse_test::LwsMock;
+using webfuse_test::lws_sul_cb_fn;
+using testing::_;
+using testing::Eq;
+using testing::Ge;
+using testing::Le;
+using testing::AllOf;
+using testing::SaveArg;
+using testing::DoAll;
 
 extern "C"
 {
@@ -19,6 +31,12 @@ extern "C"
         bool * triggered = reinterpret_cast<bool*>(user_data);
         *triggered = true;
     }
+
+    void on_timeout_record(struct wf_timer * timer, void * user_data)
+    {
+        auto * order = reinterpret_cast<std::vector<wf_timer*>*>(user_data);
+        order->push_back(timer);
+    }
 }
 
 TEST(wf_timer, init)
@@ -146,3 +164,84 @@ TEST(wf_timer, dont_trigger_null_callback)
     wf_impl_timer_dispose(timer);
     wf_impl_timer_manager_dispose(manager);
 }
+
+TEST(wf_timer, trigger_in_order_of_timeout)
+{
+    static size_t const count = 8;
+    static int const timeouts[count] = { 5, -3, 2, -1, 7, -4, 0, -2 };
+    struct wf_timer_manager * manager = wf_impl_timer_manager_create();
+    struct wf_timer * timer[count];
+    std::vector<wf_timer*> order;
+
+    for(size_t i = 0; i < count; i++)
+    {
+        timer[i] = wf_impl_timer_create(manager, &on_timeout_record, reinterpret_cast<void*>(&order));
+        wf_impl_timer_start(timer[i], timeouts[i] - 10);
+    }
+
+    wf_impl_timer_cancel(timer[3]);
+    wf_impl_timer_manager_check(manager);
+
+    std::vector<wf_timer*> const expected = { timer[5], timer[1], timer[7], timer[6], timer[2], timer[0], timer[4] };
+    ASSERT_EQ(expected, order);
+
+    for(size_t i = 0; i < count; i++)
+    {
+        wf_impl_timer_dispose(timer[i]);
+    }
+    wf_impl_timer_manager_dispose(manager);
+}
+
+TEST(wf_timer, restart_armed_timer)
+{
+    bool triggered = false;
+    struct wf_timer_manager * manager = wf_impl_timer_manager_create();
+    struct wf_timer * timer = wf_impl_timer_create(manager, &on_timeout, reinterpret_cast<void*>(&triggered));
+
+    wf_impl_timer_start(timer, -1);
+    wf_impl_timer_start(timer, (5 * 60 * 1000));
+    wf_impl_timer_manager_check(manager);
+    ASSERT_FALSE(triggered);
+
+    wf_impl_timer_cancel(timer);
+    wf_impl_timer_manager_dispose(manager);
+    ASSERT_FALSE(triggered);
+
+    wf_impl_timer_dispose(timer);
+}
+
+TEST(wf_timer, schedule_next_timeout_with_lws)
+{
+    LwsMock lws;
+    lws_context * context = reinterpret_cast<lws_context*>(42);
+    lws_sorted_usec_list_t * sul = nullptr;
+    lws_sul_cb_fn * callback = nullptr;
+
+    bool triggered = false;
+    struct wf_timer_manager * manager = wf_impl_timer_manager_create();
+    struct wf_timer * timer = wf_impl_timer_create(manager, &on_timeout, reinterpret_cast<void*>(&triggered));
+    struct wf_timer * later = wf_impl_timer_create(manager, &on_timeout, reinterpret_cast<void*>(&triggered));
+
+    EXPECT_CALL(lws, lws_sul_schedule(_,_,_,_,_)).Times(0);
+    wf_impl_timer_manager_set_context(manager, context);
+
+    EXPECT_CALL(lws, lws_sul_schedule(context, 0, _, _, AllOf(Ge(1000), Le(1000 * 1000))))
+        .Times(1).WillOnce(DoAll(SaveArg<2>(&sul), SaveArg<3>(&callback)));
+    wf_impl_timer_start(timer, 0);
+
+    // later timers do not change the schedule
+    wf_impl_timer_start(later, (5 * 60 * 1000));
+
+    EXPECT_CALL(lws, lws_sul_schedule(context, 0, _, _, Ge(1000))).Times(1);
+    std::this_thread::sleep_for(10ms);
+    ASSERT_NE(nullptr, callback);
+    callback(sul);
+    ASSERT_TRUE(triggered);
+
+    EXPECT_CALL(lws, lws_sul_schedule(context, 0, _, _, Eq(LWS_SET_TIMER_USEC_CANCEL))).Times(1);
+    wf_impl_timer_cancel(later);
+    wf_impl_timer_manager_dispose(manager);
+
+    wf_impl_timer_dispose(timer);
+    wf_impl_timer_dispose(later);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "webfuse/impl/util/arena.h"
+
+#include <cstdint>
+#include <cstring>
+
+TEST(wf_arena, init)
+{
+    struct wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
+
+    ASSERT_EQ(0, wf_impl_arena_capacity(&arena));
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, alloc_aligned)
+{
+    struct wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
+
+    char * first = reinterpret_cast<char*>(wf_impl_arena_alloc(&arena, 3));
+    char * second = reinterpret_cast<char*>(wf_impl_arena_alloc(&arena, 5));
+    ASSERT_NE(first, second);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(first) % 16);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(second) % 16);
+    ASSERT_EQ(64, wf_impl_arena_capacity(&arena));
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, add_block_if_full)
+{
+    struct wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
+
+    char * first = reinterpret_cast<char*>(wf_impl_arena_alloc(&arena, 48));
+    memset(first, 'a', 48);
+    char * second = reinterpret_cast<char*>(wf_impl_arena_alloc(&arena, 48));
+    memset(second, 'b', 48);
+
+    ASSERT_EQ(64 + 128, wf_impl_arena_capacity(&arena));
+    ASSERT_EQ('a', first[47]);
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, realloc_last_in_place)
+{
+    struct wf_arena arena;
+    wf_impl_arena_init(&arena, 256);
+
+    char * data = reinterpret_cast<char*>(wf_impl_arena_alloc(&arena, 16));
+    strcpy(data, "data");
+    char * grown = reinterpret_cast<char*>(wf_impl_arena_realloc(&arena, data, 16, 64));
+    ASSERT_EQ(data, grown);
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, realloc_copies_if_not_last)
+{
+    struct wf_arena arena;
+    wf_impl_arena_init(&arena, 256);
+
+    char * data = reinterpret_cast<char*>(wf_impl_arena_alloc(&arena, 16));
+    strcpy(data, "data");
+    wf_impl_arena_alloc(&arena, 16);
+
+    char * grown = reinterpret_cast<char*>(wf_impl_arena_realloc(&arena, data, 16, 64));
+    ASSERT_NE(data, grown);
+    ASSERT_STREQ("data", grown);
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, reset_reuses_memory)
+{
+    struct wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
+
+    void * first = wf_impl_arena_alloc(&arena, 32);
+    wf_impl_arena_reset(&arena);
+    void * second = wf_impl_arena_alloc(&arena, 32);
+
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(64, wf_impl_arena_capacity(&arena));
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, reset_coalesces_to_high_water_mark)
+{
+    struct wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
+
+    for(int i = 0; i < 10; i++)
+    {
+        wf_impl_arena_alloc(&arena, 48);
+    }
+    ASSERT_LT(480, wf_impl_arena_capacity(&arena));
+
+    wf_impl_arena_reset(&arena);
+    ASSERT_EQ(480, wf_impl_arena_capacity(&arena));
+
+    // steady state needs a single block
+    for(int i = 0; i < 10; i++)
+    {
+        wf_impl_arena_alloc(&arena, 48);
+    }
+    ASSERT_EQ(480, wf_impl_arena_capacity(&arena));
+
+    wf_impl_arena_cleanup(&arena);
+}
+
+TEST(wf_arena, reset_shrinks_after_large_allocation)
+{
+    struct wf_arena arena;
+    wf_impl_arena_init(&arena, 64);
+
+    wf_impl_arena_alloc(&arena, 32);
+    wf_impl_arena_alloc(&arena, 64 * 1024);
+    wf_impl_arena_reset(&arena);
+    ASSERT_LE(64 * 1024, wf_impl_arena_capacity(&arena));
+
+    for(int i = 0; i < 20; i++)
+    {
+        wf_impl_arena_alloc(&arena, 32);
+        wf_impl_arena_reset(&arena);
+    }
+    ASSERT_EQ(64, wf_impl_arena_capacity(&arena));
+
+    wf_impl_arena_cleanup(&arena);
+}
@@ -142,3 +142,98 @@ TEST(Base64, FailToDecodeInvalid)
     size_t length = wf_impl_base64_decode(in.c_str(), in.size(), (uint8_t*) buffer, 42);
     ASSERT_EQ(0, length);
 }
+
+namespace
+{
+
+std::string encode(std::string const & data)
+{
+    std::string result(wf_impl_base64_encoded_size(data.size()) + 1, '\0');
+    size_t length = wf_impl_base64_encode((uint8_t const*) data.data(), data.size(), &result[0], result.size());
+    result.resize(length);
+
+    return result;
+}
+
+std::string create_data(size_t size)
+{
+    std::string data(size, '\0');
+    for (size_t i = 0; i < size; i++)
+    {
+        data[i] = (char) ((i * 7) + (i >> 8));
+    }
+
+    return data;
+}
+
+class Base64Variant: public ::testing::TestWithParam<wf_impl_base64_variant>
+{
+protected:
+    void SetUp() override
+    {
+        if (!wf_impl_base64_variant_supported(GetParam()))
+        {
+            GTEST_SKIP();
+        }
+    }
+};
+
+}
+
+TEST_P(Base64Variant, Decode)
+{
+    for (size_t size = 1; size < 300; size++)
+    {
+        std::string const data = create_data(size);
+        std::string const encoded = encode(data);
+
+        std::string buffer(size, '\0');
+        size_t length = wf_impl_base64_decode_variant(GetParam(), encoded.data(), encoded.size(), (uint8_t*) &buffer[0], buffer.size());
+        ASSERT_EQ(size, length);
+        ASSERT_EQ(data, buffer);
+    }
+}
+
+TEST_P(Base64Variant, DecodeInPlace)
+{
+    std::string const data = create_data(1000);
+    std::string buffer = encode(data);
+
+    size_t length = wf_impl_base64_decode_variant(GetParam(), buffer.data(), buffer.size(), (uint8_t*) &buffer[0], buffer.size());
+    ASSERT_EQ(data.size(), length);
+    ASSERT_EQ(data, buffer.substr(0, length));
+}
+
+TEST_P(Base64Variant, FailToDecodeInvalid)
+{
+    std::string const encoded = encode(create_data(150));
+    std::string buffer(150, '\0');
+
+    for (size_t pos = 0; pos < encoded.size() - 2; pos++)
+    {
+        for (char c: {'=', '?', '\x80', '\0'})
+        {
+            std::string invalid = encoded;
+            invalid[pos] = c;
+
+            size_t length = wf_impl_base64_decode_variant(GetParam(), invalid.data(), invalid.size(), (uint8_t*) &buffer[0], buffer.size());
+            ASSERT_EQ(0, length) << "pos=" << pos;
+            ASSERT_FALSE(wf_impl_base64_isvalid_variant(GetParam(), invalid.data(), invalid.size())) << "pos=" << pos;
+        }
+    }
+}
+
+TEST_P(Base64Variant, IsValid)
+{
+    for (size_t size = 1; size < 300; size++)
+    {
+        std::string const encoded = encode(create_data(size));
+        ASSERT_TRUE(wf_impl_base64_isvalid_variant(GetParam(), encoded.data(), encoded.size()));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Base64, Base64Variant, ::testing::Values(
+    WF_IMPL_BASE64_SCALAR,
+    WF_IMPL_BASE64_SSSE3,
+    WF_IMPL_BASE64_AVX2,
+    WF_IMPL_BASE64_NEON));
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include "webfuse/impl/util/cpu.h"
+
+namespace
+{
+    int supported_calls = 0;
+
+    bool is_odd(int variant)
+    {
+        supported_calls++;
+        return (1 == (variant % 2));
+    }
+
+    bool is_none(int)
+    {
+        return false;
+    }
+}
+
+TEST(wf_cpu, baseline_is_supported)
+{
+    ASSERT_TRUE(wf_impl_cpu_supports(WF_IMPL_CPU_BASELINE));
+}
+
+TEST(wf_cpu, select_first_supported_variant)
+{
+    int const candidates[] = {4, 3, 1};
+    int selected = -1;
+
+    supported_calls = 0;
+    ASSERT_EQ(3, wf_impl_cpu_select_variant(&selected, candidates, 3, &is_odd, 0));
+    ASSERT_EQ(3, selected);
+    ASSERT_EQ(2, supported_calls);
+
+    // selection is done once
+    ASSERT_EQ(3, wf_impl_cpu_select_variant(&selected, candidates, 3, &is_odd, 0));
+    ASSERT_EQ(2, supported_calls);
+}
+
+TEST(wf_cpu, select_fallback_if_no_variant_is_supported)
+{
+    int const candidates[] = {4, 3, 1};
+    int selected = -1;
+
+    ASSERT_EQ(0, wf_impl_cpu_select_variant(&selected, candidates, 3, &is_none, 0));
+}
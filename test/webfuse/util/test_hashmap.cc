@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "webfuse/impl/util/hashmap.h"
+
+TEST(wf_hashmap, init)
+{
+    struct wf_hashmap map;
+    wf_impl_hashmap_init(&map);
+
+    ASSERT_EQ(0, map.size);
+    ASSERT_EQ(nullptr, wf_impl_hashmap_get(&map, 42));
+    ASSERT_EQ(nullptr, wf_impl_hashmap_remove(&map, 42));
+
+    wf_impl_hashmap_cleanup(&map);
+}
+
+TEST(wf_hashmap, add_and_get)
+{
+    struct wf_hashmap map;
+    struct wf_hashmap_item item[2];
+    wf_impl_hashmap_init(&map);
+
+    wf_impl_hashmap_add(&map, &item[0], 42);
+    wf_impl_hashmap_add(&map, &item[1], 23);
+    ASSERT_EQ(2, map.size);
+
+    ASSERT_EQ(&item[0], wf_impl_hashmap_get(&map, 42));
+    ASSERT_EQ(&item[1], wf_impl_hashmap_get(&map, 23));
+    ASSERT_EQ(nullptr, wf_impl_hashmap_get(&map, 1));
+
+    wf_impl_hashmap_cleanup(&map);
+}
+
+TEST(wf_hashmap, remove)
+{
+    struct wf_hashmap map;
+    struct wf_hashmap_item item[2];
+    wf_impl_hashmap_init(&map);
+
+    wf_impl_hashmap_add(&map, &item[0], 42);
+    wf_impl_hashmap_add(&map, &item[1], 23);
+
+    ASSERT_EQ(&item[0], wf_impl_hashmap_remove(&map, 42));
+    ASSERT_EQ(1, map.size);
+    ASSERT_EQ(nullptr, wf_impl_hashmap_get(&map, 42));
+    ASSERT_EQ(&item[1], wf_impl_hashmap_get(&map, 23));
+    ASSERT_EQ(nullptr, wf_impl_hashmap_remove(&map, 42));
+
+    wf_impl_hashmap_cleanup(&map);
+}
+
+TEST(wf_hashmap, grow)
+{
+    struct wf_hashmap map;
+    struct wf_hashmap_item item[1000];
+    wf_impl_hashmap_init(&map);
+
+    for (uint64_t i = 0; i < 1000; i++)
+    {
+        wf_impl_hashmap_add(&map, &item[i], i);
+    }
+    ASSERT_EQ(1000, map.size);
+
+    for (uint64_t i = 0; i < 1000; i++)
+    {
+        ASSERT_EQ(&item[i], wf_impl_hashmap_get(&map, i));
+    }
+
+    wf_impl_hashmap_cleanup(&map);
+}
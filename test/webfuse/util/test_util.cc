@@ -38,4 +38,19 @@ TEST(jsonrpc_util, failed_to_get_invalid_value_type)
     JsonDoc doc("{\"key\": \"42\"}");
     int value = wf_impl_json_get_int(doc.root(), "key", 42);
     ASSERT_EQ(42, value);
-}
\ No newline at end of file
+}
+
+TEST(jsonrpc_util, get_timeout)
+{
+    JsonDoc doc("{\"key\": 3600}");
+    double value = wf_impl_json_get_timeout(doc.root(), "key", 1.0);
+    ASSERT_EQ(3600.0, value);
+}
+
+TEST(jsonrpc_util, get_timeout_default_if_missing_or_negative)
+{
+    JsonDoc doc("{\"negative\": -1, \"string\": \"42\"}");
+    ASSERT_EQ(1.0, wf_impl_json_get_timeout(doc.root(), "missing", 1.0));
+    ASSERT_EQ(1.0, wf_impl_json_get_timeout(doc.root(), "negative", 1.0));
+    ASSERT_EQ(1.0, wf_impl_json_get_timeout(doc.root(), "string", 1.0));
+}